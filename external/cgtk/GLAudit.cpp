@@ -0,0 +1,503 @@
+//! @file    GLAudit.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for GLAudit.h
+//!
+
+// The real OpenGL 1.1 functions are needed here
+#define CGTK_GL_AUDIT_IMPLEMENTATION
+#include "GLAudit.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+#include <iomanip>
+#include <map>
+#include <utility>
+#include <vector>
+
+// The calling convention of the GL entry points, which glew.h does not
+// keep defined
+#if defined(_WIN32) && !defined(_WIN64)
+#define AUDIT_APIENTRY __stdcall
+#else
+#define AUDIT_APIENTRY
+#endif
+
+// The entry points loaded by GLEW that the programs call
+#define CGTK_GLEW_FUNCTIONS(X)                                                         \
+    X(ActiveTexture) X(AttachShader) X(BeginQuery) X(BindAttribLocation)               \
+    X(BindBuffer) X(BindFramebuffer) X(BindRenderbuffer) X(BindVertexArray)            \
+    X(BufferData) X(BufferSubData) X(CheckFramebufferStatus) X(ClearBufferfv)          \
+    X(ClientWaitSync) X(CompileShader) X(CreateProgram) X(CreateShader)                \
+    X(DeleteBuffers) X(DeleteFramebuffers) X(DeleteProgram) X(DeleteQueries)           \
+    X(DeleteRenderbuffers) X(DeleteShader) X(DeleteSync) X(DeleteVertexArrays)         \
+    X(DrawElementsInstanced) X(EnableVertexAttribArray) X(EndQuery) X(FenceSync)       \
+    X(FramebufferRenderbuffer) X(FramebufferTexture2D) X(GenBuffers)                   \
+    X(GenFramebuffers) X(GenQueries) X(GenRenderbuffers) X(GenVertexArrays)            \
+    X(GetAttribLocation) X(GetProgramInfoLog) X(GetProgramiv) X(GetQueryObjectiv)      \
+    X(GetQueryObjectui64v) X(GetShaderInfoLog) X(GetShaderiv) X(GetStringi)            \
+    X(GetSynciv) X(GetUniformLocation) X(IsProgram) X(IsShader) X(LinkProgram)         \
+    X(MapBufferRange) X(QueryCounter) X(RenderbufferStorage) X(ShaderSource)           \
+    X(Uniform1f) X(Uniform1i) X(Uniform2fv) X(Uniform2iv) X(Uniform3fv)                \
+    X(Uniform3iv) X(Uniform4fv) X(Uniform4iv) X(UniformMatrix2fv)                      \
+    X(UniformMatrix3fv) X(UniformMatrix4fv) X(UnmapBuffer) X(UseProgram)               \
+    X(ValidateProgram) X(VertexAttribPointer)
+
+#ifdef CGTK_GL_AUDIT
+namespace cgtk {
+namespace gl {
+#define CGTK_GL11_POINTER(name) decltype(&::gl##name) name = ::gl##name;
+CGTK_GL11_FUNCTIONS(CGTK_GL11_POINTER)
+#undef CGTK_GL11_POINTER
+}
+}
+#endif
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+enum Entry {
+#define ENTRY(name) ENTRY_##name,
+    CGTK_GL11_FUNCTIONS(ENTRY)
+    CGTK_GLEW_FUNCTIONS(ENTRY)
+#undef ENTRY
+    NUM_ENTRIES
+};
+
+const char *ENTRY_NAMES[NUM_ENTRIES] = {
+#define ENTRY_NAME(name) "gl" #name,
+    CGTK_GL11_FUNCTIONS(ENTRY_NAME)
+    CGTK_GLEW_FUNCTIONS(ENTRY_NAME)
+#undef ENTRY_NAME
+};
+
+// The pieces of state whose changes are checked, each with a key, e.g.,
+// the capability of glEnable
+enum StateSlot {
+    STATE_CAPABILITY,
+    STATE_BLEND_FUNC,
+    STATE_CLEAR_COLOR,
+    STATE_CLEAR_STENCIL,
+    STATE_CULL_FACE,
+    STATE_STENCIL_FUNC,
+    STATE_STENCIL_OP,
+    STATE_VIEWPORT,
+    STATE_PIXEL_STORE,
+    STATE_ACTIVE_TEXTURE,
+    STATE_TEXTURE,
+    STATE_BUFFER,
+    STATE_FRAMEBUFFER,
+    STATE_RENDERBUFFER,
+    STATE_VERTEX_ARRAY,
+    STATE_PROGRAM
+};
+
+bool gInstalled = false;
+bool gSync[NUM_ENTRIES];
+
+// The calls since the frame began, or since the last frame ended
+int gCalls[NUM_ENTRIES];
+int gSyncCalls[NUM_ENTRIES];
+int gRedundantCalls[NUM_ENTRIES];
+
+// Totals over the frames, and of the calls outside of frames
+int gNumFrames = 0;
+double gTotalCalls[NUM_ENTRIES];
+double gTotalSyncCalls[NUM_ENTRIES];
+double gTotalRedundantCalls[NUM_ENTRIES];
+double gOutsideCalls = 0.0;
+
+// Summary of the last frame, and its flagged calls as (entry, sync,
+// redundant) for comparing with the next frame
+int gLastCalls = 0;
+int gLastSyncCalls = 0;
+int gLastRedundantCalls = 0;
+std::vector<int> gLastFlagged;
+
+// The state set through the wrappers since it was last invalidated
+std::map<std::pair<int, GLenum>, std::vector<double> > gState;
+GLint gActiveTexture = -1;
+
+// The pixel pack buffer is never changed by the tweakbar, so it is
+// known from the creation of the context on, which installs the audit
+GLuint gPackBuffer = 0;
+
+void countCall(int entry)
+{
+    gCalls[entry]++;
+    if (gSync[entry]) {
+        gSyncCalls[entry]++;
+    }
+}
+
+// Records a change of state, which is redundant if the state is known
+// to have the same value already
+void setState(int entry, StateSlot slot, GLenum key, std::initializer_list<double> value)
+{
+    std::vector<double> &state = gState[std::make_pair(int(slot), key)];
+    if (!state.empty() && std::equal(value.begin(), value.end(), state.begin())) {
+        gRedundantCalls[entry]++;
+    }
+    state.assign(value.begin(), value.end());
+}
+
+void invalidateState()
+{
+    gState.clear();
+    gActiveTexture = -1;
+}
+
+// Checks the arguments of a call before it is forwarded. Most entry
+// points need nothing.
+template <int ENTRY>
+struct Check {
+    template <typename... Args>
+    static void before(Args...)
+    {
+    }
+};
+
+template <>
+struct Check<ENTRY_Enable> {
+    static void before(GLenum cap) { setState(ENTRY_Enable, STATE_CAPABILITY, cap, { 1.0 }); }
+};
+
+template <>
+struct Check<ENTRY_Disable> {
+    static void before(GLenum cap) { setState(ENTRY_Disable, STATE_CAPABILITY, cap, { 0.0 }); }
+};
+
+template <>
+struct Check<ENTRY_BlendFunc> {
+    static void before(GLenum s, GLenum d) { setState(ENTRY_BlendFunc, STATE_BLEND_FUNC, 0, { double(s), double(d) }); }
+};
+
+template <>
+struct Check<ENTRY_ClearColor> {
+    static void before(GLfloat r, GLfloat g, GLfloat b, GLfloat a) { setState(ENTRY_ClearColor, STATE_CLEAR_COLOR, 0, { r, g, b, a }); }
+};
+
+template <>
+struct Check<ENTRY_ClearStencil> {
+    static void before(GLint s) { setState(ENTRY_ClearStencil, STATE_CLEAR_STENCIL, 0, { double(s) }); }
+};
+
+template <>
+struct Check<ENTRY_CullFace> {
+    static void before(GLenum mode) { setState(ENTRY_CullFace, STATE_CULL_FACE, 0, { double(mode) }); }
+};
+
+template <>
+struct Check<ENTRY_StencilFunc> {
+    static void before(GLenum func, GLint ref, GLuint mask) { setState(ENTRY_StencilFunc, STATE_STENCIL_FUNC, 0, { double(func), double(ref), double(mask) }); }
+};
+
+template <>
+struct Check<ENTRY_StencilOp> {
+    static void before(GLenum sfail, GLenum dpfail, GLenum dppass) { setState(ENTRY_StencilOp, STATE_STENCIL_OP, 0, { double(sfail), double(dpfail), double(dppass) }); }
+};
+
+template <>
+struct Check<ENTRY_Viewport> {
+    static void before(GLint x, GLint y, GLsizei w, GLsizei h) { setState(ENTRY_Viewport, STATE_VIEWPORT, 0, { double(x), double(y), double(w), double(h) }); }
+};
+
+template <>
+struct Check<ENTRY_PixelStorei> {
+    static void before(GLenum pname, GLint param) { setState(ENTRY_PixelStorei, STATE_PIXEL_STORE, pname, { double(param) }); }
+};
+
+template <>
+struct Check<ENTRY_ActiveTexture> {
+    static void before(GLenum texture)
+    {
+        setState(ENTRY_ActiveTexture, STATE_ACTIVE_TEXTURE, 0, { double(texture) });
+        gActiveTexture = texture;
+    }
+};
+
+// The bindings of the texture units are only known with the unit,
+// which goes in the high bits of the key (the targets fit in 16 bits)
+template <>
+struct Check<ENTRY_BindTexture> {
+    static void before(GLenum target, GLuint texture)
+    {
+        if (gActiveTexture >= 0) {
+            GLenum key = (GLenum(gActiveTexture - GL_TEXTURE0) << 16) | target;
+            setState(ENTRY_BindTexture, STATE_TEXTURE, key, { double(texture) });
+        }
+    }
+};
+
+// The element array buffer belongs to the vertex array, so only the
+// other targets are checked
+template <>
+struct Check<ENTRY_BindBuffer> {
+    static void before(GLenum target, GLuint buffer)
+    {
+        if (target != GL_ELEMENT_ARRAY_BUFFER) {
+            setState(ENTRY_BindBuffer, STATE_BUFFER, target, { double(buffer) });
+        }
+        if (target == GL_PIXEL_PACK_BUFFER) {
+            gPackBuffer = buffer;
+        }
+    }
+};
+
+// GL_FRAMEBUFFER binds both the draw and read framebuffer
+template <>
+struct Check<ENTRY_BindFramebuffer> {
+    static void before(GLenum target, GLuint framebuffer)
+    {
+        if (target == GL_FRAMEBUFFER) {
+            setState(ENTRY_BindFramebuffer, STATE_FRAMEBUFFER, target, { double(framebuffer) });
+        }
+        else {
+            gState.erase(std::make_pair(int(STATE_FRAMEBUFFER), GLenum(GL_FRAMEBUFFER)));
+        }
+    }
+};
+
+template <>
+struct Check<ENTRY_BindRenderbuffer> {
+    static void before(GLenum target, GLuint renderbuffer) { setState(ENTRY_BindRenderbuffer, STATE_RENDERBUFFER, target, { double(renderbuffer) }); }
+};
+
+template <>
+struct Check<ENTRY_BindVertexArray> {
+    static void before(GLuint array) { setState(ENTRY_BindVertexArray, STATE_VERTEX_ARRAY, 0, { double(array) }); }
+};
+
+template <>
+struct Check<ENTRY_UseProgram> {
+    static void before(GLuint program) { setState(ENTRY_UseProgram, STATE_PROGRAM, 0, { double(program) }); }
+};
+
+// Reading into client memory waits for the frame to be drawn
+template <>
+struct Check<ENTRY_ReadPixels> {
+    template <typename... Args>
+    static void before(Args...)
+    {
+        if (gPackBuffer == 0) {
+            gSyncCalls[ENTRY_ReadPixels]++;
+        }
+    }
+};
+
+// Deleting a bound object resets its binding, so the state is forgotten
+template <>
+struct Check<ENTRY_DeleteBuffers> {
+    static void before(GLsizei n, const GLuint *buffers)
+    {
+        if (std::find(buffers, buffers + n, gPackBuffer) != buffers + n) {
+            gPackBuffer = 0;
+        }
+        invalidateState();
+    }
+};
+
+#define INVALIDATE_ON(name)                                     \
+    template <>                                                 \
+    struct Check<ENTRY_##name> {                                \
+        template <typename... Args>                             \
+        static void before(Args...) { invalidateState(); }      \
+    };
+INVALIDATE_ON(DeleteTextures)
+INVALIDATE_ON(DeleteFramebuffers)
+INVALIDATE_ON(DeleteRenderbuffers)
+INVALIDATE_ON(DeleteVertexArrays)
+INVALIDATE_ON(DeleteProgram)
+#undef INVALIDATE_ON
+
+// The wrapper of an entry point, which counts and checks each call
+// before forwarding it to the original function
+template <int ENTRY, typename F>
+struct Hook;
+
+template <int ENTRY, typename R, typename... Args>
+struct Hook<ENTRY, R (AUDIT_APIENTRY *)(Args...)> {
+    static R (AUDIT_APIENTRY *original)(Args...);
+
+    static R AUDIT_APIENTRY call(Args... args)
+    {
+        countCall(ENTRY);
+        Check<ENTRY>::before(args...);
+        return original(args...);
+    }
+};
+
+template <int ENTRY, typename R, typename... Args>
+R (AUDIT_APIENTRY *Hook<ENTRY, R (AUDIT_APIENTRY *)(Args...)>::original)(Args...) = 0;
+
+// Entry points of extensions that are not supported stay NULL, and
+// those hooked before are kept
+template <int ENTRY, typename F>
+void hook(F &pointer)
+{
+    if (pointer && pointer != &Hook<ENTRY, F>::call) {
+        Hook<ENTRY, F>::original = pointer;
+        pointer = &Hook<ENTRY, F>::call;
+    }
+}
+
+void addCalls(double *totals, const int *calls)
+{
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        totals[i] += calls[i];
+    }
+}
+
+// Writes the calls of a kind of the last frame, e.g., "sync:
+// glGetIntegerv 2, glReadPixels 1"
+void printFlagged(std::ostream &out, const char *kind, const int *calls)
+{
+    out << ", " << kind << ":";
+    bool none = true;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        if (calls[i] > 0) {
+            out << (none ? " " : ", ") << ENTRY_NAMES[i] << " " << calls[i];
+            none = false;
+        }
+    }
+    if (none) {
+        out << " none";
+    }
+}
+}
+
+namespace cgtk {
+void GLAudit::install()
+{
+    gInstalled = true;
+    invalidateState();
+    gPackBuffer = 0;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        const char *name = ENTRY_NAMES[i];
+        gSync[i] = std::strncmp(name, "glGet", 5) == 0 || std::strcmp(name, "glFinish") == 0 ||
+                   std::strcmp(name, "glClientWaitSync") == 0 ||
+                   std::strcmp(name, "glCheckFramebufferStatus") == 0;
+    }
+#ifdef CGTK_GL_AUDIT
+#define HOOK_GL11(name) hook<ENTRY_##name>(gl::name);
+    CGTK_GL11_FUNCTIONS(HOOK_GL11)
+#undef HOOK_GL11
+#endif
+    // gl##name expands to the function pointer variable of GLEW
+#define HOOK_GLEW(name) hook<ENTRY_##name>(gl##name);
+    CGTK_GLEW_FUNCTIONS(HOOK_GLEW)
+#undef HOOK_GLEW
+}
+
+bool GLAudit::isInstalled()
+{
+    return gInstalled;
+}
+
+void GLAudit::beginFrame()
+{
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        gOutsideCalls += gCalls[i];
+        gCalls[i] = 0;
+        gSyncCalls[i] = 0;
+        gRedundantCalls[i] = 0;
+    }
+}
+
+void GLAudit::endFrame(std::ostream *log)
+{
+    if (!gInstalled) {
+        return;
+    }
+    gNumFrames++;
+    addCalls(gTotalCalls, gCalls);
+    addCalls(gTotalSyncCalls, gSyncCalls);
+    addCalls(gTotalRedundantCalls, gRedundantCalls);
+
+    std::vector<int> flagged;
+    gLastCalls = 0;
+    gLastSyncCalls = 0;
+    gLastRedundantCalls = 0;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        gLastCalls += gCalls[i];
+        gLastSyncCalls += gSyncCalls[i];
+        gLastRedundantCalls += gRedundantCalls[i];
+        if (gSyncCalls[i] > 0 || gRedundantCalls[i] > 0) {
+            flagged.push_back(i);
+            flagged.push_back(gSyncCalls[i]);
+            flagged.push_back(gRedundantCalls[i]);
+        }
+    }
+    if (log && flagged != gLastFlagged) {
+        *log << "GL audit, frame " << gNumFrames << ": " << gLastCalls << " calls";
+        printFlagged(*log, "sync", gSyncCalls);
+        printFlagged(*log, "redundant", gRedundantCalls);
+        *log << std::endl;
+    }
+    gLastFlagged.swap(flagged);
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        gCalls[i] = 0;
+        gSyncCalls[i] = 0;
+        gRedundantCalls[i] = 0;
+    }
+}
+
+void GLAudit::invalidate()
+{
+    invalidateState();
+}
+
+int GLAudit::getNumCalls()
+{
+    return gLastCalls;
+}
+
+int GLAudit::getNumSyncCalls()
+{
+    return gLastSyncCalls;
+}
+
+int GLAudit::getNumRedundantCalls()
+{
+    return gLastRedundantCalls;
+}
+
+void GLAudit::report(std::ostream &out)
+{
+    if (!gInstalled || gNumFrames == 0) {
+        return;
+    }
+    std::vector<std::pair<double, int> > entries;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        if (gTotalCalls[i] > 0.0) {
+            entries.push_back(std::make_pair(-gTotalCalls[i], i));
+        }
+    }
+    std::sort(entries.begin(), entries.end());
+
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+    out << "GL calls per frame over " << gNumFrames << " frames (" << gOutsideCalls
+        << " calls outside of frames):" << std::endl;
+#ifndef CGTK_GL_AUDIT
+    out << "  (OpenGL 1.1 functions such as glGetIntegerv and glReadPixels are only" << std::endl
+        << "  counted in audit builds, see the GL_AUDIT option of CMake)" << std::endl;
+#endif
+    for (size_t i = 0; i < entries.size(); i++) {
+        int entry = entries[i].second;
+        out << "  " << std::left << std::setw(28) << ENTRY_NAMES[entry] << std::right
+            << std::setw(10) << gTotalCalls[entry] / gNumFrames;
+        if (gTotalSyncCalls[entry] > 0.0) {
+            out << ", " << gTotalSyncCalls[entry] / gNumFrames << " sync";
+        }
+        if (gTotalRedundantCalls[entry] > 0.0) {
+            out << ", " << gTotalRedundantCalls[entry] / gNumFrames << " redundant";
+        }
+        out << std::endl;
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+}
@@ -0,0 +1,139 @@
+//! @file    GLAudit.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the GLAudit class
+//!
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <ostream>
+
+// The OpenGL 1.1 functions the programs call. GLEW does not load these
+// through pointers, so in audit builds (CGTK_GL_AUDIT defined, e.g., by
+// the GL_AUDIT option of CMake, which also includes this header first in
+// every source) the macros at the end of this file route them through
+// the pointers of cgtk::gl, which the audit can replace like those of
+// GLEW. Other builds call them directly, and the audit does not see them.
+#define CGTK_GL11_FUNCTIONS(X)                                          \
+    X(BindTexture) X(BlendFunc) X(Clear) X(ClearColor) X(ClearStencil)  \
+    X(CullFace) X(DeleteTextures) X(Disable) X(DrawArrays)              \
+    X(DrawElements) X(Enable) X(Finish) X(Flush) X(GenTextures)         \
+    X(GetError) X(GetIntegerv) X(GetString) X(PixelStorei)              \
+    X(ReadPixels) X(StencilFunc) X(StencilOp) X(TexImage2D)             \
+    X(TexParameteri) X(TexSubImage2D) X(Viewport)
+
+namespace cgtk {
+#ifdef CGTK_GL_AUDIT
+namespace gl {
+#define CGTK_GL11_POINTER(name) extern decltype(&::gl##name) name;
+CGTK_GL11_FUNCTIONS(CGTK_GL11_POINTER)
+#undef CGTK_GL11_POINTER
+}
+#endif
+
+//! @class GLAudit GLAudit.h GLAudit.h
+//!
+//! @brief Counts the OpenGL calls of each frame by entry point and
+//! flags those that stall or change nothing.
+//!
+//! install() replaces the GLEW function pointers of the entry points
+//! the programs use, and in audit builds the OpenGL 1.1 pointers of
+//! cgtk::gl, with wrappers that count each call before forwarding it. Calls are
+//! flagged as sync when they may wait for the driver or the GPU: every
+//! glGet*, glReadPixels without a pixel pack buffer, glFinish,
+//! glClientWaitSync and glCheckFramebufferStatus. State changes that
+//! set the value the state already has (e.g., binding the bound
+//! program, or enabling an enabled capability) are flagged as
+//! redundant. The state is only known after it was set through the
+//! wrappers, and invalidate() forgets it after code that changes it
+//! behind their back, such as AntTweakBar.
+//!
+//! All calls must come from the thread that owns the context. Without
+//! install() nothing is counted.
+//!
+class GLAudit {
+public:
+    //! Replace the function pointers with the wrappers. Call after
+    //! every glewInit(), which loads the GLEW pointers again, and
+    //! before the new context is used.
+    //!
+    static void install();
+
+    //! Check whether the wrappers are installed.
+    //!
+    //! @return true if install() was called, otherwise false.
+    //!
+    static bool isInstalled();
+
+    //! Start counting the calls of a frame. Earlier calls count as
+    //! outside of frames.
+    //!
+    static void beginFrame();
+
+    //! End the frame and add its calls to the totals.
+    //!
+    //! @param[in] log Stream for a summary of the frame, written when its
+    //! sync or redundant calls differ from those of the previous frame,
+    //! or NULL.
+    //!
+    static void endFrame(std::ostream *log);
+
+    //! Forget the known state, e.g., after drawing the tweakbar.
+    //!
+    static void invalidate();
+
+    //! Get the number of calls of the last frame.
+    //!
+    //! @return The number of calls.
+    //!
+    static int getNumCalls();
+
+    //! Get the number of sync calls of the last frame.
+    //!
+    //! @return The number of calls.
+    //!
+    static int getNumSyncCalls();
+
+    //! Get the number of redundant calls of the last frame.
+    //!
+    //! @return The number of calls.
+    //!
+    static int getNumRedundantCalls();
+
+    //! Print the calls per frame of each entry point.
+    //!
+    //! @param[in] out Stream to write to.
+    //!
+    static void report(std::ostream &out);
+};
+}
+
+#if defined(CGTK_GL_AUDIT) && !defined(CGTK_GL_AUDIT_IMPLEMENTATION)
+#define glBindTexture cgtk::gl::BindTexture
+#define glBlendFunc cgtk::gl::BlendFunc
+#define glClear cgtk::gl::Clear
+#define glClearColor cgtk::gl::ClearColor
+#define glClearStencil cgtk::gl::ClearStencil
+#define glCullFace cgtk::gl::CullFace
+#define glDeleteTextures cgtk::gl::DeleteTextures
+#define glDisable cgtk::gl::Disable
+#define glDrawArrays cgtk::gl::DrawArrays
+#define glDrawElements cgtk::gl::DrawElements
+#define glEnable cgtk::gl::Enable
+#define glFinish cgtk::gl::Finish
+#define glFlush cgtk::gl::Flush
+#define glGenTextures cgtk::gl::GenTextures
+#define glGetError cgtk::gl::GetError
+#define glGetIntegerv cgtk::gl::GetIntegerv
+#define glGetString cgtk::gl::GetString
+#define glPixelStorei cgtk::gl::PixelStorei
+#define glReadPixels cgtk::gl::ReadPixels
+#define glStencilFunc cgtk::gl::StencilFunc
+#define glStencilOp cgtk::gl::StencilOp
+#define glTexImage2D cgtk::gl::TexImage2D
+#define glTexParameteri cgtk::gl::TexParameteri
+#define glTexSubImage2D cgtk::gl::TexSubImage2D
+#define glViewport cgtk::gl::Viewport
+#endif
@@ -6,11 +6,14 @@
 //!
 
 #include "GLSLProgram.h"
+#include "Trace.h"
+#include "MemoryRegistry.h"
 
 #include <GL/glew.h>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <stdio.h>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -18,6 +21,20 @@
 // Unnamed namespace (for helper functions and constants)
 //
 namespace {  
+const char *shaderTypeName(GLenum type)
+{
+    switch (type) {
+    case GL_VERTEX_SHADER:
+        return "vertex";
+    case GL_GEOMETRY_SHADER:
+        return "geometry";
+    case GL_FRAGMENT_SHADER:
+        return "fragment";
+    default:
+        return "unknown";
+    }
+}
+
 void showShaderInfoLog(GLuint shader)
 {
     if (!glIsShader(shader)) {
@@ -30,11 +47,24 @@ void showShaderInfoLog(GLuint shader)
     if (infoLogLength > 1) {
         char* infoLog = (char*)malloc(infoLogLength * sizeof(char));
         glGetShaderInfoLog(shader, infoLogLength, NULL, infoLog);
-        std::cerr << "Error compiling shader:\n" << infoLog << std::endl;
+        GLint type = 0;
+        glGetShaderiv(shader, GL_SHADER_TYPE, &type);
+        std::cerr << "Error compiling " << shaderTypeName(type) << " shader:\n" << infoLog << std::endl;
         free(infoLog);
     }
 }
 
+// The size of a linked program, which is only known where the driver
+// can return it as a binary
+size_t programBinaryLength(GLuint program)
+{
+    GLint length = 0;
+    if (GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary) {
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    }
+    return size_t(std::max(length, 0));
+}
+
 GLuint createShader(GLenum type, const char* shader_source)
 {
     // Create shader object
@@ -126,10 +156,10 @@ namespace cgtk {
 GLSLProgram::GLSLProgram() :
     mShaderSources(),
     mAttributeLocations(),
+    mName("program"),
     mValid(false),
     mProgram(0)
 {
-    std::cout << "Called GLSLProgram constructor" << std::endl;
 }
 
 GLSLProgram::~GLSLProgram()
@@ -137,6 +167,7 @@ GLSLProgram::~GLSLProgram()
     if (mProgram) {
         glDeleteProgram(mProgram);
     }
+    MemoryRegistry::release(this);
 }
 
 void GLSLProgram::setShaderSource(const GLenum type, const std::string &source)
@@ -151,6 +182,11 @@ void GLSLProgram::setAttributeLocation(const std::string &name, const int32_t lo
     mValid = false;
 }
 
+void GLSLProgram::setName(const std::string &name)
+{
+    mName = name;
+}
+
 int32_t GLSLProgram::getAttributeLocation(const std::string &name)
 {
     int32_t location = -1;
@@ -167,9 +203,12 @@ int32_t GLSLProgram::getAttributeLocation(const std::string &name)
 
 bool GLSLProgram::update()
 {
+    CGTK_TRACE_SCOPE("GLSLProgram::update");
+
     // Create program object
     if (mProgram) {
         glDeleteProgram(mProgram);
+        MemoryRegistry::release(this);
     }
     mProgram = glCreateProgram();
     if (!mProgram) {
@@ -180,6 +219,7 @@ bool GLSLProgram::update()
     for (auto it = mShaderSources.begin(); it != mShaderSources.end(); ++it) {
         GLenum type = it->first;
         const std::string &source = it->second;
+        CGTK_TRACE_SCOPE("compile shader");
         uint32_t shader = createShader(type, source.c_str());
         if (!(shader > 0)) {
             return false;
@@ -196,11 +236,13 @@ bool GLSLProgram::update()
     }
 
     // Link the program
+    CGTK_TRACE_SCOPE("link program");
     if (!linkProgram(mProgram)) {
         return false;
     }
 
     mValid = true;
+    MemoryRegistry::set(this, MEMORY_PROGRAM, mName, programBinaryLength(mProgram));
 
     return true;
 }
@@ -30,7 +30,8 @@ public:
     //! until update() is called.
     //!
     //! @param[in] type
-    //!   Shader type, for instance, GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
+    //!   Shader type, for instance, GL_VERTEX_SHADER, GL_GEOMETRY_SHADER
+    //!   or GL_FRAGMENT_SHADER.
     //! @param[in] source
     //!   Shader source string.
     //!
@@ -57,6 +58,14 @@ public:
     //!
     int32_t getAttributeLocation(const std::string &name);
 
+    //! Set the name the program is accounted under in the
+    //! MemoryRegistry.
+    //!
+    //! @param[in] name
+    //!   Name of the program, for instance, "mesh".
+    //!
+    void setName(const std::string &name);
+
     //! Update the program. This method needs to be called at least once
     //! in order to create the program.
     //!
@@ -219,6 +228,7 @@ private:
 
     std::map<GLenum, std::string> mShaderSources;
     std::map<std::string, int32_t> mAttributeLocations;
+    std::string mName;
     bool mValid;
     uint32_t mProgram;
 };
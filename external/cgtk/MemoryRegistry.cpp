@@ -0,0 +1,237 @@
+//! @file    MemoryRegistry.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for MemoryRegistry.h
+//!
+
+#include "MemoryRegistry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <utility>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+const char *CATEGORY_NAMES[cgtk::NUM_MEMORY_CATEGORIES] = {
+    "mesh", "buffer", "texture", "renderbuffer", "program"
+};
+
+// Bytes held now, and the most ever held
+struct Sum {
+    size_t bytes;
+    size_t peak;
+};
+
+// Bytes set by an owner in a category
+struct Holding {
+    std::string asset;
+    size_t bytes;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::map<std::pair<const void *, int>, Holding> holdings;
+    std::map<std::pair<std::string, int>, Sum> assets;
+    Sum categories[cgtk::NUM_MEMORY_CATEGORIES];
+    Sum totals[2];  // CPU and GPU
+    cgtk::DriverMemory driverMemory;
+    bool hasDriverMemory;
+
+    // Incremented on every change, read without the mutex
+    std::atomic<unsigned> generation;
+};
+
+// The registry is never destroyed, so that owners destroyed at exit,
+// e.g., global objects of other files, can still release their bytes
+Registry &registry()
+{
+    static Registry *r = new Registry();
+    return *r;
+}
+
+void add(Sum *sum, size_t bytes)
+{
+    sum->bytes += bytes;
+    sum->peak = std::max(sum->peak, sum->bytes);
+}
+
+// Adds the bytes of a holding to its sums, or subtracts them. Called
+// with the mutex held.
+void account(Registry &r, const Holding &holding, int category, bool subtract)
+{
+    Sum *sums[] = {
+        &r.assets[std::make_pair(holding.asset, category)],
+        &r.categories[category],
+        &r.totals[cgtk::MemoryRegistry::isGpu(cgtk::MemoryCategory(category)) ? 1 : 0]
+    };
+    for (int i = 0; i < 3; i++) {
+        if (subtract) {
+            sums[i]->bytes -= holding.bytes;
+        }
+        else {
+            add(sums[i], holding.bytes);
+        }
+    }
+}
+
+void writeString(std::ostream &out, const std::string &s)
+{
+    out << '"';
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"' || s[i] == '\\') {
+            out << '\\';
+        }
+        out << s[i];
+    }
+    out << '"';
+}
+
+void writeSum(std::ostream &out, const Sum &sum)
+{
+    out << "{\"bytes\": " << sum.bytes << ", \"peak_bytes\": " << sum.peak << "}";
+}
+
+// Writes a size of the driver, which is null where it does not tell
+void writeDriverBytes(std::ostream &out, double bytes)
+{
+    if (bytes < 0.0) {
+        out << "null";
+    }
+    else {
+        out << (long long)(bytes);
+    }
+}
+}
+
+namespace cgtk {
+void MemoryRegistry::set(const void *owner, MemoryCategory category,
+                         const std::string &asset, size_t bytes)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto key = std::make_pair(owner, int(category));
+    auto it = r.holdings.find(key);
+    if (it != r.holdings.end()) {
+        if (it->second.bytes == bytes && it->second.asset == asset) {
+            return;
+        }
+        account(r, it->second, category, true);
+        r.holdings.erase(it);
+    }
+    Holding holding = { asset, bytes };
+    account(r, holding, category, false);
+    if (bytes > 0) {
+        r.holdings[key] = holding;
+    }
+    r.generation++;
+}
+
+void MemoryRegistry::release(const void *owner)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.holdings.lower_bound(std::make_pair(owner, 0));
+    while (it != r.holdings.end() && it->first.first == owner) {
+        account(r, it->second, it->first.second, true);
+        it = r.holdings.erase(it);
+    }
+    r.generation++;
+}
+
+size_t MemoryRegistry::getBytes(MemoryCategory category, bool peak)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return peak ? r.categories[category].peak : r.categories[category].bytes;
+}
+
+size_t MemoryRegistry::getTotalBytes(bool gpu, bool peak)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    const Sum &sum = r.totals[gpu ? 1 : 0];
+    return peak ? sum.peak : sum.bytes;
+}
+
+std::vector<MemoryUsage> MemoryRegistry::getUsages()
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<MemoryUsage> usages;
+    for (auto it = r.assets.begin(); it != r.assets.end(); ++it) {
+        MemoryUsage usage = { it->first.first, MemoryCategory(it->first.second),
+                              it->second.bytes, it->second.peak };
+        usages.push_back(usage);
+    }
+    return usages;
+}
+
+void MemoryRegistry::setDriverMemory(const DriverMemory &memory)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.driverMemory = memory;
+    r.hasDriverMemory = true;
+    r.generation++;
+}
+
+unsigned MemoryRegistry::getGeneration()
+{
+    return registry().generation.load();
+}
+
+bool MemoryRegistry::getDriverMemory(DriverMemory *memory)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    *memory = r.driverMemory;
+    return r.hasDriverMemory;
+}
+
+bool MemoryRegistry::isGpu(MemoryCategory category)
+{
+    return category != MEMORY_MESH;
+}
+
+const char *MemoryRegistry::getCategoryName(MemoryCategory category)
+{
+    return CATEGORY_NAMES[category];
+}
+
+void MemoryRegistry::writeJson(std::ostream &out)
+{
+    std::vector<MemoryUsage> usages = getUsages();
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    out << "{\n  \"cpu\": ";
+    writeSum(out, r.totals[0]);
+    out << ",\n  \"gpu\": ";
+    writeSum(out, r.totals[1]);
+    out << ",\n  \"categories\": {";
+    for (int i = 0; i < NUM_MEMORY_CATEGORIES; i++) {
+        out << (i > 0 ? ",\n" : "\n") << "    \"" << CATEGORY_NAMES[i] << "\": ";
+        writeSum(out, r.categories[i]);
+    }
+    out << "\n  },\n  \"assets\": [";
+    for (size_t i = 0; i < usages.size(); i++) {
+        out << (i > 0 ? ",\n" : "\n") << "    {\"asset\": ";
+        writeString(out, usages[i].asset);
+        out << ", \"category\": \"" << CATEGORY_NAMES[usages[i].category]
+            << "\", \"bytes\": " << usages[i].bytes << ", \"peak_bytes\": " << usages[i].peak << "}";
+    }
+    out << "\n  ],\n  \"driver\": ";
+    if (r.hasDriverMemory) {
+        out << "{\"total_bytes\": ";
+        writeDriverBytes(out, r.driverMemory.total);
+        out << ", \"available_bytes\": ";
+        writeDriverBytes(out, r.driverMemory.available);
+        out << "}";
+    }
+    else {
+        out << "null";
+    }
+    out << "\n}\n";
+}
+}
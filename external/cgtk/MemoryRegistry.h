@@ -0,0 +1,156 @@
+//! @file    MemoryRegistry.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the MemoryRegistry class
+//!
+
+#pragma once
+
+#include <stddef.h>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cgtk {
+// The kinds of memory accounted for. The first is CPU memory, the
+// others are OpenGL objects.
+enum MemoryCategory {
+    MEMORY_MESH = 0,
+    MEMORY_BUFFER,
+    MEMORY_TEXTURE,
+    MEMORY_RENDERBUFFER,
+    MEMORY_PROGRAM,
+    NUM_MEMORY_CATEGORIES
+};
+
+// Video memory reported by the driver, in bytes, or -1 where the driver
+// does not tell
+struct DriverMemory {
+    double total;      // dedicated video memory
+    double available;  // video memory currently free
+};
+
+// Bytes of one asset in one category, and their high-water mark
+struct MemoryUsage {
+    std::string asset;
+    MemoryCategory category;
+    size_t bytes;
+    size_t peak;
+};
+
+//! Get the bytes allocated by a vector, i.e., for its capacity.
+//!
+//! @param[in] v The vector.
+//! @return The number of bytes.
+//!
+template <typename T>
+size_t getMemoryBytes(const std::vector<T> &v)
+{
+    return v.capacity() * sizeof(T);
+}
+
+//! @class MemoryRegistry MemoryRegistry.h MemoryRegistry.h
+//!
+//! @brief Accounts for the memory of meshes and OpenGL objects by asset
+//! and category.
+//!
+//! Each owner, e.g., a mesh or an object wrapping textures, sets the
+//! bytes it holds in a category whenever they change, tagged with the
+//! name of its asset, e.g., "bunny", and releases them when it is
+//! destroyed. The bytes are summed per asset and category, per
+//! category and over the CPU and GPU, each with the highest value it
+//! had, so that short-lived copies, e.g., while loading a model, show up
+//! in the high-water marks. The sizes of OpenGL objects are computed
+//! from their formats and dimensions, so they leave out the padding and
+//! alignment of the driver. Where the driver reports its video memory
+//! (GL_NVX_gpu_memory_info or GL_ATI_meminfo), the caller samples it
+//! and stores it with setDriverMemory().
+//!
+//! All methods may be called from any thread.
+//!
+class MemoryRegistry {
+public:
+    //! Set the bytes an owner holds in a category, replacing the bytes
+    //! it set before. Setting the same asset and bytes again changes
+    //! nothing.
+    //!
+    //! @param[in] owner The owner, e.g., this.
+    //! @param[in] category The category.
+    //! @param[in] asset Name of the asset.
+    //! @param[in] bytes The number of bytes, or 0.
+    //!
+    static void set(const void *owner, MemoryCategory category,
+                    const std::string &asset, size_t bytes);
+
+    //! Release the bytes of an owner in every category.
+    //!
+    //! @param[in] owner The owner.
+    //!
+    static void release(const void *owner);
+
+    //! Get the bytes of a category.
+    //!
+    //! @param[in] category The category.
+    //! @param[in] peak true for the high-water mark, false for the
+    //! current bytes.
+    //! @return The number of bytes.
+    //!
+    static size_t getBytes(MemoryCategory category, bool peak = false);
+
+    //! Get the bytes of the CPU or GPU categories.
+    //!
+    //! @param[in] gpu true for the OpenGL objects, false for the CPU.
+    //! @param[in] peak true for the high-water mark, false for the
+    //! current bytes.
+    //! @return The number of bytes.
+    //!
+    static size_t getTotalBytes(bool gpu, bool peak = false);
+
+    //! Get the bytes of every asset and category held now or before.
+    //!
+    //! @return The usages sorted by asset and category.
+    //!
+    static std::vector<MemoryUsage> getUsages();
+
+    //! Store the video memory reported by the driver.
+    //!
+    //! @param[in] memory The video memory.
+    //!
+    static void setDriverMemory(const DriverMemory &memory);
+
+    //! Get the video memory stored with setDriverMemory().
+    //!
+    //! @param[out] memory The video memory.
+    //! @return false if none was stored, otherwise true.
+    //!
+    static bool getDriverMemory(DriverMemory *memory);
+
+    //! Get a number that changes whenever bytes are set or released or
+    //! the video memory is stored, so that callers can copy the memory
+    //! only after it changed. Never waits for the other methods.
+    //!
+    //! @return The generation.
+    //!
+    static unsigned getGeneration();
+
+    //! Check whether a category is CPU or GPU memory.
+    //!
+    //! @param[in] category The category.
+    //! @return true for OpenGL objects, otherwise false.
+    //!
+    static bool isGpu(MemoryCategory category);
+
+    //! Get the name of a category, e.g., "texture".
+    //!
+    //! @param[in] category The category.
+    //! @return The name.
+    //!
+    static const char *getCategoryName(MemoryCategory category);
+
+    //! Write the bytes and high-water marks as JSON.
+    //!
+    //! @param[in] out Stream to write to.
+    //!
+    static void writeJson(std::ostream &out);
+};
+}
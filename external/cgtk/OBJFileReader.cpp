@@ -6,6 +6,9 @@
 //!
 
 #include "OBJFileReader.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "MemoryRegistry.h"
 
 #include <iostream>
 #include <fstream>
@@ -18,12 +21,31 @@ namespace {
 const std::string VERTEX_LINE("v ");
   
 const std::string FACE_LINE("f ");
-  
-void computeNormals(std::vector<glm::vec3> const &vertices,
-                    std::vector<uint32_t> const &indices,
-                    std::vector<glm::vec3> &normals)
+
+// The name of the model in a file name, e.g., "bunny" in
+// "3d_models/bunny.obj"
+std::string assetName(const std::string &filename)
+{
+    size_t begin = filename.find_last_of("/\\");
+    begin = (begin == std::string::npos) ? 0 : begin + 1;
+    size_t end = filename.find_last_of('.');
+    if (end == std::string::npos || end < begin) {
+        end = filename.size();
+    }
+    return filename.substr(begin, end - begin);
+}
+}
+
+using namespace cgtk;
+
+void cgtk::computeNormals(std::vector<glm::vec3> const &vertices,
+                          std::vector<uint32_t> const &indices,
+                          std::vector<glm::vec3> &normals)
 {
-    normals.resize(vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
+    CGTK_TRACE_SCOPE("computeNormals");
+    PerfScope perf("computeNormals");
+
+    normals.assign(vertices.size(), glm::vec3(0.0f, 0.0f, 0.0f));
     
     // Compute per-vertex normals by averaging the unnormalized face normals
     uint32_t vertexIndex0, vertexIndex1, vertexIndex2;
@@ -44,25 +66,25 @@ void computeNormals(std::vector<glm::vec3> const &vertices,
     for (int i = 0; i < numNormals; i++) {
         normals[i] = glm::normalize(normals[i]);
     }
-}
+    perf.stop(vertices.size(), indices.size() / 3);
 }
 
-using namespace cgtk;
-
 OBJFileReader::OBJFileReader() :
     mVertices(0),
     mNormals(0),
     mIndices(0)
 {
-    std::cout << "Called OBJFileReader constructor" << std::endl;
 }
 
 OBJFileReader::~OBJFileReader()
 {
+    MemoryRegistry::release(this);
 }
 
 bool OBJFileReader::load(const char *filename)
 {
+    CGTK_TRACE_SCOPE("OBJFileReader::load");
+
     // Open OBJ file
     std::ifstream OBJFile(filename);
     if (!OBJFile.is_open()) {
@@ -71,6 +93,7 @@ bool OBJFileReader::load(const char *filename)
     }
   
     // Extract vertices and indices
+    PerfScope perf("OBJ parse");
     std::string line;
     glm::vec3 vertex;
     uint32_t vertexIndex0, vertexIndex1, vertexIndex2;
@@ -99,9 +122,12 @@ bool OBJFileReader::load(const char *filename)
   
     // Close OBJ file
     OBJFile.close();
+    perf.stop(mVertices.size(), mIndices.size() / 3);
   
     // Compute normals
     computeNormals(mVertices, mIndices, mNormals);
+    MemoryRegistry::set(this, MEMORY_MESH, assetName(filename),
+                        getMemoryBytes(mVertices) + getMemoryBytes(mNormals) + getMemoryBytes(mIndices));
 
     // Display log message
     std::cout << "Loaded OBJ file " << filename << std::endl;
@@ -13,6 +13,17 @@
 #include <vector>
 
 namespace cgtk {
+//! Compute per-vertex normals by averaging the unnormalized face
+//! normals, i.e., weighted by the areas of the faces.
+//!
+//! @param[in] vertices The vertices of the mesh.
+//! @param[in] indices The triangle indices of the mesh.
+//! @param[out] normals The unit normal of each vertex.
+//!
+void computeNormals(std::vector<glm::vec3> const &vertices,
+                    std::vector<uint32_t> const &indices,
+                    std::vector<glm::vec3> &normals);
+
 //! @class OBJFileReader OBJFileReader.h OBJFileReader.h
 //!
 //! @brief OBJ file reader class
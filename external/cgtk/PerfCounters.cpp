@@ -0,0 +1,289 @@
+//! @file    PerfCounters.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for PerfCounters.h
+//!
+
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+const char *COUNTER_NAMES[cgtk::NUM_PERF_COUNTERS] = {
+    "cycles", "instructions", "cache misses", "branch misses", "page faults"
+};
+
+// The totals of a region over all threads
+struct Region {
+    const char *name;
+    uint64_t numCalls;
+    uint64_t numVertices;
+    uint64_t numTriangles;
+    double counts[cgtk::NUM_PERF_COUNTERS];
+    bool available[cgtk::NUM_PERF_COUNTERS];
+};
+
+std::mutex gRegionsMutex;
+std::vector<Region> gRegions;
+
+// The counters of a thread, in one group read at once. Counters that
+// could not be opened have no place in the group.
+struct CounterGroup {
+    bool opened;
+    int leader;
+    int fds[cgtk::NUM_PERF_COUNTERS];
+    int positions[cgtk::NUM_PERF_COUNTERS];
+    int numOpen;
+
+    CounterGroup()
+    {
+        opened = false;
+        leader = -1;
+        numOpen = 0;
+        for (int i = 0; i < cgtk::NUM_PERF_COUNTERS; i++) {
+            fds[i] = -1;
+            positions[i] = -1;
+        }
+    }
+
+    ~CounterGroup()
+    {
+#ifdef __linux__
+        for (int i = 0; i < cgtk::NUM_PERF_COUNTERS; i++) {
+            if (fds[i] >= 0) {
+                close(fds[i]);
+            }
+        }
+#endif
+    }
+};
+
+thread_local CounterGroup tGroup;
+
+#ifdef __linux__
+int openCounter(int counter, int groupFd)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    switch (counter) {
+    case cgtk::PERF_CYCLES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CPU_CYCLES;
+        break;
+    case cgtk::PERF_INSTRUCTIONS:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        break;
+    case cgtk::PERF_CACHE_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        break;
+    case cgtk::PERF_BRANCH_MISSES:
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+        break;
+    default:
+        attr.type = PERF_TYPE_SOFTWARE;
+        attr.config = PERF_COUNT_SW_PAGE_FAULTS;
+        break;
+    }
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // Counts the calling thread on any CPU
+    return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+#endif
+
+// Opens the counters of the calling thread once, the first that opens
+// leading the group
+CounterGroup &threadGroup()
+{
+    CounterGroup &group = tGroup;
+    if (group.opened) {
+        return group;
+    }
+    group.opened = true;
+#ifdef __linux__
+    for (int i = 0; i < cgtk::NUM_PERF_COUNTERS; i++) {
+        int fd = openCounter(i, group.leader);
+        if (fd < 0) {
+            continue;
+        }
+        if (group.leader < 0) {
+            group.leader = fd;
+        }
+        group.fds[i] = fd;
+        group.positions[i] = group.numOpen++;
+    }
+#endif
+    return group;
+}
+
+Region &findRegion(const char *name)
+{
+    for (size_t i = 0; i < gRegions.size(); i++) {
+        if (gRegions[i].name == name || std::strcmp(gRegions[i].name, name) == 0) {
+            return gRegions[i];
+        }
+    }
+    Region region;
+    region.name = name;
+    region.numCalls = 0;
+    region.numVertices = 0;
+    region.numTriangles = 0;
+    for (int i = 0; i < cgtk::NUM_PERF_COUNTERS; i++) {
+        region.counts[i] = 0.0;
+        region.available[i] = false;
+    }
+    gRegions.push_back(region);
+    return gRegions.back();
+}
+
+// Prints the events per unit of the counters that were available
+void printPer(std::ostream &out, const Region &region, const char *unit, double count)
+{
+    out << "    per " << unit << ":";
+    const char *separator = " ";
+    for (int i = 0; i < cgtk::NUM_PERF_COUNTERS; i++) {
+        if (region.available[i]) {
+            out << separator << region.counts[i] / count << " " << COUNTER_NAMES[i];
+            separator = ", ";
+        }
+    }
+    out << std::endl;
+}
+}
+
+namespace cgtk {
+std::atomic<bool> PerfCounters::sEnabled(false);
+
+bool PerfCounters::setEnabled(bool enabled)
+{
+    if (enabled && threadGroup().leader < 0) {
+        return false;
+    }
+    sEnabled.store(enabled);
+    return true;
+}
+
+bool PerfCounters::read(PerfSample *sample)
+{
+    CounterGroup &group = threadGroup();
+    if (group.leader < 0) {
+        return false;
+    }
+#ifdef __linux__
+    // Layout of PERF_FORMAT_GROUP with both times: the number of
+    // counters, the times, then a value per counter
+    uint64_t data[3 + NUM_PERF_COUNTERS];
+    ssize_t size = (3 + group.numOpen) * sizeof(uint64_t);
+    if (::read(group.leader, data, size) != size) {
+        return false;
+    }
+    sample->timeEnabled = data[1];
+    sample->timeRunning = data[2];
+    for (int i = 0; i < NUM_PERF_COUNTERS; i++) {
+        sample->values[i] = group.positions[i] >= 0 ? data[3 + group.positions[i]] : 0;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PerfCounters::add(const char *name, const PerfSample &begin, const PerfSample &end,
+                       uint64_t numVertices, uint64_t numTriangles)
+{
+    // Counts of a group that was not on the CPU for the whole region
+    // are scaled up by the kernel's estimate
+    uint64_t enabled = end.timeEnabled - begin.timeEnabled;
+    uint64_t running = end.timeRunning - begin.timeRunning;
+    double scale = running > 0 && running < enabled ? double(enabled) / running : 1.0;
+
+    const CounterGroup &group = threadGroup();
+    std::lock_guard<std::mutex> lock(gRegionsMutex);
+    Region &region = findRegion(name);
+    region.numCalls++;
+    region.numVertices += numVertices;
+    region.numTriangles += numTriangles;
+    for (int i = 0; i < NUM_PERF_COUNTERS; i++) {
+        if (group.positions[i] >= 0) {
+            region.counts[i] += scale * (end.values[i] - begin.values[i]);
+            region.available[i] = true;
+        }
+    }
+}
+
+void PerfCounters::report(std::ostream &out)
+{
+    std::lock_guard<std::mutex> lock(gRegionsMutex);
+    if (gRegions.empty()) {
+        return;
+    }
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(2);
+    out << "CPU counters per region (user space):" << std::endl;
+    for (size_t i = 0; i < gRegions.size(); i++) {
+        const Region &region = gRegions[i];
+        out << "  " << region.name << ": " << region.numCalls << " calls";
+        if (region.available[PERF_CYCLES] && region.available[PERF_INSTRUCTIONS] &&
+            region.counts[PERF_CYCLES] > 0.0) {
+            out << ", " << region.counts[PERF_INSTRUCTIONS] / region.counts[PERF_CYCLES]
+                << " instructions per cycle";
+        }
+        const char *separator = ", not available: ";
+        for (int j = 0; j < NUM_PERF_COUNTERS; j++) {
+            if (!region.available[j]) {
+                out << separator << COUNTER_NAMES[j];
+                separator = ", ";
+            }
+        }
+        out << std::endl;
+        printPer(out, region, "call", double(region.numCalls));
+        if (region.numVertices > 0) {
+            printPer(out, region, "vertex", double(region.numVertices));
+        }
+        if (region.numTriangles > 0) {
+            printPer(out, region, "triangle", double(region.numTriangles));
+        }
+    }
+    out.flags(flags);
+    out.precision(precision);
+}
+
+PerfScope::PerfScope(const char *name) :
+    mName(PerfCounters::isEnabled() && PerfCounters::read(&mBegin) ? name : 0)
+{
+}
+
+PerfScope::~PerfScope()
+{
+    stop();
+}
+
+void PerfScope::stop(uint64_t numVertices, uint64_t numTriangles)
+{
+    if (!mName) {
+        return;
+    }
+    PerfSample end;
+    if (PerfCounters::read(&end)) {
+        PerfCounters::add(mName, mBegin, end, numVertices, numTriangles);
+    }
+    mName = 0;
+}
+}
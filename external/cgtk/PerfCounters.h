@@ -0,0 +1,130 @@
+//! @file    PerfCounters.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the PerfCounters and PerfScope classes
+//!
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <ostream>
+
+namespace cgtk {
+// The hardware and software events counted in each region
+enum PerfCounter {
+    PERF_CYCLES = 0,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_PAGE_FAULTS,
+    NUM_PERF_COUNTERS
+};
+
+// Counter values of the calling thread at one point in time
+struct PerfSample {
+    uint64_t values[NUM_PERF_COUNTERS];
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+};
+
+//! @class PerfCounters PerfCounters.h PerfCounters.h
+//!
+//! @brief Counts CPU events in named regions of code with the Linux
+//! perf_event_open interface.
+//!
+//! Each thread opens one group of counters for itself the first time it
+//! enters a region, so a region is counted on the thread that runs it
+//! and the counters are read together with one system call. Only user
+//! space events are counted, which is allowed with the default
+//! perf_event_paranoid setting. The counts are scaled up when the
+//! kernel multiplexes the counters. Counters that cannot be opened,
+//! e.g., hardware counters in a virtual machine, are reported as not
+//! available. On other systems nothing is counted.
+//!
+//! The totals of a region are kept over all threads, together with the
+//! number of vertices and triangles it processed, which gives the
+//! events per vertex and triangle.
+//!
+class PerfCounters {
+public:
+    //! Start or stop counting. Opens the counters of the calling thread
+    //! to check that they are supported.
+    //!
+    //! @param[in] enabled true to count regions.
+    //! @return false if no counter could be opened, otherwise true.
+    //!
+    static bool setEnabled(bool enabled);
+
+    //! Check whether regions are counted.
+    //!
+    //! @return true if counting, otherwise false.
+    //!
+    static bool isEnabled()
+    {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    //! Read the counters of the calling thread.
+    //!
+    //! @param[out] sample The counter values.
+    //! @return false if the counters are not open, otherwise true.
+    //!
+    static bool read(PerfSample *sample);
+
+    //! Add the events between two samples to a region.
+    //!
+    //! @param[in] name Name of the region. It must stay valid, e.g., a
+    //! string literal.
+    //! @param[in] begin Sample at the beginning of the region.
+    //! @param[in] end Sample at the end of the region.
+    //! @param[in] numVertices Number of vertices processed in the region.
+    //! @param[in] numTriangles Number of triangles processed in the
+    //! region.
+    //!
+    static void add(const char *name, const PerfSample &begin, const PerfSample &end,
+                    uint64_t numVertices, uint64_t numTriangles);
+
+    //! Print the totals of every region, their instructions per cycle
+    //! and the events per call, vertex and triangle.
+    //!
+    //! @param[in] out Stream to print to.
+    //!
+    static void report(std::ostream &out);
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+//! @class PerfScope PerfCounters.h PerfCounters.h
+//!
+//! @brief Counts a region from its construction to stop() or its
+//! destruction.
+//!
+class PerfScope {
+public:
+    //! Constructor
+    //!
+    //! @param[in] name Name of the region, e.g., a string literal.
+    //!
+    explicit PerfScope(const char *name);
+
+    //! Destructor. Stops the region if stop() was not called.
+    //!
+    ~PerfScope();
+
+    //! End the region.
+    //!
+    //! @param[in] numVertices Number of vertices processed in the region.
+    //! @param[in] numTriangles Number of triangles processed in the
+    //! region.
+    //!
+    void stop(uint64_t numVertices = 0, uint64_t numTriangles = 0);
+private:
+    // Make instances non-copyable.
+    PerfScope(const PerfScope &);
+    const PerfScope &operator=(const PerfScope &);
+
+    const char *mName;
+    PerfSample mBegin;
+};
+}
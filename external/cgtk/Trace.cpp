@@ -0,0 +1,236 @@
+//! @file    Trace.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for Trace.h
+//!
+
+#include "Trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CGTK_TRACE_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CGTK_TRACE_RDTSC
+#endif
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Number of scopes each thread keeps
+const uint64_t CAPACITY = 1 << 16;
+
+// A recorded scope. The fields are atomic so that the writer of the
+// trace may read a scope while its thread overwrites it.
+struct Event {
+    std::atomic<const char *> name;
+    std::atomic<uint64_t> begin;
+    std::atomic<uint64_t> end;
+};
+
+// The scopes of a thread. Only the thread writes to its ring; head is
+// the number of scopes it has recorded.
+struct ThreadRing {
+    int tid;
+    std::atomic<const char *> name;
+    std::atomic<uint64_t> head;
+    std::atomic<bool> free;
+    Event *events;
+};
+
+// All rings, which are never freed: a thread may still record while
+// the trace is written at exit. The ring of a thread that ended is
+// taken over by the next new thread, so threads started for every
+// job, e.g., do not add up.
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadRing *> rings;
+};
+
+Registry &registry()
+{
+    static Registry *r = new Registry;
+    return *r;
+}
+
+// Hands the ring of a thread back when the thread ends
+struct RingHandle {
+    ThreadRing *ring;
+
+    ~RingHandle()
+    {
+        if (ring) {
+            ring->free.store(true, std::memory_order_release);
+        }
+    }
+};
+
+thread_local RingHandle tRing = { 0 };
+
+ThreadRing *threadRing()
+{
+    if (!tRing.ring) {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (size_t i = 0; i < r.rings.size() && !tRing.ring; i++) {
+            if (r.rings[i]->free.load(std::memory_order_acquire)) {
+                tRing.ring = r.rings[i];
+                tRing.ring->name.store(0, std::memory_order_relaxed);
+                tRing.ring->free.store(false, std::memory_order_relaxed);
+            }
+        }
+        if (!tRing.ring) {
+            ThreadRing *ring = new ThreadRing;
+            ring->tid = r.rings.size() + 1;
+            ring->name.store(0);
+            ring->head.store(0);
+            ring->free.store(false);
+            ring->events = new Event[CAPACITY];
+            r.rings.push_back(ring);
+            tRing.ring = ring;
+        }
+    }
+    return tRing.ring;
+}
+
+// Time stamps and steady_clock time when tracing was enabled, which
+// convert time stamps to microseconds
+uint64_t gStartTicks = 0;
+std::chrono::steady_clock::time_point gStartTime;
+
+#ifndef CGTK_TRACE_RDTSC
+uint64_t steadyTicks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+#endif
+
+void writeString(std::ofstream &file, const char *s)
+{
+    file << '"';
+    for (; *s; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') {
+            file << '\\' << c;
+        }
+        else if (c < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            file << escaped;
+        }
+        else {
+            file << c;
+        }
+    }
+    file << '"';
+}
+}
+
+namespace cgtk {
+std::atomic<bool> Trace::sEnabled(false);
+
+void Trace::setEnabled(bool enabled)
+{
+    if (enabled && !isEnabled()) {
+        gStartTicks = now();
+        gStartTime = std::chrono::steady_clock::now();
+    }
+    sEnabled.store(enabled);
+}
+
+void Trace::setThreadName(const char *name)
+{
+    threadRing()->name.store(name, std::memory_order_relaxed);
+}
+
+uint64_t Trace::now()
+{
+#ifdef CGTK_TRACE_RDTSC
+    return __rdtsc();
+#else
+    return steadyTicks();
+#endif
+}
+
+void Trace::record(const char *name, uint64_t begin, uint64_t end)
+{
+    ThreadRing *ring = threadRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    Event &event = ring->events[head % CAPACITY];
+    // Orders the previous head before the stores below, so that a
+    // reader that sees any of them also sees that the slot is reused
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name.store(name, std::memory_order_relaxed);
+    event.begin.store(begin, std::memory_order_relaxed);
+    event.end.store(end, std::memory_order_relaxed);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+bool Trace::write(const std::string &filename)
+{
+    std::ofstream file(filename.c_str());
+    if (!file) {
+        return false;
+    }
+
+    // Calibrate the time stamps against steady_clock over the whole
+    // recording
+    double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - gStartTime).count();
+    uint64_t ticks = now() - gStartTicks;
+    double ticksPerUs = seconds > 0.0 && ticks > 0 ? ticks / (seconds * 1e6) : 1e3;
+
+    std::vector<ThreadRing *> rings;
+    {
+        Registry &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        rings = r.rings;
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    char number[64];
+    for (size_t i = 0; i < rings.size(); i++) {
+        ThreadRing *ring = rings[i];
+        const char *threadName = ring->name.load(std::memory_order_relaxed);
+        if (threadName) {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                 << ring->tid << ",\"args\":{\"name\":";
+            writeString(file, threadName);
+            file << "}}";
+            first = false;
+        }
+
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = head > CAPACITY ? head - CAPACITY : 0;
+        for (uint64_t j = begin; j < head; j++) {
+            const Event &event = ring->events[j % CAPACITY];
+            const char *name = event.name.load(std::memory_order_relaxed);
+            uint64_t t0 = event.begin.load(std::memory_order_relaxed);
+            uint64_t t1 = event.end.load(std::memory_order_relaxed);
+            // Skip the scope if its slot was reused while it was read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (j + CAPACITY <= ring->head.load(std::memory_order_relaxed) ||
+                t0 < gStartTicks || t1 < t0) {
+                continue;
+            }
+            std::snprintf(number, sizeof(number), "%.3f,\"dur\":%.3f",
+                          (t0 - gStartTicks) / ticksPerUs, (t1 - t0) / ticksPerUs);
+            file << (first ? "" : ",\n") << "{\"name\":";
+            writeString(file, name);
+            file << ",\"cat\":\"cpu\",\"ph\":\"X\",\"ts\":" << number
+                 << ",\"pid\":1,\"tid\":" << ring->tid << "}";
+            first = false;
+        }
+    }
+    file << "\n]}\n";
+    file.close();
+    return !file.fail();
+}
+}
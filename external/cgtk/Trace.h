@@ -0,0 +1,130 @@
+//! @file    Trace.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the Trace and TraceScope classes and the
+//! tracing macros
+//!
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+namespace cgtk {
+//! @class Trace Trace.h Trace.h
+//!
+//! @brief Records the time spent in scopes of code on every thread, for
+//! viewing as a timeline in the Chrome trace viewer or Perfetto.
+//!
+//! Each thread records its scopes into its own ring buffer, which it
+//! creates on its first scope, so recording takes no locks. When a ring
+//! is full, its oldest scopes are overwritten, and the ring of a thread
+//! that ended is reused by the next new thread. Time stamps come from
+//! the time stamp counter on x86 and from std::chrono::steady_clock
+//! elsewhere.
+//!
+//! Nothing is recorded until tracing is enabled. Use the CGTK_TRACE_*
+//! macros rather than the classes, so that defining CGTK_NO_TRACE
+//! removes the tracing at compile time.
+//!
+class Trace {
+public:
+    //! Start or stop recording.
+    //!
+    //! @param[in] enabled true to record scopes.
+    //!
+    static void setEnabled(bool enabled);
+
+    //! Check whether scopes are recorded.
+    //!
+    //! @return true if recording, otherwise false.
+    //!
+    static bool isEnabled()
+    {
+        return sEnabled.load(std::memory_order_relaxed);
+    }
+
+    //! Name the calling thread in the trace.
+    //!
+    //! @param[in] name Name of the thread. It must stay valid, e.g., a
+    //! string literal.
+    //!
+    static void setThreadName(const char *name);
+
+    //! Get the current time stamp.
+    //!
+    //! @return Time in ticks of the time stamp counter or nanoseconds.
+    //!
+    static uint64_t now();
+
+    //! Record a scope of the calling thread.
+    //!
+    //! @param[in] name Name of the scope, e.g., a string literal.
+    //! @param[in] begin Time stamp at the beginning of the scope.
+    //! @param[in] end Time stamp at the end of the scope.
+    //!
+    static void record(const char *name, uint64_t begin, uint64_t end);
+
+    //! Write the recorded scopes of all threads in the Chrome trace event
+    //! format. Scopes that are overwritten while writing are skipped.
+    //!
+    //! @param[in] filename Name of the JSON file.
+    //! @return true if the file was written, otherwise false.
+    //!
+    static bool write(const std::string &filename);
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+//! @class TraceScope Trace.h Trace.h
+//!
+//! @brief Records the time from its construction to its destruction.
+//!
+class TraceScope {
+public:
+    //! Constructor
+    //!
+    //! @param[in] name Name of the scope, e.g., a string literal.
+    //!
+    explicit TraceScope(const char *name) :
+        mName(Trace::isEnabled() ? name : 0),
+        mBegin(mName ? Trace::now() : 0)
+    {
+    }
+
+    //! Destructor
+    //!
+    ~TraceScope()
+    {
+        if (mName) {
+            Trace::record(mName, mBegin, Trace::now());
+        }
+    }
+private:
+    // Make instances non-copyable.
+    TraceScope(const TraceScope &);
+    const TraceScope &operator=(const TraceScope &);
+
+    const char *mName;
+    uint64_t mBegin;
+};
+}
+
+#ifdef CGTK_NO_TRACE
+#define CGTK_TRACE_SCOPE(name)
+#define CGTK_TRACE_FUNCTION()
+#define CGTK_TRACE_THREAD(name)
+#else
+#define CGTK_TRACE_CONCAT_(a, b) a##b
+#define CGTK_TRACE_CONCAT(a, b) CGTK_TRACE_CONCAT_(a, b)
+
+//! Record the rest of the enclosing block as a scope named name
+#define CGTK_TRACE_SCOPE(name) cgtk::TraceScope CGTK_TRACE_CONCAT(cgtkTraceScope, __LINE__)(name)
+
+//! Record the rest of the enclosing function under its name
+#define CGTK_TRACE_FUNCTION() CGTK_TRACE_SCOPE(__FUNCTION__)
+
+//! Name the calling thread in the trace
+#define CGTK_TRACE_THREAD(name) cgtk::Trace::setThreadName(name)
+#endif
@@ -42,7 +42,6 @@ Trackball::Trackball() :
     mQStart(glm::quat(1.0f, 0.0f, 0.0f, 0.0f)),
     mQCurrent(glm::quat(1.0f, 0.0f, 0.0f, 0.0f))
 {
-    std::cout << "Called Trackball constructor" << std::endl;
 }
 
 Trackball::~Trackball()
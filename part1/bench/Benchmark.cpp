@@ -0,0 +1,178 @@
+//! @file    Benchmark.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for Benchmark.h
+//!
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Discards everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c)
+    {
+        return c;
+    }
+};
+
+double median(std::vector<double> values)
+{
+    size_t middle = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + middle, values.end());
+    double value = values[middle];
+    if (values.size() % 2 == 0) {
+        value = 0.5 * (value + *std::max_element(values.begin(), values.begin() + middle));
+    }
+    return value;
+}
+
+// Milliseconds taken by a number of iterations
+double timeIterations(const std::function<void()> &function, int iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        function();
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void writeString(std::ostream &out, const std::string &s)
+{
+    out << '"';
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"' || s[i] == '\\') {
+            out << '\\';
+        }
+        out << s[i];
+    }
+    out << '"';
+}
+}
+
+Benchmark::Benchmark() :
+    mWarmup(3),
+    mRepetitions(15),
+    mMinTime(10.0)
+{
+}
+
+void Benchmark::setWarmup(int warmup)
+{
+    mWarmup = std::max(warmup, 1);
+}
+
+void Benchmark::setRepetitions(int repetitions)
+{
+    mRepetitions = std::max(repetitions, 1);
+}
+
+void Benchmark::setMinTime(double milliseconds)
+{
+    mMinTime = std::max(milliseconds, 0.0);
+}
+
+void Benchmark::setFilter(const std::string &filter)
+{
+    mFilter = filter;
+}
+
+bool Benchmark::isSelected(const std::string &name) const
+{
+    return mFilter.empty() || name.find(mFilter) != std::string::npos;
+}
+
+void Benchmark::run(const std::string &name, const std::function<void()> &function,
+                    double items, const std::string &unit)
+{
+    if (!isSelected(name)) {
+        return;
+    }
+    NullBuffer null;
+    std::streambuf *output = std::cout.rdbuf(&null);
+
+    // The slowest warmup repetition decides the iterations, so that
+    // each timed repetition takes at least mMinTime
+    double warmupTime = 0.0;
+    for (int i = 0; i < mWarmup; i++) {
+        warmupTime = std::max(warmupTime, timeIterations(function, 1));
+    }
+    int iterations = 1;
+    if (warmupTime < mMinTime) {
+        iterations = int(std::ceil(mMinTime / std::max(warmupTime, 1e-6)));
+        iterations = std::min(iterations, 1000000);
+    }
+
+    std::vector<double> times(mRepetitions);
+    for (int i = 0; i < mRepetitions; i++) {
+        times[i] = timeIterations(function, iterations) / iterations;
+    }
+    std::cout.rdbuf(output);
+
+    BenchmarkResult result;
+    result.name = name;
+    result.repetitions = mRepetitions;
+    result.iterations = iterations;
+    result.median = median(times);
+    std::vector<double> deviations(times.size());
+    for (size_t i = 0; i < times.size(); i++) {
+        deviations[i] = std::abs(times[i] - result.median);
+    }
+    result.mad = median(deviations);
+    result.min = *std::min_element(times.begin(), times.end());
+    result.max = *std::max_element(times.begin(), times.end());
+    result.items = items;
+    result.unit = unit;
+    mResults.push_back(result);
+
+    std::ios::fmtflags flags = std::cerr.flags();
+    std::streamsize precision = std::cerr.precision();
+    std::cerr << std::left << std::setw(32) << name << std::right << std::fixed
+              << std::setprecision(4) << std::setw(12) << result.median << " ms  +- "
+              << std::setw(9) << result.mad << " ms";
+    if (items > 0.0) {
+        std::cerr << std::setprecision(2) << std::setw(10) << 1e6 * result.median / items
+                  << " ns/" << unit;
+    }
+    std::cerr << std::endl;
+    std::cerr.flags(flags);
+    std::cerr.precision(precision);
+}
+
+const std::vector<BenchmarkResult> &Benchmark::getResults() const
+{
+    return mResults;
+}
+
+void Benchmark::writeJson(std::ostream &out) const
+{
+    out << "{\n  \"warmup\": " << mWarmup << ",\n  \"repetitions\": " << mRepetitions
+        << ",\n  \"benchmarks\": [";
+    out << std::setprecision(9);
+    for (size_t i = 0; i < mResults.size(); i++) {
+        const BenchmarkResult &r = mResults[i];
+        out << (i > 0 ? ",\n" : "\n") << "    {\"name\": ";
+        writeString(out, r.name);
+        out << ", \"repetitions\": " << r.repetitions
+            << ", \"iterations\": " << r.iterations
+            << ", \"median_ms\": " << r.median
+            << ", \"mad_ms\": " << r.mad
+            << ", \"min_ms\": " << r.min
+            << ", \"max_ms\": " << r.max;
+        if (r.items > 0.0) {
+            out << ", \"items\": " << r.items << ", \"unit\": ";
+            writeString(out, r.unit);
+            out << ", \"median_ns_per_item\": " << 1e6 * r.median / r.items;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,105 @@
+//! @file    Benchmark.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the Benchmark class
+//!
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Statistics of one benchmark. The times are per iteration.
+struct BenchmarkResult {
+    std::string name;
+    int repetitions;
+    int iterations;  // iterations per repetition
+    double median;   // milliseconds
+    double mad;      // median absolute deviation, milliseconds
+    double min;
+    double max;
+    double items;    // items processed per iteration, or 0
+    std::string unit;
+};
+
+//! @class Benchmark Benchmark.h Benchmark.h
+//!
+//! @brief Runs functions repeatedly and reports the median and median
+//! absolute deviation of their times.
+//!
+//! A benchmark first runs for a number of warmup repetitions, which are
+//! not timed, e.g., to fill the caches and allocate buffers. The
+//! warmup also decides how many iterations each timed repetition runs,
+//! so that short functions are not dominated by the resolution of the
+//! clock. The median and MAD are robust against the outliers of other
+//! processes, so results of different runs can be compared. The
+//! standard output of the functions is discarded.
+//!
+class Benchmark {
+public:
+    //! Constructor
+    //!
+    Benchmark();
+
+    //! Set the number of untimed repetitions.
+    //!
+    //! @param[in] warmup Number of repetitions.
+    //!
+    void setWarmup(int warmup);
+
+    //! Set the number of timed repetitions.
+    //!
+    //! @param[in] repetitions Number of repetitions.
+    //!
+    void setRepetitions(int repetitions);
+
+    //! Set the shortest time of a repetition.
+    //!
+    //! @param[in] milliseconds Time in milliseconds.
+    //!
+    void setMinTime(double milliseconds);
+
+    //! Run only the benchmarks whose name contains a string.
+    //!
+    //! @param[in] filter The string, or empty for all benchmarks.
+    //!
+    void setFilter(const std::string &filter);
+
+    //! Check whether a benchmark passes the filter.
+    //!
+    //! @param[in] name Name of the benchmark.
+    //! @return true if the benchmark is run, otherwise false.
+    //!
+    bool isSelected(const std::string &name) const;
+
+    //! Run a benchmark, if it passes the filter, and print its result.
+    //!
+    //! @param[in] name Name of the benchmark, e.g., "obj_parse/bunny".
+    //! @param[in] function The function to time, one iteration per call.
+    //! @param[in] items Number of items processed by an iteration, e.g.,
+    //! the triangles of a mesh, or 0.
+    //! @param[in] unit Name of an item, e.g., "triangle".
+    //!
+    void run(const std::string &name, const std::function<void()> &function,
+             double items = 0.0, const std::string &unit = "");
+
+    //! Get the results of the benchmarks run so far.
+    //!
+    //! @return The results in the order they were run.
+    //!
+    const std::vector<BenchmarkResult> &getResults() const;
+
+    //! Write the results as JSON.
+    //!
+    //! @param[in] out Stream to write to.
+    //!
+    void writeJson(std::ostream &out) const;
+private:
+    int mWarmup;
+    int mRepetitions;
+    double mMinTime;
+    std::string mFilter;
+    std::vector<BenchmarkResult> mResults;
+};
@@ -0,0 +1,258 @@
+// Microbenchmarks of the CPU work of the viewer: loading the models,
+// building the data derived from their meshes, extracting silhouettes,
+// decoding and encoding PNG images and the trackball math. Runs
+// without a display or OpenGL and writes its results as JSON, e.g.,
+// for tracking regressions between builds.
+//
+
+#include "OBJFileReader.h"
+#include "Trackball.h"
+#include "AdjacencyIndices.h"
+#include "SilhouetteEdges.h"
+#include "PngEncoder.h"
+#include "Benchmark.h"
+#include "lodepng.h"
+
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// The bundled 3D models
+const char *MODELS[] = { "bunny", "armadillo", "gargo", "teapot", "icosphere" };
+const int NUM_MODELS = sizeof(MODELS) / sizeof(MODELS[0]);
+
+// The cubemaps whose faces are decoded and encoded
+const char *CUBEMAPS[] = { "Forrest", "LarnacaCastle", "RomeChurch" };
+const int NUM_CUBEMAPS = sizeof(CUBEMAPS) / sizeof(CUBEMAPS[0]);
+
+const char *FACES[] = { "posx", "negx", "posy", "negy", "posz", "negz" };
+
+// The benchmarks of each model, named benchmark/model
+const char *MODEL_BENCHMARKS[] = {
+    "obj_load", "compute_normals", "adjacency_indices", "silhouette_build",
+    "silhouette_extract", "silhouette_brute_force"
+};
+const int NUM_MODEL_BENCHMARKS = sizeof(MODEL_BENCHMARKS) / sizeof(MODEL_BENCHMARKS[0]);
+
+// Number of eye positions the silhouettes are extracted for per
+// iteration
+const int NUM_EYES = 64;
+
+// Crease angle of the viewer, in degrees
+const float CREASE_ANGLE = 60.0f;
+
+// Returns the root of the repository, with the models and cubemaps
+std::string rootDir(void)
+{
+    const char *root = std::getenv("ASSIGNMENT3_ROOT");
+    if (root == NULL) {
+        std::cerr << "Error: ASSIGNMENT3_ROOT is not set." << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    return std::string(root);
+}
+
+// Eye positions spread evenly on a sphere around the model
+std::vector<glm::vec3> eyePositions(void)
+{
+    std::vector<glm::vec3> eyes;
+    for (int i = 0; i < NUM_EYES; i++) {
+        float z = 1.0f - 2.0f * (i + 0.5f) / NUM_EYES;
+        float r = std::sqrt(1.0f - z * z);
+        float phi = 2.39996323f * i;
+        eyes.push_back(1.5f * glm::vec3(r * std::cos(phi), r * std::sin(phi), z));
+    }
+    return eyes;
+}
+
+void benchmarkModel(Benchmark &bench, const std::string &model)
+{
+    bool selected = false;
+    for (int i = 0; i < NUM_MODEL_BENCHMARKS; i++) {
+        selected = selected || bench.isSelected(std::string(MODEL_BENCHMARKS[i]) + "/" + model);
+    }
+    if (!selected) {
+        return;
+    }
+
+    const std::string filename = rootDir() + "/3d_models/" + model + ".obj";
+    cgtk::OBJFileReader reader;
+    if (!reader.load(filename.c_str())) {
+        std::exit(EXIT_FAILURE);
+    }
+    const std::vector<glm::vec3> &vertices = reader.getVertices();
+    const std::vector<uint32_t> &indices = reader.getIndices();
+    const double numTriangles = indices.size() / 3;
+
+    // Includes computing the normals
+    bench.run("obj_load/" + model, [&]() {
+        cgtk::OBJFileReader r;
+        r.load(filename.c_str());
+    }, numTriangles, "triangle");
+
+    std::vector<glm::vec3> normals;
+    bench.run("compute_normals/" + model, [&]() {
+        cgtk::computeNormals(vertices, indices, normals);
+    }, numTriangles, "triangle");
+
+    std::vector<uint32_t> adjacency;
+    bench.run("adjacency_indices/" + model, [&]() {
+        buildAdjacencyIndices(indices, adjacency, 1);
+    }, numTriangles, "triangle");
+
+    SilhouetteEdges edges;
+    bench.run("silhouette_build/" + model, [&]() {
+        edges.build(vertices, indices, CREASE_ANGLE);
+    }, numTriangles, "triangle");
+
+    std::vector<glm::vec3> eyes = eyePositions();
+    std::vector<uint32_t> lines;
+    if (bench.isSelected("silhouette_extract/" + model) ||
+        bench.isSelected("silhouette_brute_force/" + model)) {
+        edges.build(vertices, indices, CREASE_ANGLE);
+    }
+    bench.run("silhouette_extract/" + model, [&]() {
+        for (int i = 0; i < NUM_EYES; i++) {
+            edges.extract(eyes[i], lines);
+        }
+    }, NUM_EYES, "eye");
+    bench.run("silhouette_brute_force/" + model, [&]() {
+        for (int i = 0; i < NUM_EYES; i++) {
+            edges.extractBruteForce(eyes[i], lines);
+        }
+    }, NUM_EYES, "eye");
+}
+
+void benchmarkCubemap(Benchmark &bench, const std::string &cubemap)
+{
+    if (!bench.isSelected("png_decode/" + cubemap) && !bench.isSelected("png_encode/" + cubemap)) {
+        return;
+    }
+
+    // The six faces are read once, so that only decoding is timed
+    std::vector<std::vector<unsigned char> > files(6);
+    std::vector<std::vector<unsigned char> > images(6);
+    unsigned width = 0;
+    unsigned height = 0;
+    double numPixels = 0.0;
+    for (int i = 0; i < 6; i++) {
+        const std::string filename = rootDir() + "/cubemaps/" + cubemap + "/" + FACES[i] + ".png";
+        lodepng::load_file(files[i], filename);
+        if (files[i].empty() || lodepng::decode(images[i], width, height, files[i], LCT_RGB) != 0) {
+            std::cerr << "Error: Could not decode " << filename << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        numPixels += double(width) * height;
+    }
+
+    bench.run("png_decode/" + cubemap, [&]() {
+        std::vector<unsigned char> image;
+        unsigned w;
+        unsigned h;
+        for (int i = 0; i < 6; i++) {
+            lodepng::decode(image, w, h, files[i], LCT_RGB);
+        }
+    }, numPixels, "pixel");
+
+    // The faces are the same size
+    PngSettings settings;
+    std::vector<unsigned char> png;
+    bench.run("png_encode/" + cubemap, [&]() {
+        for (int i = 0; i < 6; i++) {
+            PngEncoder::encode(&images[i][0], width, height, settings, &png);
+        }
+    }, numPixels, "pixel");
+}
+
+void benchmarkTrackball(Benchmark &bench)
+{
+    const int numMoves = 1000;
+    cgtk::Trackball trackball;
+    trackball.setRadius(300.0);
+    trackball.setCenter(glm::vec2(400.0f, 300.0f));
+    glm::mat4 sum(0.0f);
+    bench.run("trackball/drag", [&]() {
+        trackball.startTracking(glm::vec2(400.0f, 300.0f));
+        for (int i = 0; i < numMoves; i++) {
+            float t = 0.01f * i;
+            trackball.move(glm::vec2(400.0f + 250.0f * std::cos(t), 300.0f + 250.0f * std::sin(t)));
+            sum += trackball.getRotationMatrix();
+        }
+        trackball.stopTracking();
+    }, numMoves, "move");
+    // Keeps the compiler from dropping the matrices
+    if (sum[0][0] == 12345.0f) {
+        std::cerr << std::endl;
+    }
+}
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--json FILE] [--filter TEXT] [--repetitions N]" << std::endl
+              << "       [--warmup N] [--min-time MS]" << std::endl
+              << std::endl
+              << "  --json FILE        write the results to FILE, or - for the standard output" << std::endl
+              << "  --filter TEXT      run the benchmarks whose name contains TEXT" << std::endl
+              << "  --repetitions N    timed repetitions (default 15)" << std::endl
+              << "  --warmup N         untimed repetitions (default 3)" << std::endl
+              << "  --min-time MS      shortest time of a repetition (default 10)" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    Benchmark bench;
+    std::string json;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--json" && i + 1 < args.size()) {
+            json = args[++i];
+        }
+        else if (args[i] == "--filter" && i + 1 < args.size()) {
+            bench.setFilter(args[++i]);
+        }
+        else if (args[i] == "--repetitions" && i + 1 < args.size()) {
+            bench.setRepetitions(std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--warmup" && i + 1 < args.size()) {
+            bench.setWarmup(std::atoi(args[++i].c_str()));
+        }
+        else if (args[i] == "--min-time" && i + 1 < args.size()) {
+            bench.setMinTime(std::atof(args[++i].c_str()));
+        }
+        else {
+            printUsage(argv[0]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // The table and the messages of the loaders go to the standard
+    // error, so that the JSON can go to the standard output
+    std::ostream output(std::cout.rdbuf());
+    std::cout.rdbuf(std::cerr.rdbuf());
+    for (int i = 0; i < NUM_MODELS; i++) {
+        benchmarkModel(bench, MODELS[i]);
+    }
+    for (int i = 0; i < NUM_CUBEMAPS; i++) {
+        benchmarkCubemap(bench, CUBEMAPS[i]);
+    }
+    benchmarkTrackball(bench);
+
+    if (json == "-") {
+        bench.writeJson(output);
+    }
+    else if (!json.empty()) {
+        std::ofstream file(json.c_str());
+        bench.writeJson(file);
+        file.close();
+        if (file.fail()) {
+            std::cerr << "Error: Could not write " << json << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    std::exit(EXIT_SUCCESS);
+}
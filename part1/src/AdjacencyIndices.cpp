@@ -0,0 +1,196 @@
+//! @file    AdjacencyIndices.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for AdjacencyIndices.h
+//!
+
+#include "AdjacencyIndices.h"
+
+#include <thread>
+#include <algorithm>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Meshes below this many triangles are not worth spawning threads for
+const uint32_t MIN_TRIANGLES_PER_THREAD = 1 << 15;
+
+// Half-edges per partition, small enough for the partition's hash
+// table to stay in cache
+const uint32_t HALF_EDGES_PER_PARTITION = 1 << 15;
+
+const uint64_t EMPTY_SLOT = ~uint64_t(0);
+
+uint64_t directedKey(uint32_t a, uint32_t b)
+{
+    return (uint64_t(a) << 32) | b;
+}
+
+// Finalizer of MurmurHash3, scrambles all bits of the key
+uint64_t mixBits(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Both halves of an edge share their lower vertex index and therefore
+// land in the same partition. Vertex indices of neighbouring triangles
+// are usually close, so partitions also stay local in the mesh.
+uint32_t partitionOf(uint32_t a, uint32_t b, uint32_t verticesPerPartition)
+{
+    return std::min(a, b) / verticesPerPartition;
+}
+
+// Runs func(thread) on numThreads threads and waits for all of them
+template <typename Function>
+void parallelFor(int numThreads, Function func)
+{
+    std::vector<std::thread> threads;
+    for (int t = 1; t < numThreads; t++) {
+        threads.push_back(std::thread(func, t));
+    }
+    func(0);
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+        it->join();
+    }
+}
+
+struct HalfEdge {
+    uint32_t from;
+    uint32_t to;
+    uint32_t opposite;  // vertex of the triangle opposite to the edge
+    uint32_t index;     // 3 * triangle + corner
+};
+
+// Open addressing hash table from directed edge to the vertex opposite
+// to it
+class HalfEdgeTable {
+public:
+    explicit HalfEdgeTable(size_t numHalfEdges)
+    {
+        size_t capacity = 16;
+        while (capacity < 2 * numHalfEdges) {
+            capacity *= 2;
+        }
+        mKeys.assign(capacity, EMPTY_SLOT);
+        mValues.resize(capacity);
+        mMask = capacity - 1;
+    }
+
+    void insert(uint64_t key, uint32_t value)
+    {
+        size_t slot = mixBits(key) & mMask;
+        while (mKeys[slot] != EMPTY_SLOT) {
+            if (mKeys[slot] == key) {
+                return; // non-manifold edge, keep the first half-edge
+            }
+            slot = (slot + 1) & mMask;
+        }
+        mKeys[slot] = key;
+        mValues[slot] = value;
+    }
+
+    bool find(uint64_t key, uint32_t *value) const
+    {
+        size_t slot = mixBits(key) & mMask;
+        while (mKeys[slot] != EMPTY_SLOT) {
+            if (mKeys[slot] == key) {
+                *value = mValues[slot];
+                return true;
+            }
+            slot = (slot + 1) & mMask;
+        }
+        return false;
+    }
+private:
+    std::vector<uint64_t> mKeys;
+    std::vector<uint32_t> mValues;
+    size_t mMask;
+};
+}
+
+void buildAdjacencyIndices(std::vector<uint32_t> const &indices,
+                           std::vector<uint32_t> &adjacency,
+                           int numThreads)
+{
+    uint32_t numTriangles = indices.size() / 3;
+    uint32_t numHalfEdges = 3 * numTriangles;
+    adjacency.resize(6 * numTriangles);
+    if (numTriangles == 0) {
+        return;
+    }
+
+    if (numThreads <= 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1, std::min<int>(numThreads, numTriangles / MIN_TRIANGLES_PER_THREAD));
+    const uint32_t *tri = indices.data();
+    uint32_t numVertices = *std::max_element(indices.begin(), indices.begin() + numHalfEdges) + 1;
+    uint32_t numPartitions = std::max<uint32_t>(numThreads, numHalfEdges / HALF_EDGES_PER_PARTITION);
+    uint32_t verticesPerPartition = (numVertices + numPartitions - 1) / numPartitions;
+
+    // Count the half-edges of each thread's triangle range per partition
+    std::vector<uint32_t> offsets(numThreads * numPartitions, 0);
+    parallelFor(numThreads, [&](int t) {
+        uint32_t first = uint64_t(numTriangles) * t / numThreads;
+        uint32_t last = uint64_t(numTriangles) * (t + 1) / numThreads;
+        uint32_t *counts = &offsets[t * numPartitions];
+        for (uint32_t i = 3 * first; i < 3 * last; i += 3) {
+            counts[partitionOf(tri[i], tri[i + 1], verticesPerPartition)]++;
+            counts[partitionOf(tri[i + 1], tri[i + 2], verticesPerPartition)]++;
+            counts[partitionOf(tri[i + 2], tri[i], verticesPerPartition)]++;
+        }
+    });
+
+    // Exclusive prefix sum, partition-major so that each partition is
+    // a contiguous range
+    std::vector<uint32_t> partitionStart(numPartitions + 1, 0);
+    uint32_t sum = 0;
+    for (uint32_t p = 0; p < numPartitions; p++) {
+        partitionStart[p] = sum;
+        for (int t = 0; t < numThreads; t++) {
+            uint32_t count = offsets[t * numPartitions + p];
+            offsets[t * numPartitions + p] = sum;
+            sum += count;
+        }
+    }
+    partitionStart[numPartitions] = sum;
+
+    // Scatter the half-edges into their partitions. The records carry
+    // everything the matching needs, so that it never has to go back
+    // to the (randomly accessed) index buffer.
+    std::vector<HalfEdge> partitioned(numHalfEdges);
+    parallelFor(numThreads, [&](int t) {
+        uint32_t first = uint64_t(numTriangles) * t / numThreads;
+        uint32_t last = uint64_t(numTriangles) * (t + 1) / numThreads;
+        uint32_t *cursor = &offsets[t * numPartitions];
+        for (uint32_t i = 3 * first; i < 3 * last; i += 3) {
+            for (uint32_t k = 0; k < 3; k++) {
+                HalfEdge edge = { tri[i + k], tri[i + (k + 1) % 3], tri[i + (k + 2) % 3], i + k };
+                partitioned[cursor[partitionOf(edge.from, edge.to, verticesPerPartition)]++] = edge;
+                adjacency[2 * (i + k)] = edge.from;
+            }
+        }
+    });
+
+    // Match the twins within each partition. Every half-edge is written
+    // by exactly one partition, so no synchronization is needed.
+    parallelFor(numThreads, [&](int t) {
+        for (uint32_t p = t; p < numPartitions; p += numThreads) {
+            const HalfEdge *first = partitioned.data() + partitionStart[p];
+            const HalfEdge *last = partitioned.data() + partitionStart[p + 1];
+            HalfEdgeTable table(last - first);
+            for (const HalfEdge *edge = first; edge != last; ++edge) {
+                table.insert(directedKey(edge->from, edge->to), edge->opposite);
+            }
+            for (const HalfEdge *edge = first; edge != last; ++edge) {
+                uint32_t opposite = edge->opposite;
+                table.find(directedKey(edge->to, edge->from), &opposite);
+                adjacency[2 * edge->index + 1] = opposite;
+            }
+        }
+    });
+}
@@ -0,0 +1,35 @@
+//! @file    AdjacencyIndices.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the triangles-with-adjacency index builder
+//!
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+//! Build a GL_TRIANGLES_ADJACENCY index buffer from a triangle index
+//! buffer.
+//!
+//! For every triangle (v0, v1, v2) six indices (v0, a01, v1, a12, v2,
+//! a20) are written, where aij is the vertex opposite to the edge
+//! (vi, vj) in the neighbouring triangle. Boundary edges, and edges
+//! whose neighbour has an inconsistent winding, get the opposite vertex
+//! of the triangle itself, which makes the neighbour appear as the
+//! back side of the triangle.
+//!
+//! Half-edges are partitioned by their lower vertex index, so that both
+//! halves of an edge end up in the same partition, and the twins of
+//! each partition are matched with a small hash table of its own. All
+//! passes are linear in the number of triangles and run on numThreads
+//! threads.
+//!
+//! @param[in] indices Triangle indices, three per triangle.
+//! @param[out] adjacency Adjacency indices, six per triangle.
+//! @param[in] numThreads Number of worker threads, or 0 to use the
+//! number of hardware threads.
+//!
+void buildAdjacencyIndices(std::vector<uint32_t> const &indices,
+                           std::vector<uint32_t> &adjacency,
+                           int numThreads = 0);
@@ -0,0 +1,9 @@
+//! @file    DrawStats.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for DrawStats.h
+//!
+
+#include "DrawStats.h"
+
+DrawStats drawStats = { 0, 0, 0 };
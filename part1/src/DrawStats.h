@@ -0,0 +1,36 @@
+//! @file    DrawStats.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the draw call counters shared by the part1
+//! modules
+//!
+
+#pragma once
+
+// Draw calls, vertices and triangles submitted since the counters were
+// reset, counted next to each draw call. Only the thread that owns the
+// OpenGL context draws, so the counters are plain integers.
+struct DrawStats {
+    long drawCalls;
+    long long vertices;
+    long long triangles;
+};
+
+extern DrawStats drawStats;
+
+// Counts a draw call of numVertices vertices (or indices) making
+// numTriangles triangles
+inline void countDraw(long long numVertices, long long numTriangles)
+{
+    drawStats.drawCalls++;
+    drawStats.vertices += numVertices;
+    drawStats.triangles += numTriangles;
+}
+
+// Sets the counters to zero, e.g., at the start of a frame
+inline void resetDrawStats()
+{
+    drawStats.drawCalls = 0;
+    drawStats.vertices = 0;
+    drawStats.triangles = 0;
+}
@@ -0,0 +1,125 @@
+//! @file    EdgeQuads.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for EdgeQuads.h
+//!
+
+#include "EdgeQuads.h"
+#include "DrawStats.h"
+#include "MemoryRegistry.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstddef>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+enum AttributeLocation {
+    START = 0,
+    END = 1,
+    CORNER = 2
+};
+
+// Two triangles per edge, (endpoint, side) of each corner
+const float CORNERS[6][2] = {
+    { 0.0f, -1.0f }, { 1.0f, -1.0f }, { 1.0f, 1.0f },
+    { 0.0f, -1.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f }
+};
+}
+
+EdgeQuads::EdgeQuads() :
+    mProgram(),
+    mVertices(),
+    mVAO(0),
+    mVBO(0),
+    mCapacity(0),
+    mNumVertices(0)
+{
+}
+
+EdgeQuads::~EdgeQuads()
+{
+    if (mVAO) {
+        glDeleteVertexArrays(1, &mVAO);
+        glDeleteBuffers(1, &mVBO);
+    }
+    cgtk::MemoryRegistry::release(this);
+}
+
+bool EdgeQuads::init(const std::string &shaderDir)
+{
+    mProgram.setShaderSource(GL_VERTEX_SHADER, cgtk::readGLSLSource(shaderDir + "edge_quad.vert"));
+    mProgram.setShaderSource(GL_FRAGMENT_SHADER, cgtk::readGLSLSource(shaderDir + "edge_quad.frag"));
+    mProgram.setName("edge quads");
+    mProgram.update();
+    if (!mProgram.isValid()) {
+        std::cerr << "Error: Could not create edge quad program." << std::endl;
+        return false;
+    }
+
+    glGenBuffers(1, &mVBO);
+    glGenVertexArrays(1, &mVAO);
+    glBindVertexArray(mVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    glEnableVertexAttribArray(START);
+    glVertexAttribPointer(START, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, start));
+    glEnableVertexAttribArray(END);
+    glVertexAttribPointer(END, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, end));
+    glEnableVertexAttribArray(CORNER);
+    glVertexAttribPointer(CORNER, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, corner));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return true;
+}
+
+void EdgeQuads::update(std::vector<glm::vec3> const &vertices,
+                       std::vector<uint32_t> const &lines)
+{
+    mVertices.resize(lines.size() * 3);
+    Vertex *out = mVertices.data();
+    for (size_t i = 0; i + 1 < lines.size(); i += 2) {
+        glm::vec3 start = vertices[lines[i]];
+        glm::vec3 end = vertices[lines[i + 1]];
+        for (int k = 0; k < 6; k++, out++) {
+            out->start = start;
+            out->end = end;
+            out->corner = glm::vec2(CORNERS[k][0], CORNERS[k][1]);
+        }
+    }
+    mNumVertices = mVertices.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, mVBO);
+    auto verticesNBytes = mVertices.size() * sizeof(Vertex);
+    if (verticesNBytes > mCapacity) {
+        // Grow geometrically, so that the buffer and its accounting only
+        // change while the silhouette gets longer than ever before
+        mCapacity = std::max(verticesNBytes, 2 * mCapacity);
+        glBufferData(GL_ARRAY_BUFFER, mCapacity, NULL, GL_STREAM_DRAW);
+        cgtk::MemoryRegistry::set(this, cgtk::MEMORY_BUFFER, "edge quads", mCapacity);
+    }
+    if (verticesNBytes > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, verticesNBytes, mVertices.data());
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void EdgeQuads::draw(const glm::mat4 &mvp, glm::vec2 viewport, float width, glm::vec3 color)
+{
+    if (mNumVertices == 0) {
+        return;
+    }
+
+    mProgram.enable();
+    mProgram.setUniformMatrix4f("mvp", mvp);
+    mProgram.setUniform2f("viewport", viewport);
+    mProgram.setUniform1f("line_width", width);
+    mProgram.setUniform3f("outlineColor", color);
+
+    glBindVertexArray(mVAO);
+    glDrawArrays(GL_TRIANGLES, 0, mNumVertices);
+    countDraw(mNumVertices, mNumVertices / 3);
+    glBindVertexArray(0);
+
+    mProgram.disable();
+}
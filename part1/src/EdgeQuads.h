@@ -0,0 +1,75 @@
+//! @file    EdgeQuads.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the EdgeQuads class
+//!
+
+#pragma once
+
+#include "GLSLProgram.h"
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//! @class EdgeQuads EdgeQuads.h EdgeQuads.h
+//!
+//! @brief Renders mesh edges as screen-aligned quads with a fixed
+//! width in pixels.
+//!
+class EdgeQuads {
+public:
+    //! Constructor
+    //!
+    EdgeQuads();
+
+    //! Destructor
+    //!
+    ~EdgeQuads();
+
+    //! Load the edge_quad shaders and create the GL resources.
+    //! Requires a current OpenGL context.
+    //!
+    //! @param[in] shaderDir Directory containing the shaders.
+    //! @return true if the program was created, otherwise false.
+    //!
+    bool init(const std::string &shaderDir);
+
+    //! Upload a new set of edges. The vertex buffer only grows, so this
+    //! can be called every frame without reallocating it.
+    //!
+    //! @param[in] vertices The vertices of the mesh.
+    //! @param[in] lines Vertex index pairs, one per edge.
+    //!
+    void update(std::vector<glm::vec3> const &vertices,
+                std::vector<uint32_t> const &lines);
+
+    //! Draw the edges uploaded by the last call to update().
+    //!
+    //! @param[in] mvp Model-view-projection matrix of the mesh.
+    //! @param[in] viewport Viewport size in pixels.
+    //! @param[in] width Line width in pixels.
+    //! @param[in] color Line color.
+    //!
+    void draw(const glm::mat4 &mvp, glm::vec2 viewport, float width, glm::vec3 color);
+private:
+    struct Vertex {
+        glm::vec3 start;
+        glm::vec3 end;
+        glm::vec2 corner;
+    };
+
+    // Make instances non-copyable.
+    EdgeQuads(const EdgeQuads &);
+    const EdgeQuads &operator=(const EdgeQuads &);
+
+    cgtk::GLSLProgram mProgram;
+    std::vector<Vertex> mVertices;
+    GLuint mVAO;
+    GLuint mVBO;
+    size_t mCapacity;  // bytes allocated for mVBO
+    int mNumVertices;
+};
@@ -0,0 +1,201 @@
+//! @file    FrameCapture.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for FrameCapture.h
+//!
+
+#include "FrameCapture.h"
+#include "Trace.h"
+#include "MemoryRegistry.h"
+
+#include <iostream>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Timeout of a single wait for a fence, in nanoseconds
+const GLuint64 WAIT_TIMEOUT = 1000000000;
+}
+
+FrameCapture::FrameCapture() :
+    mSlots(),
+    mConsumer(),
+    mFormat(GL_RGBA),
+    mNext(0),
+    mNumPending(0),
+    mNumCaptured(0),
+    mNumDelivered(0),
+    mNumStalls(0),
+    mLatencySum(0.0),
+    mBytes(0.0),
+    mStart(std::chrono::steady_clock::now())
+{
+}
+
+FrameCapture::~FrameCapture()
+{
+    for (size_t i = 0; i < mSlots.size(); i++) {
+        if (mSlots[i].fence) {
+            glDeleteSync(mSlots[i].fence);
+        }
+        glDeleteBuffers(1, &mSlots[i].buffer);
+    }
+    cgtk::MemoryRegistry::release(this);
+}
+
+void FrameCapture::init(int numBuffers)
+{
+    mSlots.resize(numBuffers);
+    for (int i = 0; i < numBuffers; i++) {
+        Slot &slot = mSlots[i];
+        glGenBuffers(1, &slot.buffer);
+        slot.fence = 0;
+        slot.size = 0;
+        slot.width = 0;
+        slot.height = 0;
+        slot.frame = 0;
+    }
+    mNext = 0;
+    mNumPending = 0;
+    resetStatistics();
+}
+
+void FrameCapture::setConsumer(const Consumer &consumer)
+{
+    mConsumer = consumer;
+}
+
+void FrameCapture::setFormat(GLenum format)
+{
+    mFormat = format;
+}
+
+void FrameCapture::capture(int width, int height)
+{
+    CGTK_TRACE_SCOPE("capture");
+    poll();
+
+    // The ring is full and the oldest frame is still in flight
+    if (mNumPending == int(mSlots.size())) {
+        Slot &oldest = mSlots[mNext];
+        GLenum result;
+        do {
+            result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        if (result == GL_WAIT_FAILED) {
+            std::cerr << "Error: Waiting for a frame capture failed." << std::endl;
+        }
+        mNumStalls++;
+        deliver(oldest);
+    }
+
+    Slot &slot = mSlots[mNext];
+    size_t size = size_t(width) * height * (mFormat == GL_RGB ? 3 : 4);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    if (slot.size != size) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, size, NULL, GL_STREAM_READ);
+        slot.size = size;
+        size_t bytes = 0;
+        for (size_t i = 0; i < mSlots.size(); i++) {
+            bytes += mSlots[i].size;
+        }
+        cgtk::MemoryRegistry::set(this, cgtk::MEMORY_BUFFER, "frame capture", bytes);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, mFormat, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // Make sure the fence reaches the GPU, so that poll() can see it
+    // signal without flushing itself
+    glFlush();
+    slot.width = width;
+    slot.height = height;
+    slot.frame = mNumCaptured++;
+
+    mNext = (mNext + 1) % mSlots.size();
+    mNumPending++;
+}
+
+void FrameCapture::poll()
+{
+    while (mNumPending > 0) {
+        Slot &oldest = mSlots[(mNext + mSlots.size() - mNumPending) % mSlots.size()];
+        if (!isReady(oldest)) {
+            break;
+        }
+        deliver(oldest);
+    }
+}
+
+void FrameCapture::flush()
+{
+    while (mNumPending > 0) {
+        Slot &oldest = mSlots[(mNext + mSlots.size() - mNumPending) % mSlots.size()];
+        GLenum result;
+        do {
+            result = glClientWaitSync(oldest.fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        } while (result == GL_TIMEOUT_EXPIRED);
+        deliver(oldest);
+    }
+}
+
+void FrameCapture::resetStatistics()
+{
+    mNumCaptured = 0;
+    mNumDelivered = 0;
+    mNumStalls = 0;
+    mLatencySum = 0.0;
+    mBytes = 0.0;
+    mStart = std::chrono::steady_clock::now();
+}
+
+double FrameCapture::getLatencyFrames() const
+{
+    return mNumDelivered > 0 ? mLatencySum / mNumDelivered : 0.0;
+}
+
+double FrameCapture::getBytesPerSecond() const
+{
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - mStart;
+    return time.count() > 0.0 ? mBytes / time.count() : 0.0;
+}
+
+int FrameCapture::getNumStalls() const
+{
+    return mNumStalls;
+}
+
+int FrameCapture::getNumDelivered() const
+{
+    return mNumDelivered;
+}
+
+bool FrameCapture::isReady(const Slot &slot) const
+{
+    GLint status = GL_UNSIGNALED;
+    glGetSynciv(slot.fence, GL_SYNC_STATUS, 1, NULL, &status);
+    return status == GL_SIGNALED;
+}
+
+void FrameCapture::deliver(Slot &slot)
+{
+    CGTK_TRACE_SCOPE("deliver");
+    glDeleteSync(slot.fence);
+    slot.fence = 0;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+    const unsigned char *pixels = (const unsigned char *)
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, slot.size, GL_MAP_READ_BIT);
+    if (pixels) {
+        mConsumer(pixels, slot.width, slot.height, slot.frame);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    else {
+        std::cerr << "Error: Could not map frame " << slot.frame << "." << std::endl;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    mLatencySum += mNumCaptured - slot.frame;
+    mBytes += slot.size;
+    mNumDelivered++;
+    mNumPending--;
+}
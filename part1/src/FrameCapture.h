@@ -0,0 +1,140 @@
+//! @file    FrameCapture.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the FrameCapture class
+//!
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <functional>
+#include <vector>
+#include <chrono>
+
+//! @class FrameCapture FrameCapture.h FrameCapture.h
+//!
+//! @brief Asynchronous readback of rendered frames through a ring of
+//! pixel pack buffers.
+//!
+//! capture() only queues a glReadPixels into the next buffer of the ring
+//! followed by a fence, so it returns without waiting for the GPU. A
+//! buffer is mapped once its fence has signaled, normally when the ring
+//! comes around to it again N frames later, and the pixels are handed
+//! to the consumer. Rendering of the next frames therefore overlaps
+//! with the transfer of the previous ones. The ring only waits for the
+//! GPU (a stall) when the oldest frame is still not done when its
+//! buffer is needed again.
+//!
+class FrameCapture {
+public:
+    //! Called with the pixels of a captured frame, as tightly packed
+    //! rows in the capture format starting with the bottom row. The
+    //! pointer is only valid during the call.
+    //!
+    typedef std::function<void (const unsigned char *pixels, int width, int height, int frame)> Consumer;
+
+    //! Constructor
+    //!
+    FrameCapture();
+
+    //! Destructor
+    //!
+    ~FrameCapture();
+
+    //! Create the ring. Requires a current OpenGL context.
+    //!
+    //! @param[in] numBuffers Number of pixel pack buffers, i.e., the
+    //! number of frames in flight.
+    //!
+    void init(int numBuffers);
+
+    //! Set the function receiving the captured frames.
+    //!
+    //! @param[in] consumer The consumer.
+    //!
+    void setConsumer(const Consumer &consumer);
+
+    //! Set the pixel format of the captured frames. Call it when no
+    //! frames are in flight.
+    //!
+    //! @param[in] format GL_RGBA (the default) or GL_RGB.
+    //!
+    void setFormat(GLenum format);
+
+    //! Queue the readback of the currently bound read framebuffer.
+    //! Frames that are ready are delivered to the consumer first. Frames
+    //! are numbered in capture order starting from 0.
+    //!
+    //! @param[in] width Width of the region to read, from (0, 0).
+    //! @param[in] height Height of the region to read.
+    //!
+    void capture(int width, int height);
+
+    //! Deliver frames whose transfer has finished, without waiting.
+    //!
+    void poll();
+
+    //! Wait for all frames in flight and deliver them.
+    //!
+    void flush();
+
+    //! Reset the counters and the frame numbering. Call it when no
+    //! frames are in flight, e.g., after flush().
+    //!
+    void resetStatistics();
+
+    //! Get the average number of frames captured between the capture of
+    //! a frame and its delivery.
+    //!
+    //! @return Average capture latency in frames.
+    //!
+    double getLatencyFrames() const;
+
+    //! Get the number of bytes read back per second since the last
+    //! resetStatistics().
+    //!
+    //! @return Readback rate in bytes per second.
+    //!
+    double getBytesPerSecond() const;
+
+    //! Get the number of times capture() had to wait for the GPU.
+    //!
+    //! @return The number of stalls.
+    //!
+    int getNumStalls() const;
+
+    //! Get the number of frames delivered to the consumer.
+    //!
+    //! @return The number of delivered frames.
+    //!
+    int getNumDelivered() const;
+private:
+    // Make instances non-copyable.
+    FrameCapture(const FrameCapture &);
+    const FrameCapture &operator=(const FrameCapture &);
+
+    struct Slot {
+        GLuint buffer;
+        GLsync fence;
+        size_t size;
+        int width;
+        int height;
+        int frame;
+    };
+
+    bool isReady(const Slot &slot) const;
+    void deliver(Slot &slot);
+
+    std::vector<Slot> mSlots;
+    Consumer mConsumer;
+    GLenum mFormat;
+    int mNext;
+    int mNumPending;
+    int mNumCaptured;
+    int mNumDelivered;
+    int mNumStalls;
+    double mLatencySum;
+    double mBytes;
+    std::chrono::steady_clock::time_point mStart;
+};
@@ -0,0 +1,748 @@
+//! @file    GifWriter.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for GifWriter.h
+//!
+
+#include "GifWriter.h"
+#include "Trace.h"
+
+#include <stdint.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// At most 255 colors, index 255 (or the one after the last color) is
+// kept free for transparency
+const int MAX_COLORS = 255;
+
+const int MAX_CODE = 4095;
+
+// Changed region of a frame
+struct Rect {
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+// Finds the bounding rectangle of the pixels that differ from the
+// previous frame. Identical rows are skipped with memcmp.
+Rect changedRect(const unsigned char *rgb, const unsigned char *previous, int width, int height)
+{
+    Rect rect = { 0, 0, width, height };
+    if (!previous) {
+        return rect;
+    }
+    size_t rowSize = size_t(width) * 3;
+    int minX = width;
+    int maxX = -1;
+    int minY = height;
+    int maxY = -1;
+    for (int y = 0; y < height; y++) {
+        const unsigned char *row = rgb + y * rowSize;
+        const unsigned char *prev = previous + y * rowSize;
+        if (std::memcmp(row, prev, rowSize) == 0) {
+            continue;
+        }
+        int x0 = 0;
+        while (std::memcmp(row + 3 * x0, prev + 3 * x0, 3) == 0) {
+            x0++;
+        }
+        int x1 = width - 1;
+        while (std::memcmp(row + 3 * x1, prev + 3 * x1, 3) == 0) {
+            x1--;
+        }
+        minX = std::min(minX, x0);
+        maxX = std::max(maxX, x1);
+        minY = std::min(minY, y);
+        maxY = y;
+    }
+    if (maxY < 0) {
+        // Nothing changed, a single transparent pixel keeps the delay
+        Rect empty = { 0, 0, 1, 1 };
+        return empty;
+    }
+    Rect changed = { minX, minY, maxX - minX + 1, maxY - minY + 1 };
+    return changed;
+}
+
+// Color histogram with 5 bits per channel
+struct HistogramEntry {
+    uint32_t count;
+    uint32_t sum[3];
+    uint16_t key;
+};
+
+// Splits the histogram into at most maxColors boxes by median cut and
+// appends the average color of each box to the palette
+void medianCut(std::vector<HistogramEntry> &entries, int maxColors, std::vector<unsigned char> *palette)
+{
+    struct Box {
+        size_t begin;
+        size_t end;
+    };
+    std::vector<Box> boxes;
+    Box all = { 0, entries.size() };
+    boxes.push_back(all);
+
+    while (int(boxes.size()) < maxColors) {
+        // Split the box with the largest extent weighted by its count
+        int best = -1;
+        int bestChannel = 0;
+        double bestScore = 0.0;
+        for (size_t b = 0; b < boxes.size(); b++) {
+            if (boxes[b].end - boxes[b].begin < 2) {
+                continue;
+            }
+            int low[3] = { 31, 31, 31 };
+            int high[3] = { 0, 0, 0 };
+            double count = 0.0;
+            for (size_t i = boxes[b].begin; i < boxes[b].end; i++) {
+                for (int c = 0; c < 3; c++) {
+                    int value = (entries[i].key >> (10 - 5 * c)) & 31;
+                    low[c] = std::min(low[c], value);
+                    high[c] = std::max(high[c], value);
+                }
+                count += entries[i].count;
+            }
+            for (int c = 0; c < 3; c++) {
+                double score = (high[c] - low[c]) * count;
+                if (high[c] > low[c] && score > bestScore) {
+                    best = b;
+                    bestChannel = c;
+                    bestScore = score;
+                }
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+
+        Box &box = boxes[best];
+        int shift = 10 - 5 * bestChannel;
+        std::sort(entries.begin() + box.begin, entries.begin() + box.end,
+                  [shift](const HistogramEntry &a, const HistogramEntry &b) {
+                      return ((a.key >> shift) & 31) < ((b.key >> shift) & 31);
+                  });
+        double total = 0.0;
+        for (size_t i = box.begin; i < box.end; i++) {
+            total += entries[i].count;
+        }
+        double half = 0.0;
+        size_t split = box.begin + 1;
+        for (size_t i = box.begin; i < box.end - 1; i++) {
+            half += entries[i].count;
+            split = i + 1;
+            if (half >= total / 2.0) {
+                break;
+            }
+        }
+        Box upper = { split, box.end };
+        box.end = split;
+        boxes.push_back(upper);
+    }
+
+    for (size_t b = 0; b < boxes.size(); b++) {
+        double sum[3] = { 0.0, 0.0, 0.0 };
+        double count = 0.0;
+        for (size_t i = boxes[b].begin; i < boxes[b].end; i++) {
+            for (int c = 0; c < 3; c++) {
+                sum[c] += entries[i].sum[c];
+            }
+            count += entries[i].count;
+        }
+        for (int c = 0; c < 3; c++) {
+            palette->push_back((unsigned char) (sum[c] / count + 0.5));
+        }
+    }
+}
+
+// Maps 15-bit colors to the nearest palette entry, computed on first
+// use of each color
+class NearestColor {
+public:
+    NearestColor(const std::vector<unsigned char> &palette) :
+        mPalette(palette), mTable(32768, -1)
+    {
+    }
+
+    int operator()(const unsigned char *rgb)
+    {
+        int key = ((rgb[0] >> 3) << 10) | ((rgb[1] >> 3) << 5) | (rgb[2] >> 3);
+        if (mTable[key] < 0) {
+            int best = 0;
+            int bestDistance = 1 << 30;
+            for (size_t i = 0; i < mPalette.size() / 3; i++) {
+                int dr = int(mPalette[3 * i + 0]) - ((rgb[0] & 0xf8) | 4);
+                int dg = int(mPalette[3 * i + 1]) - ((rgb[1] & 0xf8) | 4);
+                int db = int(mPalette[3 * i + 2]) - ((rgb[2] & 0xf8) | 4);
+                int distance = 2 * dr * dr + 4 * dg * dg + 3 * db * db;
+                if (distance < bestDistance) {
+                    best = i;
+                    bestDistance = distance;
+                }
+            }
+            mTable[key] = best;
+        }
+        return mTable[key];
+    }
+private:
+    const std::vector<unsigned char> &mPalette;
+    std::vector<int16_t> mTable;
+};
+
+// Exact colors of a palette in an open addressing table
+class ColorTable {
+public:
+    ColorTable() : mKeys(TABLE_SIZE, uint32_t(EMPTY)), mValues(TABLE_SIZE), mSize(0)
+    {
+    }
+
+    // Returns the index of the color, or -1
+    int find(const unsigned char *rgb) const
+    {
+        uint32_t key = makeKey(rgb);
+        uint32_t slot = (key * 2654435761u) >> 22;
+        while (mKeys[slot] != key) {
+            if (mKeys[slot] == EMPTY) {
+                return -1;
+            }
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        return mValues[slot];
+    }
+
+    // Adds the color with the given index if it is new. Returns false
+    // if the table is full.
+    bool insert(const unsigned char *rgb, int index)
+    {
+        uint32_t key = makeKey(rgb);
+        uint32_t slot = (key * 2654435761u) >> 22;
+        while (mKeys[slot] != key && mKeys[slot] != EMPTY) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        if (mKeys[slot] == key) {
+            return true;
+        }
+        if (mSize == MAX_COLORS) {
+            return false;
+        }
+        mKeys[slot] = key;
+        mValues[slot] = index;
+        mSize++;
+        return true;
+    }
+private:
+    static const int TABLE_SIZE = 1024;
+    static const uint32_t EMPTY = 0xffffffff;
+
+    static uint32_t makeKey(const unsigned char *rgb)
+    {
+        return (uint32_t(rgb[0]) << 16) | (uint32_t(rgb[1]) << 8) | rgb[2];
+    }
+
+    std::vector<uint32_t> mKeys;
+    std::vector<unsigned char> mValues;
+    int mSize;
+};
+
+// Builds a palette for the pixels of the rectangle that changed
+// (mask[i] != 0). Returns true if the palette is exact, and then the
+// colors are in the color table; otherwise the colors were quantized.
+bool buildPalette(const unsigned char *rgb, int width, const Rect &rect, const std::vector<unsigned char> &mask,
+                  std::vector<unsigned char> *palette, ColorTable *colors)
+{
+    const unsigned char *previous = NULL;
+    bool exact = true;
+    for (int y = 0; y < rect.height && exact; y++) {
+        for (int x = 0; x < rect.width; x++) {
+            if (!mask[y * rect.width + x]) {
+                continue;
+            }
+            // Runs of equal colors are common
+            const unsigned char *p = rgb + 3 * (size_t(rect.y + y) * width + rect.x + x);
+            if (previous && std::memcmp(p, previous, 3) == 0) {
+                continue;
+            }
+            previous = p;
+            if (colors->find(p) >= 0) {
+                continue;
+            }
+            if (!colors->insert(p, palette->size() / 3)) {
+                exact = false;
+                break;
+            }
+            palette->insert(palette->end(), p, p + 3);
+        }
+    }
+    if (exact) {
+        if (palette->empty()) {
+            palette->assign(3, 0);
+        }
+        return true;
+    }
+
+    std::vector<HistogramEntry> histogram(32768);
+    for (int y = 0; y < rect.height; y++) {
+        for (int x = 0; x < rect.width; x++) {
+            if (!mask[y * rect.width + x]) {
+                continue;
+            }
+            const unsigned char *p = rgb + 3 * (size_t(rect.y + y) * width + rect.x + x);
+            HistogramEntry &entry = histogram[((p[0] >> 3) << 10) | ((p[1] >> 3) << 5) | (p[2] >> 3)];
+            entry.count++;
+            entry.sum[0] += p[0];
+            entry.sum[1] += p[1];
+            entry.sum[2] += p[2];
+        }
+    }
+    std::vector<HistogramEntry> entries;
+    for (int key = 0; key < 32768; key++) {
+        if (histogram[key].count > 0) {
+            histogram[key].key = key;
+            entries.push_back(histogram[key]);
+        }
+    }
+    palette->clear();
+    medianCut(entries, MAX_COLORS, palette);
+    return false;
+}
+
+// Packs variable-length codes LSB first into 255-byte sub-blocks
+class BitWriter {
+public:
+    BitWriter(std::vector<unsigned char> *out) :
+        mOut(out), mBits(0), mNumBits(0), mBlockStart(0)
+    {
+        startBlock();
+    }
+
+    void write(int code, int size)
+    {
+        mBits |= uint32_t(code) << mNumBits;
+        mNumBits += size;
+        while (mNumBits >= 8) {
+            put(mBits & 0xff);
+            mBits >>= 8;
+            mNumBits -= 8;
+        }
+    }
+
+    void finish()
+    {
+        if (mNumBits > 0) {
+            put(mBits & 0xff);
+        }
+        if (mOut->size() - mBlockStart == 1) {
+            mOut->pop_back();
+        }
+        else {
+            (*mOut)[mBlockStart] = mOut->size() - mBlockStart - 1;
+        }
+        mOut->push_back(0);
+    }
+private:
+    void startBlock()
+    {
+        mBlockStart = mOut->size();
+        mOut->push_back(0);
+    }
+
+    void put(unsigned char byte)
+    {
+        mOut->push_back(byte);
+        if (mOut->size() - mBlockStart == 256) {
+            (*mOut)[mBlockStart] = 255;
+            startBlock();
+        }
+    }
+
+    std::vector<unsigned char> *mOut;
+    uint32_t mBits;
+    int mNumBits;
+    size_t mBlockStart;
+};
+
+// Appends the LZW code size and the compressed sub-blocks
+void encodeLZW(const std::vector<unsigned char> &indices, int minCodeSize, std::vector<unsigned char> *out)
+{
+    out->push_back(minCodeSize);
+    BitWriter writer(out);
+
+    const int clearCode = 1 << minCodeSize;
+    const int endCode = clearCode + 1;
+    int codeSize = minCodeSize + 1;
+    int lastCode = endCode;
+
+    // Dictionary from (prefix code, index) to code, open addressing
+    const int TABLE_SIZE = 8192;
+    std::vector<int32_t> keys(TABLE_SIZE, -1);
+    std::vector<int16_t> codes(TABLE_SIZE);
+
+    writer.write(clearCode, codeSize);
+    int prefix = indices[0];
+    for (size_t i = 1; i < indices.size(); i++) {
+        int32_t key = (prefix << 8) | indices[i];
+        uint32_t slot = (uint32_t(key) * 2654435761u) >> 19;
+        while (keys[slot] != key && keys[slot] >= 0) {
+            slot = (slot + 1) & (TABLE_SIZE - 1);
+        }
+        if (keys[slot] == key) {
+            prefix = codes[slot];
+            continue;
+        }
+
+        writer.write(prefix, codeSize);
+        keys[slot] = key;
+        codes[slot] = ++lastCode;
+        if (lastCode >= (1 << codeSize)) {
+            codeSize++;
+        }
+        if (lastCode == MAX_CODE) {
+            // The dictionary is full, start over
+            writer.write(clearCode, codeSize);
+            std::fill(keys.begin(), keys.end(), -1);
+            codeSize = minCodeSize + 1;
+            lastCode = endCode;
+        }
+        prefix = indices[i];
+    }
+    writer.write(prefix, codeSize);
+    writer.write(endCode, codeSize);
+    writer.finish();
+}
+
+// Number of bits of the color table that holds numColors colors
+int colorTableBits(int numColors)
+{
+    int bits = 1;
+    while ((1 << bits) < numColors) {
+        bits++;
+    }
+    return bits;
+}
+
+void appendUint16(std::vector<unsigned char> *out, int value)
+{
+    out->push_back(value & 0xff);
+    out->push_back((value >> 8) & 0xff);
+}
+
+// Appends the palette padded to the size of the color table
+void appendColorTable(std::vector<unsigned char> *out, const std::vector<unsigned char> &palette, int bits)
+{
+    out->insert(out->end(), palette.begin(), palette.end());
+    out->insert(out->end(), 3 * (1 << bits) - palette.size(), 0);
+}
+}
+
+GifWriter::GifWriter() :
+    mSettings(),
+    mFilename(),
+    mFile(0),
+    mWidth(0),
+    mHeight(0),
+    mNumAdded(0),
+    mNumInFlight(0),
+    mStopping(false),
+    mNextToWrite(0),
+    mWriteFailed(false),
+    mNumFrames(0),
+    mNumQuantizedFrames(0),
+    mNumQueueWaits(0),
+    mNumBytes(0.0),
+    mNumEncodedPixels(0.0),
+    mEncodeTime(0.0)
+{
+}
+
+GifWriter::~GifWriter()
+{
+    close();
+}
+
+bool GifWriter::open(const std::string &filename, int width, int height, const GifSettings &settings)
+{
+    close();
+    mFile = std::fopen(filename.c_str(), "wb");
+    if (!mFile) {
+        std::cerr << "Error: Could not create " << filename << std::endl;
+        return false;
+    }
+    mFilename = filename;
+    mSettings = settings;
+    if (mSettings.numThreads <= 0) {
+        mSettings.numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    mSettings.queueSize = std::max(1, mSettings.queueSize);
+    mWidth = width;
+    mHeight = height;
+    mGlobalPalette.clear();
+    mPrevious.reset();
+    mNumAdded = 0;
+    mNextToWrite = 0;
+    mWriteFailed = false;
+    mNumFrames = 0;
+    mNumQuantizedFrames = 0;
+    mNumQueueWaits = 0;
+    mNumBytes = 0.0;
+    mNumEncodedPixels = 0.0;
+    mEncodeTime = 0.0;
+    mStopping = false;
+    for (int i = 0; i < mSettings.numThreads; i++) {
+        mThreads.push_back(std::thread(&GifWriter::work, this));
+    }
+    return true;
+}
+
+void GifWriter::addFrame(std::vector<unsigned char> &rgb)
+{
+    std::shared_ptr<std::vector<unsigned char> > frame(new std::vector<unsigned char>());
+    frame->swap(rgb);
+
+    if (mNumAdded == 0) {
+        // The header, including the global palette, has to be written
+        // before any frame
+        int tableBits = 1;
+        if (mSettings.palette == GIF_PALETTE_GLOBAL) {
+            Rect rect = { 0, 0, mWidth, mHeight };
+            std::vector<unsigned char> mask(size_t(mWidth) * mHeight, 1);
+            ColorTable colors;
+            buildPalette(&(*frame)[0], mWidth, rect, mask, &mGlobalPalette, &colors);
+            tableBits = colorTableBits(mGlobalPalette.size() / 3 + 1);
+        }
+        const char *signature = "GIF89a";
+        std::vector<unsigned char> header(signature, signature + 6);
+        appendUint16(&header, mWidth);
+        appendUint16(&header, mHeight);
+        header.push_back(mGlobalPalette.empty() ? 0x70 : 0xf0 | (tableBits - 1));
+        header.push_back(0);  // background color
+        header.push_back(0);  // square pixels
+        if (!mGlobalPalette.empty()) {
+            appendColorTable(&header, mGlobalPalette, tableBits);
+        }
+
+        // Loop forever
+        const unsigned char loop[] = {
+            0x21, 0xff, 0x0b, 'N', 'E', 'T', 'S', 'C', 'A', 'P', 'E', '2', '.', '0',
+            0x03, 0x01, 0x00, 0x00, 0x00
+        };
+        header.insert(header.end(), loop, loop + sizeof(loop));
+        std::lock_guard<std::mutex> lock(mMutex);
+        write(header);
+    }
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mNumInFlight >= mSettings.queueSize) {
+        mNumQueueWaits++;
+        while (mNumInFlight >= mSettings.queueSize) {
+            mFrameDone.wait(lock);
+        }
+    }
+    mNumInFlight++;
+    Task task = { mNumAdded++, frame, mPrevious };
+    mPrevious = frame;
+    mTasks.push_back(task);
+    mTaskAvailable.notify_one();
+}
+
+bool GifWriter::close()
+{
+    if (!mFile) {
+        return true;
+    }
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (mNumInFlight > 0) {
+            mFrameDone.wait(lock);
+        }
+        mStopping = true;
+    }
+    mTaskAvailable.notify_all();
+    for (size_t i = 0; i < mThreads.size(); i++) {
+        mThreads[i].join();
+    }
+    mThreads.clear();
+    mPrevious.reset();
+
+    if (mNumAdded == 0) {
+        // Without a frame there is no header, and a lone trailer is not a
+        // GIF, so leave no file behind
+        std::fclose(mFile);
+        mFile = 0;
+        std::remove(mFilename.c_str());
+        std::cerr << "Error: No frames for " << mFilename << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> trailer(1, 0x3b);
+    write(trailer);
+    bool success = std::fclose(mFile) == 0 && !mWriteFailed;
+    mFile = 0;
+    return success;
+}
+
+void GifWriter::work()
+{
+    CGTK_TRACE_THREAD("gif encoder");
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mTasks.empty() && !mStopping) {
+                mTaskAvailable.wait(lock);
+            }
+            if (mTasks.empty()) {
+                return;
+            }
+            task = mTasks.front();
+            mTasks.pop_front();
+        }
+        run(task);
+    }
+}
+
+void GifWriter::run(const Task &task)
+{
+    CGTK_TRACE_SCOPE("gif frame");
+    auto start = std::chrono::steady_clock::now();
+    const unsigned char *rgb = &(*task.rgb)[0];
+    const unsigned char *previous = task.previous ? &(*task.previous)[0] : NULL;
+    Rect rect = changedRect(rgb, previous, mWidth, mHeight);
+
+    // Pixels of the rectangle that differ from the previous frame
+    std::vector<unsigned char> mask(size_t(rect.width) * rect.height, 1);
+    bool transparent = previous != NULL;
+    if (transparent) {
+        for (int y = 0; y < rect.height; y++) {
+            for (int x = 0; x < rect.width; x++) {
+                size_t offset = 3 * (size_t(rect.y + y) * mWidth + rect.x + x);
+                mask[y * rect.width + x] = std::memcmp(rgb + offset, previous + offset, 3) != 0;
+            }
+        }
+    }
+
+    std::vector<unsigned char> localPalette;
+    ColorTable colors;
+    bool exact = false;
+    if (mGlobalPalette.empty()) {
+        exact = buildPalette(rgb, mWidth, rect, mask, &localPalette, &colors);
+    }
+    else {
+        // Colors of the first frame are found exactly, others get the
+        // nearest color
+        for (size_t i = 0; i < mGlobalPalette.size(); i += 3) {
+            colors.insert(&mGlobalPalette[i], i / 3);
+        }
+    }
+    const std::vector<unsigned char> &palette = mGlobalPalette.empty() ? localPalette : mGlobalPalette;
+    int numColors = palette.size() / 3;
+    int transparentIndex = numColors;
+    int tableBits = colorTableBits(numColors + (transparent || !mGlobalPalette.empty() ? 1 : 0));
+
+    NearestColor nearest(palette);
+    std::vector<unsigned char> indices(size_t(rect.width) * rect.height);
+    size_t numEncoded = 0;
+    for (int y = 0; y < rect.height; y++) {
+        for (int x = 0; x < rect.width; x++) {
+            size_t i = y * rect.width + x;
+            if (!mask[i]) {
+                indices[i] = transparentIndex;
+                continue;
+            }
+            const unsigned char *p = rgb + 3 * (size_t(rect.y + y) * mWidth + rect.x + x);
+            int index = exact || !mGlobalPalette.empty() ? colors.find(p) : -1;
+            indices[i] = index >= 0 ? index : nearest(p);
+            numEncoded++;
+        }
+    }
+
+    std::vector<unsigned char> data;
+    // Graphic control extension: do not dispose, so that the next frame
+    // is drawn over this one
+    data.push_back(0x21);
+    data.push_back(0xf9);
+    data.push_back(0x04);
+    data.push_back((1 << 2) | (transparent ? 1 : 0));
+    appendUint16(&data, mSettings.delay);
+    data.push_back(transparent ? transparentIndex : 0);
+    data.push_back(0x00);
+
+    data.push_back(0x2c);
+    appendUint16(&data, rect.x);
+    appendUint16(&data, rect.y);
+    appendUint16(&data, rect.width);
+    appendUint16(&data, rect.height);
+    if (mGlobalPalette.empty()) {
+        data.push_back(0x80 | (tableBits - 1));
+        appendColorTable(&data, palette, tableBits);
+    }
+    else {
+        data.push_back(0x00);
+    }
+    encodeLZW(indices, std::max(2, tableBits), &data);
+    double time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Write this and any following frames that are complete, in order
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCompleted[task.index].swap(data);
+    while (!mCompleted.empty() && mCompleted.begin()->first == mNextToWrite) {
+        write(mCompleted.begin()->second);
+        mCompleted.erase(mCompleted.begin());
+        mNextToWrite++;
+    }
+    mNumFrames++;
+    mNumQuantizedFrames += exact || !mGlobalPalette.empty() ? 0 : 1;
+    mNumEncodedPixels += numEncoded;
+    mEncodeTime += time;
+    mNumInFlight--;
+    mFrameDone.notify_all();
+}
+
+void GifWriter::write(const std::vector<unsigned char> &data)
+{
+    if (std::fwrite(&data[0], 1, data.size(), mFile) != data.size()) {
+        mWriteFailed = true;
+    }
+    mNumBytes += data.size();
+}
+
+int GifWriter::getNumFrames() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumFrames;
+}
+
+double GifWriter::getNumBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumBytes;
+}
+
+double GifWriter::getEncodedFraction() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    double numPixels = double(mWidth) * mHeight * mNumFrames;
+    return numPixels > 0.0 ? mNumEncodedPixels / numPixels : 0.0;
+}
+
+int GifWriter::getNumQuantizedFrames() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumQuantizedFrames;
+}
+
+double GifWriter::getEncodeTime() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEncodeTime;
+}
+
+int GifWriter::getNumQueueWaits() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumQueueWaits;
+}
@@ -0,0 +1,168 @@
+//! @file    GifWriter.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the GifWriter class
+//!
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Where the colors of the frames come from
+enum GifPalette {
+    GIF_PALETTE_LOCAL = 0,  // a palette for each frame
+    GIF_PALETTE_GLOBAL = 1  // one palette, built from the first frame
+};
+
+// Parameters of the writer
+struct GifSettings {
+    int delay;
+    GifPalette palette;
+    int numThreads;
+    int queueSize;
+
+    GifSettings()
+    {
+        delay = 4;
+        palette = GIF_PALETTE_LOCAL;
+        numThreads = 0;
+        queueSize = 8;
+    }
+};
+
+//! @class GifWriter GifWriter.h GifWriter.h
+//!
+//! @brief Writes looping GIF89a animations, encoding the frames in
+//! parallel.
+//!
+//! Only the bounding rectangle of the pixels that changed since the
+//! previous frame is stored, with the unchanged pixels inside it made
+//! transparent, so a turntable mostly stores the model. The palette of
+//! a frame is exact when the changed pixels have at most 255 colors,
+//! which is the common case for toon shading, and is otherwise built by
+//! median cut. Frames are encoded by a pool of threads and written in
+//! the order they were added.
+//!
+class GifWriter {
+public:
+    //! Constructor
+    //!
+    GifWriter();
+
+    //! Destructor. Closes the file.
+    //!
+    ~GifWriter();
+
+    //! Create the file and start the worker threads.
+    //!
+    //! @param[in] filename Name of the GIF file.
+    //! @param[in] width Width of the frames.
+    //! @param[in] height Height of the frames.
+    //! @param[in] settings Writer settings. numThreads = 0 uses one
+    //! thread per core.
+    //! @return true if the file was created, otherwise false.
+    //!
+    bool open(const std::string &filename, int width, int height, const GifSettings &settings);
+
+    //! Queue a frame. Blocks while the queue is full.
+    //!
+    //! @param[in,out] rgb Tightly packed RGB rows, top row first. The
+    //! contents are taken over and rgb is left empty.
+    //!
+    void addFrame(std::vector<unsigned char> &rgb);
+
+    //! Wait for the queued frames and finish the file. A file without
+    //! frames is removed, since it would not be a valid GIF.
+    //!
+    //! @return true if the whole file was written, otherwise false.
+    //!
+    bool close();
+
+    //! Get the number of frames written.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumFrames() const;
+
+    //! Get the number of bytes written.
+    //!
+    //! @return Size in bytes.
+    //!
+    double getNumBytes() const;
+
+    //! Get the fraction of the pixels that was encoded, the rest was
+    //! skipped as unchanged.
+    //!
+    //! @return Fraction between 0 and 1.
+    //!
+    double getEncodedFraction() const;
+
+    //! Get the number of frames that needed color quantization.
+    //!
+    //! @return The number of quantized frames.
+    //!
+    int getNumQuantizedFrames() const;
+
+    //! Get the worker time spent encoding, summed over all threads.
+    //!
+    //! @return Time in milliseconds.
+    //!
+    double getEncodeTime() const;
+
+    //! Get the number of times addFrame() blocked on a full queue.
+    //!
+    //! @return The number of waits.
+    //!
+    int getNumQueueWaits() const;
+private:
+    // Make instances non-copyable.
+    GifWriter(const GifWriter &);
+    const GifWriter &operator=(const GifWriter &);
+
+    struct Task {
+        int index;
+        std::shared_ptr<std::vector<unsigned char> > rgb;
+        std::shared_ptr<std::vector<unsigned char> > previous;
+    };
+
+    void work();
+    void run(const Task &task);
+    void write(const std::vector<unsigned char> &data);
+
+    GifSettings mSettings;
+    std::string mFilename;
+    FILE *mFile;
+    int mWidth;
+    int mHeight;
+    std::vector<unsigned char> mGlobalPalette;
+    std::shared_ptr<std::vector<unsigned char> > mPrevious;
+    int mNumAdded;
+
+    std::vector<std::thread> mThreads;
+    std::deque<Task> mTasks;
+    mutable std::mutex mMutex;
+    std::condition_variable mTaskAvailable;
+    std::condition_variable mFrameDone;
+    int mNumInFlight;
+    bool mStopping;
+
+    // Encoded frames waiting for their predecessors to be written
+    std::map<int, std::vector<unsigned char> > mCompleted;
+    int mNextToWrite;
+    bool mWriteFailed;
+
+    int mNumFrames;
+    int mNumQuantizedFrames;
+    int mNumQueueWaits;
+    double mNumBytes;
+    double mNumEncodedPixels;
+    double mEncodeTime;
+};
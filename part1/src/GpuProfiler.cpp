@@ -0,0 +1,406 @@
+//! @file    GpuProfiler.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for GpuProfiler.h
+//!
+
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// ARB_pipeline_statistics_query is newer than the bundled GLEW
+#ifndef GL_VERTEX_SHADER_INVOCATIONS_ARB
+#define GL_VERTEX_SHADER_INVOCATIONS_ARB 0x82F0
+#define GL_FRAGMENT_SHADER_INVOCATIONS_ARB 0x82F4
+#define GL_CLIPPING_INPUT_PRIMITIVES_ARB 0x82F6
+#define GL_CLIPPING_OUTPUT_PRIMITIVES_ARB 0x82F7
+#endif
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Number of frames the averages and percentiles are taken over
+const int WINDOW = 240;
+
+const GLenum STATISTIC_TARGETS[NUM_PIPELINE_STATISTICS] = {
+    GL_VERTEX_SHADER_INVOCATIONS_ARB, GL_FRAGMENT_SHADER_INVOCATIONS_ARB,
+    GL_CLIPPING_INPUT_PRIMITIVES_ARB, GL_CLIPPING_OUTPUT_PRIMITIVES_ARB
+};
+
+const char *STATISTIC_NAMES[NUM_PIPELINE_STATISTICS] = {
+    "vertex_shader_invocations", "fragment_shader_invocations",
+    "clipping_input_primitives", "clipping_output_primitives"
+};
+
+// Looks an extension up in the list of the core profile, which also
+// finds those GLEW does not know
+bool hasExtension(const char *name)
+{
+    GLint numExtensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
+    for (GLint i = 0; i < numExtensions; i++) {
+        const GLubyte *extension = glGetStringi(GL_EXTENSIONS, i);
+        if (extension && std::strcmp((const char *) extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+GpuProfiler::GpuProfiler() :
+    mEnabled(false),
+    mStatisticsSupported(false),
+    mStatistics(false),
+    mInFrame(false),
+    mDepth(0),
+    mCurrent(0),
+    mFrameHandle(-1),
+    mNumFrames(0),
+    mNumStatisticFrames(0),
+    mNumDropped(0),
+    mFrame(0)
+{
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (size_t i = 0; i < mPools.size(); i++) {
+        if (!mPools[i].queries.empty()) {
+            glDeleteQueries(mPools[i].queries.size(), &mPools[i].queries[0]);
+        }
+        if (!mPools[i].statisticQueries.empty()) {
+            glDeleteQueries(mPools[i].statisticQueries.size(), &mPools[i].statisticQueries[0]);
+        }
+    }
+}
+
+bool GpuProfiler::init(int numFrames)
+{
+    mEnabled = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+    if (!mEnabled) {
+        return false;
+    }
+    mStatisticsSupported = hasExtension("GL_ARB_pipeline_statistics_query");
+    mPools.resize(std::max(numFrames, 2));
+    for (size_t i = 0; i < mPools.size(); i++) {
+        mPools[i].numUsed = 0;
+        mPools[i].frame = 0;
+        mPools[i].pending = false;
+        mPools[i].statistics = false;
+    }
+    mCurrent = 0;
+    return true;
+}
+
+bool GpuProfiler::isEnabled() const
+{
+    return mEnabled;
+}
+
+bool GpuProfiler::isPipelineStatisticsSupported() const
+{
+    return mStatisticsSupported;
+}
+
+bool GpuProfiler::setPipelineStatistics(bool enabled)
+{
+    if (enabled && !mStatisticsSupported) {
+        return false;
+    }
+    mStatistics = enabled;
+    return true;
+}
+
+bool GpuProfiler::hasPipelineStatistics() const
+{
+    return mStatistics;
+}
+
+void GpuProfiler::beginFrame()
+{
+    if (!mEnabled) {
+        return;
+    }
+    int numPools = mPools.size();
+    mCurrent = (mCurrent + 1) % numPools;
+
+    // Read the frames that are done, oldest first. The end of the pass
+    // "frame" is the last query of a frame.
+    for (int i = 0; i < numPools; i++) {
+        Pool &pool = mPools[(mCurrent + i) % numPools];
+        if (!pool.pending) {
+            continue;
+        }
+        GLint available = 0;
+        glGetQueryObjectiv(pool.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        collect(pool);
+    }
+
+    Pool &pool = mPools[mCurrent];
+    if (pool.pending) {
+        mNumDropped++;
+        pool.pending = false;
+    }
+    pool.numUsed = 0;
+    pool.passes.clear();
+    pool.counted.clear();
+    pool.frame = mFrame++;
+    pool.statistics = mStatistics;
+    mInFrame = true;
+    mDepth = 0;
+    mFrameHandle = beginPass("frame");
+}
+
+void GpuProfiler::endFrame()
+{
+    if (!mInFrame) {
+        return;
+    }
+    endPass(mFrameHandle);
+    mPools[mCurrent].pending = true;
+    mInFrame = false;
+}
+
+void GpuProfiler::finish()
+{
+    int numPools = mPools.size();
+    for (int i = 1; i <= numPools; i++) {
+        Pool &pool = mPools[(mCurrent + i) % numPools];
+        if (pool.pending) {
+            collect(pool);
+        }
+    }
+}
+
+void GpuProfiler::reset()
+{
+    for (size_t i = 0; i < mPasses.size(); i++) {
+        mPasses[i].times.assign(WINDOW, 0.0);
+    }
+    for (size_t i = 0; i < mPasses.size(); i++) {
+        for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+            mPasses[i].statistics[j].assign(WINDOW, 0.0);
+        }
+    }
+    mNumFrames = 0;
+    mNumStatisticFrames = 0;
+    mNumDropped = 0;
+}
+
+int GpuProfiler::beginPass(const char *name)
+{
+    if (!mInFrame) {
+        return -1;
+    }
+    Pool &pool = mPools[mCurrent];
+    if (2 * pool.numUsed == int(pool.queries.size())) {
+        pool.queries.resize(pool.queries.size() + 2);
+        glGenQueries(2, &pool.queries[2 * pool.numUsed]);
+    }
+    int handle = pool.numUsed++;
+    pool.passes.push_back(findPass(name));
+    glQueryCounter(pool.queries[2 * handle], GL_TIMESTAMP);
+
+    // The passes directly inside the frame count the statistics
+    pool.counted.push_back(pool.statistics && mDepth == 1);
+    if (pool.counted.back()) {
+        size_t first = NUM_PIPELINE_STATISTICS * handle;
+        if (pool.statisticQueries.size() < first + NUM_PIPELINE_STATISTICS) {
+            pool.statisticQueries.resize(first + NUM_PIPELINE_STATISTICS, 0);
+        }
+        if (pool.statisticQueries[first] == 0) {
+            glGenQueries(NUM_PIPELINE_STATISTICS, &pool.statisticQueries[first]);
+        }
+        for (int i = 0; i < NUM_PIPELINE_STATISTICS; i++) {
+            glBeginQuery(STATISTIC_TARGETS[i], pool.statisticQueries[first + i]);
+        }
+    }
+    mDepth++;
+    return handle;
+}
+
+void GpuProfiler::endPass(int handle)
+{
+    if (handle < 0 || !mInFrame) {
+        return;
+    }
+    Pool &pool = mPools[mCurrent];
+    if (pool.counted[handle]) {
+        for (int i = 0; i < NUM_PIPELINE_STATISTICS; i++) {
+            glEndQuery(STATISTIC_TARGETS[i]);
+        }
+    }
+    glQueryCounter(pool.queries[2 * handle + 1], GL_TIMESTAMP);
+    mDepth--;
+}
+
+int GpuProfiler::getNumPasses() const
+{
+    return mPasses.size();
+}
+
+const char *GpuProfiler::getPassName(int pass) const
+{
+    return mPasses[pass].name;
+}
+
+double GpuProfiler::getAverage(int pass) const
+{
+    const Pass &p = mPasses[pass];
+    int count = std::min(mNumFrames, WINDOW);
+    if (count == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += p.times[i];
+    }
+    return sum / count;
+}
+
+double GpuProfiler::getPercentile(int pass, double percent) const
+{
+    const Pass &p = mPasses[pass];
+    int count = std::min(mNumFrames, WINDOW);
+    if (count == 0) {
+        return 0.0;
+    }
+    std::vector<double> times(p.times.begin(), p.times.begin() + count);
+    int rank = std::min(std::max(int(std::ceil(percent / 100.0 * count)), 1), count);
+    std::nth_element(times.begin(), times.begin() + rank - 1, times.end());
+    return times[rank - 1];
+}
+
+double GpuProfiler::getAverageStatistic(int pass, PipelineStatistic statistic) const
+{
+    const std::vector<double> &counts = mPasses[pass].statistics[statistic];
+    int count = std::min(mNumStatisticFrames, WINDOW);
+    if (count == 0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < count; i++) {
+        sum += counts[i];
+    }
+    return sum / count;
+}
+
+int GpuProfiler::getNumStatisticFrames() const
+{
+    return mNumStatisticFrames;
+}
+
+const char *GpuProfiler::getStatisticName(PipelineStatistic statistic)
+{
+    return STATISTIC_NAMES[statistic];
+}
+
+int GpuProfiler::getNumFrames() const
+{
+    return mNumFrames;
+}
+
+int GpuProfiler::getNumDropped() const
+{
+    return mNumDropped;
+}
+
+bool GpuProfiler::openCsv(const std::string &filename)
+{
+    mCsv.open(filename.c_str());
+    if (!mCsv) {
+        return false;
+    }
+    mCsv << "frame,pass,start_ms,time_ms\n";
+    return true;
+}
+
+// Adds the times of a finished frame to its passes. A pass that was
+// not drawn in the frame gets zero, so that the averages are per frame.
+void GpuProfiler::collect(Pool &pool)
+{
+    mFrameTimes.assign(mPasses.size(), 0.0);
+    GLuint64 frameStart = 0;
+    glGetQueryObjectui64v(pool.queries[0], GL_QUERY_RESULT, &frameStart);
+    for (int i = 0; i < pool.numUsed; i++) {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(pool.queries[2 * i], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(pool.queries[2 * i + 1], GL_QUERY_RESULT, &end);
+        double time = end > begin ? (end - begin) * 1e-6 : 0.0;
+        mFrameTimes[pool.passes[i]] += time;
+        if (mCsv.is_open()) {
+            mCsv << pool.frame << "," << mPasses[pool.passes[i]].name << ","
+                 << (begin > frameStart ? (begin - frameStart) * 1e-6 : 0.0) << "," << time << "\n";
+        }
+    }
+
+    int slot = mNumFrames % WINDOW;
+    for (size_t i = 0; i < mPasses.size(); i++) {
+        mPasses[i].times[slot] = mFrameTimes[i];
+    }
+    mNumFrames++;
+    if (pool.statistics) {
+        collectStatistics(pool);
+    }
+    pool.pending = false;
+}
+
+// Adds the pipeline statistics of a finished frame to its passes and
+// their sum to the frame
+void GpuProfiler::collectStatistics(const Pool &pool)
+{
+    mFrameStatistics.assign(NUM_PIPELINE_STATISTICS * mPasses.size(), 0.0);
+    for (int i = 0; i < pool.numUsed; i++) {
+        if (!pool.counted[i]) {
+            continue;
+        }
+        for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+            GLuint64 count = 0;
+            glGetQueryObjectui64v(pool.statisticQueries[NUM_PIPELINE_STATISTICS * i + j], GL_QUERY_RESULT, &count);
+            mFrameStatistics[NUM_PIPELINE_STATISTICS * pool.passes[i] + j] += double(count);
+            mFrameStatistics[j] += double(count);
+        }
+    }
+
+    int slot = mNumStatisticFrames % WINDOW;
+    for (size_t i = 0; i < mPasses.size(); i++) {
+        for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+            mPasses[i].statistics[j][slot] = mFrameStatistics[NUM_PIPELINE_STATISTICS * i + j];
+        }
+    }
+    mNumStatisticFrames++;
+}
+
+int GpuProfiler::findPass(const char *name)
+{
+    for (size_t i = 0; i < mPasses.size(); i++) {
+        if (mPasses[i].name == name || std::strcmp(mPasses[i].name, name) == 0) {
+            return i;
+        }
+    }
+    Pass pass;
+    pass.name = name;
+    pass.times.assign(WINDOW, 0.0);
+    for (int i = 0; i < NUM_PIPELINE_STATISTICS; i++) {
+        pass.statistics[i].assign(WINDOW, 0.0);
+    }
+    mPasses.push_back(pass);
+    return mPasses.size() - 1;
+}
+
+GpuScope::GpuScope(GpuProfiler &profiler, const char *name) :
+    mProfiler(profiler),
+    mHandle(profiler.beginPass(name))
+{
+}
+
+GpuScope::~GpuScope()
+{
+    mProfiler.endPass(mHandle);
+}
@@ -0,0 +1,263 @@
+//! @file    GpuProfiler.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the GpuProfiler and GpuScope classes
+//!
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+// The counters of ARB_pipeline_statistics_query read per pass
+enum PipelineStatistic {
+    VERTEX_SHADER_INVOCATIONS = 0,
+    FRAGMENT_SHADER_INVOCATIONS = 1,
+    CLIPPING_INPUT_PRIMITIVES = 2,
+    CLIPPING_OUTPUT_PRIMITIVES = 3,
+    NUM_PIPELINE_STATISTICS = 4
+};
+
+//! @class GpuProfiler GpuProfiler.h GpuProfiler.h
+//!
+//! @brief Measures the GPU time of named passes with timestamp queries.
+//!
+//! Each pass writes a GL_TIMESTAMP query when it begins and ends, so
+//! passes can nest. The queries of a frame come from one pool of a
+//! ring with one pool per frame in flight. A pool is read when the
+//! ring comes around to it, if its last query is available, so
+//! reading results never waits for the GPU. The results of a frame
+//! that is still not done then are dropped instead.
+//!
+//! The average and percentiles of a pass are taken over its last
+//! frames. Without ARB_timer_query (OpenGL 3.3), the profiler does
+//! nothing.
+//!
+//! With ARB_pipeline_statistics_query, the profiler can also count the
+//! shader invocations and clipped primitives of the passes. Only one
+//! query of a kind can be active at a time, so these are counted for
+//! the passes directly inside a frame, and the frame gets their sum.
+//!
+class GpuProfiler {
+public:
+    //! Constructor
+    //!
+    GpuProfiler();
+
+    //! Destructor
+    //!
+    ~GpuProfiler();
+
+    //! Create the ring. Requires a current OpenGL context.
+    //!
+    //! @param[in] numFrames Number of query pools, i.e., the number of
+    //! frames in flight.
+    //! @return true if timer queries are supported, otherwise false.
+    //!
+    bool init(int numFrames);
+
+    //! Check whether timer queries are supported.
+    //!
+    //! @return true if init() succeeded, otherwise false.
+    //!
+    bool isEnabled() const;
+
+    //! Check whether ARB_pipeline_statistics_query is supported.
+    //!
+    //! @return true if it is, otherwise false.
+    //!
+    bool isPipelineStatisticsSupported() const;
+
+    //! Count the pipeline statistics of the frames begun from now on.
+    //!
+    //! @param[in] enabled true to count them, false to stop.
+    //! @return false if they are not supported, otherwise true.
+    //!
+    bool setPipelineStatistics(bool enabled);
+
+    //! Check whether the pipeline statistics are counted.
+    //!
+    //! @return true if they are, otherwise false.
+    //!
+    bool hasPipelineStatistics() const;
+
+    //! Start a frame. Reads the results of the frames that are done and
+    //! begins the pass "frame", which covers the whole frame.
+    //!
+    void beginFrame();
+
+    //! End the frame.
+    //!
+    void endFrame();
+
+    //! Read the results of the frames in flight, waiting for the GPU,
+    //! e.g., before the times are reported at exit.
+    //!
+    void finish();
+
+    //! Forget the times measured so far, e.g., between the cases of a
+    //! benchmark. Call finish() first.
+    //!
+    void reset();
+
+    //! Begin a pass. Passes outside of a frame are not measured.
+    //!
+    //! @param[in] name Name of the pass. It must stay valid, e.g., a
+    //! string literal.
+    //! @return Handle for endPass().
+    //!
+    int beginPass(const char *name);
+
+    //! End a pass.
+    //!
+    //! @param[in] handle Value returned by beginPass().
+    //!
+    void endPass(int handle);
+
+    //! Get the number of passes seen so far. Passes are numbered in
+    //! the order they were first seen, starting with "frame".
+    //!
+    //! @return The number of passes.
+    //!
+    int getNumPasses() const;
+
+    //! Get the name of a pass.
+    //!
+    //! @param[in] pass Number of the pass.
+    //! @return The name.
+    //!
+    const char *getPassName(int pass) const;
+
+    //! Get the average GPU time of a pass per frame over the last
+    //! frames.
+    //!
+    //! @param[in] pass Number of the pass.
+    //! @return Time in milliseconds.
+    //!
+    double getAverage(int pass) const;
+
+    //! Get a percentile of the GPU time of a pass per frame over the
+    //! last frames.
+    //!
+    //! @param[in] pass Number of the pass.
+    //! @param[in] percent Percentile between 0 and 100.
+    //! @return Time in milliseconds.
+    //!
+    double getPercentile(int pass, double percent) const;
+
+    //! Get the average of a pipeline statistic of a pass per frame over
+    //! the last frames that counted them.
+    //!
+    //! @param[in] pass Number of the pass.
+    //! @param[in] statistic The statistic.
+    //! @return The average count, or 0 if the pass was not counted.
+    //!
+    double getAverageStatistic(int pass, PipelineStatistic statistic) const;
+
+    //! Get the number of frames whose pipeline statistics were read.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumStatisticFrames() const;
+
+    //! Get the name of a pipeline statistic, e.g., for reports.
+    //!
+    //! @param[in] statistic The statistic.
+    //! @return The name in lower case with underscores.
+    //!
+    static const char *getStatisticName(PipelineStatistic statistic);
+
+    //! Get the number of frames whose results were read.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumFrames() const;
+
+    //! Get the number of frames whose results were dropped because the
+    //! GPU had not finished them when their pool was needed again.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumDropped() const;
+
+    //! Write the results of every frame read from now on to a CSV file,
+    //! one row per pass and frame.
+    //!
+    //! @param[in] filename Name of the file.
+    //! @return true if the file was opened, otherwise false.
+    //!
+    bool openCsv(const std::string &filename);
+private:
+    // Make instances non-copyable.
+    GpuProfiler(const GpuProfiler &);
+    const GpuProfiler &operator=(const GpuProfiler &);
+
+    // The queries of a frame, a pair for each pass it measured, and the
+    // pipeline statistics queries of the passes that counted them
+    struct Pool {
+        std::vector<GLuint> queries;
+        std::vector<int> passes;
+        std::vector<GLuint> statisticQueries;
+        std::vector<bool> counted;
+        int numUsed;
+        int frame;
+        bool pending;
+        bool statistics;
+    };
+
+    // The times and pipeline statistics of a pass over the last frames
+    struct Pass {
+        const char *name;
+        std::vector<double> times;
+        std::vector<double> statistics[NUM_PIPELINE_STATISTICS];
+    };
+
+    void collect(Pool &pool);
+    void collectStatistics(const Pool &pool);
+    int findPass(const char *name);
+
+    bool mEnabled;
+    bool mStatisticsSupported;
+    bool mStatistics;
+    bool mInFrame;
+    int mDepth;
+    std::vector<Pool> mPools;
+    int mCurrent;
+    int mFrameHandle;
+    std::vector<Pass> mPasses;
+    std::vector<double> mFrameTimes;
+    std::vector<double> mFrameStatistics;
+    int mNumFrames;
+    int mNumStatisticFrames;
+    int mNumDropped;
+    int mFrame;
+    std::ofstream mCsv;
+};
+
+//! @class GpuScope GpuProfiler.h GpuProfiler.h
+//!
+//! @brief Measures a pass from its construction to its destruction.
+//!
+class GpuScope {
+public:
+    //! Constructor. Begins the pass.
+    //!
+    //! @param[in] profiler The profiler.
+    //! @param[in] name Name of the pass, e.g., a string literal.
+    //!
+    GpuScope(GpuProfiler &profiler, const char *name);
+
+    //! Destructor. Ends the pass.
+    //!
+    ~GpuScope();
+private:
+    // Make instances non-copyable.
+    GpuScope(const GpuScope &);
+    const GpuScope &operator=(const GpuScope &);
+
+    GpuProfiler &mProfiler;
+    int mHandle;
+};
@@ -0,0 +1,242 @@
+//! @file    InputLog.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for InputLog.h
+//!
+
+#include "InputLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Start of every log, followed by the format version
+const char MAGIC[4] = { 'T', 'I', 'L', 'G' };
+const unsigned char VERSION = 1;
+
+// Bit of the type byte telling that the tweakbar handled the event
+const unsigned char TWEAKBAR_FLAG = 0x80;
+
+int numArgs(int type)
+{
+    switch (type) {
+    case INPUT_RECORD_MOUSE_BUTTON:
+        return 3;
+    case INPUT_RECORD_KEY:
+        return 4;
+    case INPUT_RECORD_FRAMEBUFFER_SIZE:
+    case INPUT_RECORD_PARAMETER:
+        return 2;
+    default:
+        return 0;
+    }
+}
+
+// Number of values of a record, from its type and arguments, or -1 if
+// the record is invalid
+int numValues(int type, const int *args)
+{
+    switch (type) {
+    case INPUT_RECORD_MOUSE_BUTTON:
+    case INPUT_RECORD_CURSOR_POS:
+    case INPUT_RECORD_SCROLL:
+        return 2;
+    case INPUT_RECORD_KEY:
+    case INPUT_RECORD_FRAMEBUFFER_SIZE:
+        return 0;
+    case INPUT_RECORD_PARAMETER:
+        return args[1] >= 0 && args[1] <= 3 ? args[1] : -1;
+    default:
+        return -1;
+    }
+}
+
+// Unsigned LEB128
+void writeVarint(std::ofstream &file, uint64_t value)
+{
+    unsigned char bytes[10];
+    int size = 0;
+    do {
+        bytes[size] = value & 0x7f;
+        value >>= 7;
+        if (value != 0) {
+            bytes[size] |= 0x80;
+        }
+        size++;
+    } while (value != 0);
+    file.write((const char *) bytes, size);
+}
+
+bool readVarint(std::ifstream &file, uint64_t *value)
+{
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = file.get();
+        if (byte == EOF) {
+            return false;
+        }
+        *value |= uint64_t(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Zigzag coding keeps small negative arguments short
+uint64_t zigzag(int value)
+{
+    return (uint64_t(int64_t(value)) << 1) ^ uint64_t(int64_t(value) >> 63);
+}
+
+int unzigzag(uint64_t value)
+{
+    return int(int64_t(value >> 1) ^ -int64_t(value & 1));
+}
+
+// Floats are stored little-endian whatever the byte order of the host
+void writeFloat(std::ofstream &file, float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    unsigned char bytes[4] = {
+        (unsigned char)(bits), (unsigned char)(bits >> 8),
+        (unsigned char)(bits >> 16), (unsigned char)(bits >> 24)
+    };
+    file.write((const char *) bytes, 4);
+}
+
+bool readFloat(std::ifstream &file, float *value)
+{
+    unsigned char bytes[4];
+    if (!file.read((char *) bytes, 4)) {
+        return false;
+    }
+    uint32_t bits = uint32_t(bytes[0]) | uint32_t(bytes[1]) << 8 |
+                    uint32_t(bytes[2]) << 16 | uint32_t(bytes[3]) << 24;
+    std::memcpy(value, &bits, 4);
+    return true;
+}
+}
+
+InputLogWriter::InputLogWriter() :
+    mLastTime(0),
+    mNumRecords(0)
+{
+}
+
+bool InputLogWriter::open(const std::string &filename)
+{
+    mFile.open(filename.c_str(), std::ios::binary);
+    if (!mFile) {
+        return false;
+    }
+    mFile.write(MAGIC, 4);
+    mFile.put(VERSION);
+    mStart = std::chrono::steady_clock::now();
+    mLastTime = 0;
+    mNumRecords = 0;
+    return true;
+}
+
+bool InputLogWriter::isOpen() const
+{
+    return mFile.is_open();
+}
+
+void InputLogWriter::write(const InputRecord &record)
+{
+    if (!mFile.is_open()) {
+        return;
+    }
+    long long time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - mStart).count();
+    time = std::max(time, mLastTime);
+
+    mFile.put(char(record.type | (record.tweakbar ? TWEAKBAR_FLAG : 0)));
+    writeVarint(mFile, uint64_t(time - mLastTime));
+    for (int i = 0; i < numArgs(record.type); i++) {
+        writeVarint(mFile, zigzag(record.args[i]));
+    }
+    for (int i = 0; i < numValues(record.type, record.args); i++) {
+        writeFloat(mFile, record.values[i]);
+    }
+    mLastTime = time;
+    mNumRecords++;
+}
+
+bool InputLogWriter::close()
+{
+    if (!mFile.is_open()) {
+        return true;
+    }
+    mFile.close();
+    return !mFile.fail();
+}
+
+int InputLogWriter::getNumRecords() const
+{
+    return mNumRecords;
+}
+
+InputLogReader::InputLogReader() :
+    mLastTime(0),
+    mFailed(false)
+{
+}
+
+bool InputLogReader::open(const std::string &filename)
+{
+    mFile.open(filename.c_str(), std::ios::binary);
+    char header[5];
+    if (!mFile || !mFile.read(header, 5) ||
+        std::memcmp(header, MAGIC, 4) != 0 || header[4] != VERSION) {
+        return false;
+    }
+    mLastTime = 0;
+    mFailed = false;
+    return true;
+}
+
+bool InputLogReader::read(InputRecord *record)
+{
+    int type = mFile.get();
+    if (type == EOF) {
+        return false;
+    }
+    record->type = InputRecordType(type & ~TWEAKBAR_FLAG);
+    record->tweakbar = (type & TWEAKBAR_FLAG) != 0;
+
+    uint64_t delta;
+    mFailed = true;
+    if (!readVarint(mFile, &delta)) {
+        return false;
+    }
+    for (int i = 0; i < numArgs(record->type); i++) {
+        uint64_t arg;
+        if (!readVarint(mFile, &arg)) {
+            return false;
+        }
+        record->args[i] = unzigzag(arg);
+    }
+    int n = numValues(record->type, record->args);
+    if (n < 0) {
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!readFloat(mFile, &record->values[i])) {
+            return false;
+        }
+    }
+    mFailed = false;
+    mLastTime += delta;
+    record->time = mLastTime * 1e-6;
+    return true;
+}
+
+bool InputLogReader::failed() const
+{
+    return mFailed;
+}
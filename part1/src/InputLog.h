@@ -0,0 +1,135 @@
+//! @file    InputLog.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the InputLogWriter and InputLogReader classes
+//!
+
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+// Types of the records of an input log. The values are stored in the
+// log, so new types are appended.
+enum InputRecordType {
+    INPUT_RECORD_MOUSE_BUTTON = 1,      // args: button, action, mods; values: x, y
+    INPUT_RECORD_CURSOR_POS = 2,        // values: x, y
+    INPUT_RECORD_SCROLL = 3,            // values: x offset, y offset
+    INPUT_RECORD_KEY = 4,               // args: key, scancode, action, mods
+    INPUT_RECORD_FRAMEBUFFER_SIZE = 5,  // args: width, height
+    INPUT_RECORD_PARAMETER = 6          // args: parameter, number of values; values
+};
+
+// An input event or a change of a parameter
+struct InputRecord {
+    double time;  // seconds since the start of the recording
+    InputRecordType type;
+    bool tweakbar;  // the event was handled by the tweakbar
+    int args[4];
+    float values[3];
+
+    InputRecord()
+    {
+        time = 0.0;
+        type = INPUT_RECORD_CURSOR_POS;
+        tweakbar = false;
+        args[0] = args[1] = args[2] = args[3] = 0;
+        values[0] = values[1] = values[2] = 0.0f;
+    }
+};
+
+//! @class InputLogWriter InputLog.h InputLog.h
+//!
+//! @brief Writes input records to a compact binary log.
+//!
+//! Each record is a type byte, the time since the previous record in
+//! microseconds and its arguments as variable-length integers, and its
+//! values as 32-bit floats. A cursor move takes about 11 bytes.
+//!
+class InputLogWriter {
+public:
+    //! Constructor
+    //!
+    InputLogWriter();
+
+    //! Open the log and start its clock.
+    //!
+    //! @param[in] filename Name of the log file.
+    //! @return true if the file was opened, otherwise false.
+    //!
+    bool open(const std::string &filename);
+
+    //! Check whether the log is open.
+    //!
+    //! @return true if open() succeeded and close() was not called.
+    //!
+    bool isOpen() const;
+
+    //! Write a record, time stamped with the current time.
+    //!
+    //! @param[in] record The record. Its time is ignored.
+    //!
+    void write(const InputRecord &record);
+
+    //! Close the log.
+    //!
+    //! @return true if all records were written, otherwise false.
+    //!
+    bool close();
+
+    //! Get the number of records written.
+    //!
+    //! @return The number of records.
+    //!
+    int getNumRecords() const;
+private:
+    // Make instances non-copyable.
+    InputLogWriter(const InputLogWriter &);
+    const InputLogWriter &operator=(const InputLogWriter &);
+
+    std::ofstream mFile;
+    std::chrono::steady_clock::time_point mStart;
+    long long mLastTime;
+    int mNumRecords;
+};
+
+//! @class InputLogReader InputLog.h InputLog.h
+//!
+//! @brief Reads the records of a log written by InputLogWriter.
+//!
+class InputLogReader {
+public:
+    //! Constructor
+    //!
+    InputLogReader();
+
+    //! Open a log and check its header.
+    //!
+    //! @param[in] filename Name of the log file.
+    //! @return true if the file is an input log, otherwise false.
+    //!
+    bool open(const std::string &filename);
+
+    //! Read the next record.
+    //!
+    //! @param[out] record The record.
+    //! @return true if a record was read, false at the end of the log
+    //! or if it is corrupt.
+    //!
+    bool read(InputRecord *record);
+
+    //! Check whether the log ended in the middle of a record.
+    //!
+    //! @return true if the log is corrupt, otherwise false.
+    //!
+    bool failed() const;
+private:
+    // Make instances non-copyable.
+    InputLogReader(const InputLogReader &);
+    const InputLogReader &operator=(const InputLogReader &);
+
+    std::ifstream mFile;
+    long long mLastTime;
+    bool mFailed;
+};
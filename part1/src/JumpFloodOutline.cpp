@@ -0,0 +1,172 @@
+//! @file    JumpFloodOutline.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for JumpFloodOutline.h
+//!
+
+#include "JumpFloodOutline.h"
+#include "DrawStats.h"
+#include "MemoryRegistry.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Pixel coordinate written to texels that have not found a seed yet
+const GLfloat NO_SEED[] = { -1.0f, -1.0f, 0.0f, 0.0f };
+
+bool loadProgram(const std::string &name,
+                 const std::string &vertexShaderFilename,
+                 const std::string &fragmentShaderFilename,
+                 cgtk::GLSLProgram *program)
+{
+    program->setShaderSource(GL_VERTEX_SHADER, cgtk::readGLSLSource(vertexShaderFilename));
+    program->setShaderSource(GL_FRAGMENT_SHADER, cgtk::readGLSLSource(fragmentShaderFilename));
+    program->setName(name);
+    program->update();
+    return program->isValid();
+}
+
+void createSeedTexture(GLuint texture, int width, int height)
+{
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, width, height, 0, GL_RG, GL_FLOAT, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+}
+
+JumpFloodOutline::JumpFloodOutline() :
+    mSeedProgram(),
+    mStepProgram(),
+    mOutlineProgram(),
+    mFBO(0),
+    mEmptyVAO(0),
+    mTarget(0),
+    mWidth(0),
+    mHeight(0)
+{
+    mTextures[0] = 0;
+    mTextures[1] = 0;
+}
+
+JumpFloodOutline::~JumpFloodOutline()
+{
+    if (mFBO) {
+        glDeleteFramebuffers(1, &mFBO);
+        glDeleteTextures(2, mTextures);
+        glDeleteVertexArrays(1, &mEmptyVAO);
+    }
+    cgtk::MemoryRegistry::release(this);
+}
+
+bool JumpFloodOutline::init(const std::string &shaderDir)
+{
+    if (!loadProgram("jump flood seed", shaderDir + "jfa_seed.vert", shaderDir + "jfa_seed.frag", &mSeedProgram) ||
+        !loadProgram("jump flood step", shaderDir + "fullscreen.vert", shaderDir + "jfa_step.frag", &mStepProgram) ||
+        !loadProgram("jump flood outline", shaderDir + "fullscreen.vert", shaderDir + "jfa_outline.frag", &mOutlineProgram)) {
+        std::cerr << "Error: Could not create jump flood programs." << std::endl;
+        return false;
+    }
+
+    glGenFramebuffers(1, &mFBO);
+    glGenTextures(2, mTextures);
+    // The fullscreen triangle is generated from gl_VertexID, but the
+    // core profile still requires a bound VAO
+    glGenVertexArrays(1, &mEmptyVAO);
+
+    return true;
+}
+
+void JumpFloodOutline::resize(int width, int height)
+{
+    if (width == mWidth && height == mHeight) {
+        return;
+    }
+    mWidth = width;
+    mHeight = height;
+    createSeedTexture(mTextures[0], width, height);
+    createSeedTexture(mTextures[1], width, height);
+    // Two RG32F textures
+    cgtk::MemoryRegistry::set(this, cgtk::MEMORY_TEXTURE, "jump flood", 2 * size_t(width) * height * 8);
+}
+
+cgtk::GLSLProgram &JumpFloodOutline::getSeedProgram()
+{
+    return mSeedProgram;
+}
+
+void JumpFloodOutline::beginSeed(GLuint target)
+{
+    mTarget = target;
+    glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextures[0], 0);
+    glViewport(0, 0, mWidth, mHeight);
+    glClearBufferfv(GL_COLOR, 0, NO_SEED);
+
+    // Every covered pixel writes its own coordinate, so neither depth
+    // testing nor blending is needed for the mask
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+}
+
+void JumpFloodOutline::endSeed()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, mTarget);
+    glViewport(0, 0, mWidth, mHeight);
+    glEnable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+}
+
+void JumpFloodOutline::draw(GLuint target, glm::vec3 color, float width)
+{
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glBindVertexArray(mEmptyVAO);
+    glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
+    glViewport(0, 0, mWidth, mHeight);
+    glActiveTexture(GL_TEXTURE0);
+
+    // Ping-pong between the two seed textures with halving step sizes
+    int src = 0;
+    mStepProgram.enable();
+    mStepProgram.setUniform1i("seeds", 0);
+    for (int step = 1 << (getNumPasses(width) - 1); step >= 1; step /= 2) {
+        int dst = 1 - src;
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTextures[dst], 0);
+        glBindTexture(GL_TEXTURE_2D, mTextures[src]);
+        mStepProgram.setUniform1i("step_size", step);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        countDraw(3, 1);
+        src = dst;
+    }
+    mStepProgram.disable();
+
+    // Shade the outline band into the target, which is not the default
+    // framebuffer when rendering offscreen
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+    glEnable(GL_BLEND);
+    glBindTexture(GL_TEXTURE_2D, mTextures[src]);
+    mOutlineProgram.enable();
+    mOutlineProgram.setUniform1i("seeds", 0);
+    mOutlineProgram.setUniform3f("outlineColor", color);
+    mOutlineProgram.setUniform1f("outline_width", width);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    countDraw(3, 1);
+    mOutlineProgram.disable();
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+int JumpFloodOutline::getNumPasses(float width)
+{
+    // Steps 2^(n-1), ..., 2, 1 reach 2^n - 1 pixels from a seed
+    return std::max(1, int(std::ceil(std::log2(width + 1.0f))));
+}
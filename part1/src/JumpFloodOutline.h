@@ -0,0 +1,102 @@
+//! @file    JumpFloodOutline.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the JumpFloodOutline class
+//!
+
+#pragma once
+
+#include "GLSLProgram.h"
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+#include <string>
+
+//! @class JumpFloodOutline JumpFloodOutline.h JumpFloodOutline.h
+//!
+//! @brief Wide screen-space outlines computed with the jump flooding
+//! algorithm.
+//!
+//! The silhouette mask is rasterized into a seed texture, the nearest
+//! seed is propagated in ceil(log2(width + 1)) ping-pong passes and the
+//! outline band is finally shaded from the distance to that seed. The
+//! cost therefore grows logarithmically with the outline width instead
+//! of quadratically as with a dilation kernel.
+//!
+class JumpFloodOutline {
+public:
+    //! Constructor
+    //!
+    JumpFloodOutline();
+
+    //! Destructor
+    //!
+    ~JumpFloodOutline();
+
+    //! Load the shaders and create the GL resources. Requires a
+    //! current OpenGL context.
+    //!
+    //! @param[in] shaderDir Directory containing the jfa_*.frag,
+    //! jfa_seed.vert and fullscreen.vert shaders.
+    //! @return true if all programs were created, otherwise false.
+    //!
+    bool init(const std::string &shaderDir);
+
+    //! Resize the seed textures to match the framebuffer.
+    //!
+    //! @param[in] width Framebuffer width in pixels.
+    //! @param[in] height Framebuffer height in pixels.
+    //!
+    void resize(int width, int height);
+
+    //! Get the program used for rasterizing the silhouette mask. Draw
+    //! the geometry with it between beginSeed() and endSeed().
+    //!
+    //! @return The seed program.
+    //!
+    cgtk::GLSLProgram &getSeedProgram();
+
+    //! Bind and clear the seed target.
+    //!
+    //! @param[in] target The framebuffer the frame is drawn into, which
+    //! endSeed() binds again: 0 for the window, otherwise an offscreen
+    //! framebuffer. Passed in instead of queried, since
+    //! glGetIntegerv(GL_FRAMEBUFFER_BINDING) waits for the driver.
+    //!
+    void beginSeed(GLuint target);
+
+    //! Bind the framebuffer given to beginSeed() again.
+    //!
+    void endSeed();
+
+    //! Propagate the seeds and blend the outline into a framebuffer,
+    //! which is left bound.
+    //!
+    //! @param[in] target The framebuffer the frame is drawn into.
+    //! @param[in] color Outline color.
+    //! @param[in] width Outline width in pixels.
+    //!
+    void draw(GLuint target, glm::vec3 color, float width);
+
+    //! Get the number of propagation passes needed for a given width.
+    //!
+    //! @param[in] width Outline width in pixels.
+    //! @return The number of ping-pong passes.
+    //!
+    static int getNumPasses(float width);
+private:
+    // Make instances non-copyable.
+    JumpFloodOutline(const JumpFloodOutline &);
+    const JumpFloodOutline &operator=(const JumpFloodOutline &);
+
+    cgtk::GLSLProgram mSeedProgram;
+    cgtk::GLSLProgram mStepProgram;
+    cgtk::GLSLProgram mOutlineProgram;
+    GLuint mFBO;
+    GLuint mTextures[2];
+    GLuint mEmptyVAO;
+    GLuint mTarget;
+    int mWidth;
+    int mHeight;
+};
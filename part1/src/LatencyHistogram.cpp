@@ -0,0 +1,69 @@
+//! @file    LatencyHistogram.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for LatencyHistogram.h
+//!
+
+#include "LatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram(double binWidth, double range) :
+    mBinWidth(binWidth),
+    mBins(int(std::ceil(range / binWidth)) + 1, 0),
+    mCount(0),
+    mSum(0.0),
+    mMax(0.0)
+{
+}
+
+void LatencyHistogram::add(double time)
+{
+    int bin = int(std::max(time, 0.0) / mBinWidth);
+    mBins[std::min(bin, int(mBins.size()) - 1)]++;
+    mCount++;
+    mSum += time;
+    mMax = mCount == 1 ? time : std::max(mMax, time);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(mBins.begin(), mBins.end(), 0);
+    mCount = 0;
+    mSum = 0.0;
+    mMax = 0.0;
+}
+
+int LatencyHistogram::getCount() const
+{
+    return mCount;
+}
+
+double LatencyHistogram::getMean() const
+{
+    return mCount > 0 ? mSum / mCount : 0.0;
+}
+
+double LatencyHistogram::getMax() const
+{
+    return mMax;
+}
+
+double LatencyHistogram::getPercentile(double percent) const
+{
+    if (mCount == 0) {
+        return 0.0;
+    }
+
+    // The sample of this rank, counting from one, is the percentile
+    int rank = std::max(int(std::ceil(percent / 100.0 * mCount)), 1);
+    int seen = 0;
+    for (size_t i = 0; i + 1 < mBins.size(); i++) {
+        seen += mBins[i];
+        if (seen >= rank) {
+            return std::min((i + 0.5) * mBinWidth, mMax);
+        }
+    }
+    return mMax;
+}
@@ -0,0 +1,71 @@
+//! @file    LatencyHistogram.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the LatencyHistogram class
+//!
+
+#pragma once
+
+#include <vector>
+
+//! @class LatencyHistogram LatencyHistogram.h LatencyHistogram.h
+//!
+//! @brief Histogram of times with fixed-width bins, for percentiles of
+//! any number of samples in constant memory.
+//!
+//! Percentiles are accurate to half a bin. Samples beyond the last bin
+//! are counted in it, and percentiles that fall there return the
+//! largest sample.
+//!
+class LatencyHistogram {
+public:
+    //! Constructor
+    //!
+    //! @param[in] binWidth Width of a bin, in milliseconds.
+    //! @param[in] range Upper end of the last regular bin, in
+    //! milliseconds.
+    //!
+    LatencyHistogram(double binWidth = 0.05, double range = 1000.0);
+
+    //! Add a sample.
+    //!
+    //! @param[in] time Time in milliseconds.
+    //!
+    void add(double time);
+
+    //! Remove all samples.
+    //!
+    void reset();
+
+    //! Get the number of samples.
+    //!
+    //! @return The number of samples.
+    //!
+    int getCount() const;
+
+    //! Get the mean of the samples.
+    //!
+    //! @return Time in milliseconds, or zero without samples.
+    //!
+    double getMean() const;
+
+    //! Get the largest sample.
+    //!
+    //! @return Time in milliseconds, or zero without samples.
+    //!
+    double getMax() const;
+
+    //! Get a percentile of the samples.
+    //!
+    //! @param[in] percent Percentile between 0 and 100, e.g., 50 for
+    //! the median.
+    //! @return Time in milliseconds, or zero without samples.
+    //!
+    double getPercentile(double percent) const;
+private:
+    double mBinWidth;
+    std::vector<int> mBins;
+    int mCount;
+    double mSum;
+    double mMax;
+};
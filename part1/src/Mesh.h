@@ -0,0 +1,35 @@
+//! @file    Mesh.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the mesh structs shared by the part1 modules
+//!
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+#include <stdint.h>
+#include <vector>
+
+// Struct for representing an indexed triangle mesh
+struct Mesh {
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::vec3> normals;
+    std::vector<uint32_t> indices;
+    std::vector<uint32_t> adjacencyIndices; // GL_TRIANGLES_ADJACENCY
+};
+
+// Struct for representing a vertex array object (VAO) created from a
+// mesh. Used for rendering.
+struct MeshVAO {
+    GLuint vao;
+    GLuint vertexVBO;
+    GLuint normalVBO;
+    GLuint indexVBO;
+    GLuint adjacencyVAO;
+    GLuint adjacencyIndexVBO;
+    int numVertices;
+    int numIndices;
+    int numAdjacencyIndices;
+};
@@ -0,0 +1,243 @@
+//! @file    MetricsServer.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for MetricsServer.h
+//!
+
+#include "MetricsServer.h"
+#include "Trace.h"
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Milliseconds the server thread waits for a connection before it
+// checks whether to quit, and for a slow client to send its request
+const int POLL_TIMEOUT = 200;
+const int REQUEST_TIMEOUT = 2000;
+
+// Largest request read, which is far more than any scraper sends
+const size_t MAX_REQUEST_SIZE = 8192;
+
+const char *CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+
+#ifndef _WIN32
+bool sendAll(int fd, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += n;
+    }
+    return true;
+}
+#endif
+
+std::string response(const char *status, const std::string &body)
+{
+    std::ostringstream out;
+    out << "HTTP/1.1 " << status << "\r\n"
+        << "Content-Type: " << CONTENT_TYPE << "\r\n"
+        << "Content-Length: " << body.size() << "\r\n"
+        << "Connection: close\r\n\r\n"
+        << body;
+    return out.str();
+}
+}
+
+MetricsServer::MetricsServer() :
+    mHandler(),
+    mSocket(-1),
+    mPath(),
+    mThread(),
+    mQuit(false),
+    mNumRequests(0)
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+bool MetricsServer::start(const std::string &address, const Handler &handler)
+{
+    stop();
+#ifdef _WIN32
+    std::cerr << "Error: The metrics endpoint is not available on Windows." << std::endl;
+    return false;
+#else
+    // A scraper that hangs up makes the writes fail instead of killing
+    // the program
+    signal(SIGPIPE, SIG_IGN);
+
+    if (address.compare(0, 5, "unix:") == 0) {
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "Error: Invalid socket path " << path << std::endl;
+            return false;
+        }
+        std::strcpy(addr.sun_path, path.c_str());
+        // Only a socket left behind by an earlier run is replaced
+        struct stat status;
+        if (lstat(path.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                std::cerr << "Error: " << path << " exists and is not a socket" << std::endl;
+                return false;
+            }
+            unlink(path.c_str());
+        }
+        mSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (mSocket < 0 || bind(mSocket, (sockaddr *) &addr, sizeof(addr)) != 0) {
+            std::cerr << "Error: Could not bind " << path << ": " << std::strerror(errno) << std::endl;
+            stop();
+            return false;
+        }
+        mPath = path;
+    }
+    else {
+        char *end = NULL;
+        long port = std::strtol(address.c_str(), &end, 10);
+        if (address.empty() || *end != '\0' || port < 1 || port > 65535) {
+            std::cerr << "Error: Invalid metrics port " << address << std::endl;
+            return false;
+        }
+        sockaddr_in addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        mSocket = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        if (mSocket >= 0) {
+            setsockopt(mSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (mSocket < 0 || bind(mSocket, (sockaddr *) &addr, sizeof(addr)) != 0) {
+            std::cerr << "Error: Could not bind port " << port << ": " << std::strerror(errno) << std::endl;
+            stop();
+            return false;
+        }
+    }
+    if (listen(mSocket, 8) != 0) {
+        std::cerr << "Error: Could not listen for metrics: " << std::strerror(errno) << std::endl;
+        stop();
+        return false;
+    }
+
+    mHandler = handler;
+    mQuit = false;
+    mThread = std::thread(&MetricsServer::run, this);
+    return true;
+#endif
+}
+
+void MetricsServer::stop()
+{
+#ifndef _WIN32
+    mQuit = true;
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+    if (mSocket >= 0) {
+        close(mSocket);
+        mSocket = -1;
+    }
+    if (!mPath.empty()) {
+        unlink(mPath.c_str());
+        mPath.clear();
+    }
+#endif
+}
+
+bool MetricsServer::isRunning() const
+{
+    return mSocket >= 0 && mThread.joinable();
+}
+
+int MetricsServer::getNumRequests() const
+{
+    return mNumRequests;
+}
+
+void MetricsServer::run()
+{
+#ifndef _WIN32
+    CGTK_TRACE_THREAD("metrics");
+    while (!mQuit) {
+        pollfd listening = { mSocket, POLLIN, 0 };
+        if (poll(&listening, 1, POLL_TIMEOUT) <= 0) {
+            continue;
+        }
+        int connection = accept(mSocket, NULL, NULL);
+        if (connection < 0) {
+            continue;
+        }
+        serve(connection);
+        close(connection);
+    }
+#endif
+}
+
+void MetricsServer::serve(int connection)
+{
+#ifndef _WIN32
+    // Reads up to the end of the headers; a body is never expected
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+        pollfd client = { connection, POLLIN, 0 };
+        if (poll(&client, 1, REQUEST_TIMEOUT) <= 0) {
+            return;
+        }
+        ssize_t n = recv(connection, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+            return;
+        }
+        request.append(buffer, n);
+    }
+
+    std::istringstream line(request.substr(0, request.find("\r\n")));
+    std::string method;
+    std::string target;
+    line >> method >> target;
+    std::string path = target.substr(0, target.find('?'));
+    CGTK_TRACE_SCOPE("serve metrics");
+    if (method != "GET" && method != "HEAD") {
+        sendAll(connection, response("405 Method Not Allowed", "Only GET is supported\n"));
+    }
+    else if (path != "/metrics" && path != "/") {
+        sendAll(connection, response("404 Not Found", "Metrics are served at /metrics\n"));
+    }
+    else {
+        std::string reply = response("200 OK", mHandler());
+        if (method == "HEAD") {
+            reply.erase(reply.find("\r\n\r\n") + 4);
+        }
+        sendAll(connection, reply);
+    }
+    mNumRequests++;
+#else
+    (void) connection;
+#endif
+}
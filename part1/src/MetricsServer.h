@@ -0,0 +1,83 @@
+//! @file    MetricsServer.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the MetricsServer class
+//!
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+
+//! @class MetricsServer MetricsServer.h MetricsServer.h
+//!
+//! @brief Serves metrics over HTTP on a localhost TCP port or a Unix
+//! domain socket, e.g., for Prometheus.
+//!
+//! The server runs on its own thread and answers one request at a
+//! time: GET /metrics (or /) with the text returned by the handler, and
+//! anything else with an error. The handler runs on the server thread,
+//! so it must only read what other threads hand to it safely. TCP
+//! connections are only accepted on 127.0.0.1. Test with, e.g.,
+//!
+//!   curl http://127.0.0.1:9100/metrics
+//!   curl --unix-socket /tmp/part1.sock http://localhost/metrics
+//!
+//! Not available on Windows.
+//!
+class MetricsServer {
+public:
+    // Produces the body of a response
+    typedef std::function<std::string()> Handler;
+
+    //! Constructor
+    //!
+    MetricsServer();
+
+    //! Destructor. Stops the server.
+    //!
+    ~MetricsServer();
+
+    //! Start serving.
+    //!
+    //! @param[in] address A TCP port, e.g., "9100", or "unix:" followed
+    //! by the path of the socket, e.g., "unix:/tmp/part1.sock". An
+    //! existing socket is replaced, any other existing file makes the
+    //! start fail.
+    //! @param[in] handler Produces the metrics.
+    //! @return true if the server is listening, otherwise false.
+    //!
+    bool start(const std::string &address, const Handler &handler);
+
+    //! Stop serving and remove the socket file.
+    //!
+    void stop();
+
+    //! Check whether the server is listening.
+    //!
+    //! @return true if started, otherwise false.
+    //!
+    bool isRunning() const;
+
+    //! Get the number of requests answered.
+    //!
+    //! @return The number of requests.
+    //!
+    int getNumRequests() const;
+private:
+    // Make instances non-copyable.
+    MetricsServer(const MetricsServer &);
+    const MetricsServer &operator=(const MetricsServer &);
+
+    void run();
+    void serve(int connection);
+
+    Handler mHandler;
+    int mSocket;
+    std::string mPath;
+    std::thread mThread;
+    std::atomic<bool> mQuit;
+    std::atomic<int> mNumRequests;
+};
@@ -0,0 +1,222 @@
+//! @file    OffscreenContext.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for OffscreenContext.h
+//!
+
+#include "OffscreenContext.h"
+#include "MemoryRegistry.h"
+
+#include <iostream>
+#include <cstring>
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+#ifdef HAVE_EGL
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+bool hasExtension(EGLDisplay display, const char *name)
+{
+    const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions) {
+        return false;
+    }
+    size_t length = std::strlen(name);
+    for (const char *p = std::strstr(extensions, name); p; p = std::strstr(p + length, name)) {
+        if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns an initialized display of the Mesa surfaceless platform, or
+// EGL_NO_DISPLAY if it is not available
+EGLDisplay getSurfacelessDisplay()
+{
+    // Client extensions are queried without a display
+    if (!hasExtension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless") ||
+        !hasExtension(EGL_NO_DISPLAY, "EGL_EXT_platform_base")) {
+        return EGL_NO_DISPLAY;
+    }
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (!getPlatformDisplay) {
+        return EGL_NO_DISPLAY;
+    }
+    EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+        return EGL_NO_DISPLAY;
+    }
+    if (!hasExtension(display, "EGL_KHR_surfaceless_context")) {
+        eglTerminate(display);
+        return EGL_NO_DISPLAY;
+    }
+    return display;
+}
+#endif
+}
+
+OffscreenContext::OffscreenContext() :
+    mDisplay(0),
+    mContext(0),
+    mSurface(0),
+    mSurfaceless(false),
+    mFBO(0)
+{
+    mRenderbuffers[0] = 0;
+    mRenderbuffers[1] = 0;
+}
+
+OffscreenContext::~OffscreenContext()
+{
+    destroy();
+}
+
+bool OffscreenContext::create()
+{
+#ifdef HAVE_EGL
+    EGLDisplay display = getSurfacelessDisplay();
+    mSurfaceless = (display != EGL_NO_DISPLAY);
+    if (!mSurfaceless) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, NULL, NULL)) {
+            std::cerr << "Error: Could not initialize EGL display." << std::endl;
+            return false;
+        }
+    }
+    mDisplay = display;
+
+    // Nothing is drawn to the default framebuffer, so the config only
+    // needs to support desktop OpenGL (and pbuffers as a fallback)
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, mSurfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint numConfigs = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &numConfigs) || numConfigs == 0) {
+        std::cerr << "Error: No EGL config supports desktop OpenGL." << std::endl;
+        destroy();
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cerr << "Error: EGL does not support desktop OpenGL." << std::endl;
+        destroy();
+        return false;
+    }
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION_KHR, 3,
+        EGL_CONTEXT_MINOR_VERSION_KHR, 2,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK_KHR, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT_KHR,
+        EGL_CONTEXT_FLAGS_KHR, EGL_CONTEXT_OPENGL_FORWARD_COMPATIBLE_BIT_KHR,
+        EGL_NONE
+    };
+    mContext = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (mContext == EGL_NO_CONTEXT) {
+        std::cerr << "Error: Could not create an OpenGL 3.2 core context (EGL error 0x"
+                  << std::hex << eglGetError() << std::dec << ")." << std::endl;
+        mContext = 0;
+        destroy();
+        return false;
+    }
+
+    if (!mSurfaceless) {
+        const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+        mSurface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if (mSurface == EGL_NO_SURFACE) {
+            std::cerr << "Error: Could not create EGL pbuffer." << std::endl;
+            mSurface = 0;
+            destroy();
+            return false;
+        }
+    }
+    EGLSurface surface = mSurfaceless ? EGL_NO_SURFACE : (EGLSurface) mSurface;
+    if (!eglMakeCurrent(display, surface, surface, (EGLContext) mContext)) {
+        std::cerr << "Error: Could not make the EGL context current." << std::endl;
+        destroy();
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "Error: Built without EGL, offscreen rendering is not available." << std::endl;
+    return false;
+#endif
+}
+
+void OffscreenContext::destroy()
+{
+#ifdef HAVE_EGL
+    if (!mDisplay) {
+        return;
+    }
+    if (mFBO) {
+        glDeleteFramebuffers(1, &mFBO);
+        glDeleteRenderbuffers(2, mRenderbuffers);
+        mFBO = 0;
+        cgtk::MemoryRegistry::release(this);
+    }
+    eglMakeCurrent((EGLDisplay) mDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (mSurface) {
+        eglDestroySurface((EGLDisplay) mDisplay, (EGLSurface) mSurface);
+        mSurface = 0;
+    }
+    if (mContext) {
+        eglDestroyContext((EGLDisplay) mDisplay, (EGLContext) mContext);
+        mContext = 0;
+    }
+    eglTerminate((EGLDisplay) mDisplay);
+    mDisplay = 0;
+#endif
+}
+
+void OffscreenContext::resize(int width, int height)
+{
+    if (!mFBO) {
+        glGenFramebuffers(1, &mFBO);
+        glGenRenderbuffers(2, mRenderbuffers);
+    }
+    glBindRenderbuffer(GL_RENDERBUFFER, mRenderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, mRenderbuffers[1]);
+    // The stencil buffer counts the fragments of the overdraw heat map
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    // Four bytes per pixel for the color and for the depth and stencil
+    cgtk::MemoryRegistry::set(this, cgtk::MEMORY_RENDERBUFFER, "offscreen framebuffer", size_t(width) * height * 8);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, mRenderbuffers[0]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mRenderbuffers[1]);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Error: Offscreen framebuffer is incomplete." << std::endl;
+    }
+    glViewport(0, 0, width, height);
+}
+
+void OffscreenContext::bind() const
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, mFBO);
+}
+
+GLuint OffscreenContext::getFramebuffer() const
+{
+    return mFBO;
+}
+
+const char *OffscreenContext::getPlatformName() const
+{
+    if (!mDisplay) {
+        return "none";
+    }
+    return mSurfaceless ? "surfaceless" : "pbuffer";
+}
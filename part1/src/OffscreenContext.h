@@ -0,0 +1,77 @@
+//! @file    OffscreenContext.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the OffscreenContext class
+//!
+
+#pragma once
+
+#include <GL/glew.h>
+
+//! @class OffscreenContext OffscreenContext.h OffscreenContext.h
+//!
+//! @brief Windowless OpenGL 3.2 core profile context rendering into a
+//! framebuffer object.
+//!
+//! The context is created through EGL, so no X server or display is
+//! needed: on Mesa the surfaceless platform is used (which also runs on
+//! llvmpipe), elsewhere the default display with a 1x1 pbuffer. All
+//! rendering goes to an FBO with an RGBA8 color and a 24-bit depth,
+//! 8-bit stencil renderbuffer. Without EGL support at build time (HAVE_EGL undefined)
+//! create() always fails.
+//!
+class OffscreenContext {
+public:
+    //! Constructor
+    //!
+    OffscreenContext();
+
+    //! Destructor
+    //!
+    ~OffscreenContext();
+
+    //! Create the context and make it current. GL entry points must be
+    //! loaded (glewInit) before calling resize().
+    //!
+    //! @return true if the context was created, otherwise false.
+    //!
+    bool create();
+
+    //! Destroy the framebuffer and the context.
+    //!
+    void destroy();
+
+    //! (Re)create the framebuffer and bind it.
+    //!
+    //! @param[in] width Framebuffer width in pixels.
+    //! @param[in] height Framebuffer height in pixels.
+    //!
+    void resize(int width, int height);
+
+    //! Bind the framebuffer.
+    //!
+    void bind() const;
+
+    //! Get the framebuffer object.
+    //!
+    //! @return The framebuffer object name.
+    //!
+    GLuint getFramebuffer() const;
+
+    //! Get the name of the EGL platform that was used.
+    //!
+    //! @return "surfaceless", "pbuffer" or "none".
+    //!
+    const char *getPlatformName() const;
+private:
+    // Make instances non-copyable.
+    OffscreenContext(const OffscreenContext &);
+    const OffscreenContext &operator=(const OffscreenContext &);
+
+    void *mDisplay;
+    void *mContext;
+    void *mSurface;
+    bool mSurfaceless;
+    GLuint mFBO;
+    GLuint mRenderbuffers[2];
+};
@@ -0,0 +1,103 @@
+//! @file    OverdrawHeatMap.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for OverdrawHeatMap.h
+//!
+
+#include "OverdrawHeatMap.h"
+#include "DrawStats.h"
+
+#include <iostream>
+#include <algorithm>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// From no fragment over blue, cyan, green, yellow and red to white for
+// eight or more
+const glm::vec3 LEVEL_COLORS[] = {
+    glm::vec3(0.0f, 0.0f, 0.0f),
+    glm::vec3(0.0f, 0.0f, 0.6f),
+    glm::vec3(0.0f, 0.4f, 1.0f),
+    glm::vec3(0.0f, 0.8f, 0.8f),
+    glm::vec3(0.0f, 0.8f, 0.0f),
+    glm::vec3(0.9f, 0.9f, 0.0f),
+    glm::vec3(1.0f, 0.5f, 0.0f),
+    glm::vec3(1.0f, 0.0f, 0.0f),
+    glm::vec3(1.0f, 1.0f, 1.0f)
+};
+
+const int NUM_LEVELS = sizeof(LEVEL_COLORS) / sizeof(LEVEL_COLORS[0]) - 1;
+}
+
+OverdrawHeatMap::OverdrawHeatMap() :
+    mProgram(),
+    mEmptyVAO(0)
+{
+}
+
+OverdrawHeatMap::~OverdrawHeatMap()
+{
+    if (mEmptyVAO) {
+        glDeleteVertexArrays(1, &mEmptyVAO);
+    }
+}
+
+bool OverdrawHeatMap::init(const std::string &shaderDir)
+{
+    mProgram.setShaderSource(GL_VERTEX_SHADER, cgtk::readGLSLSource(shaderDir + "fullscreen.vert"));
+    mProgram.setShaderSource(GL_FRAGMENT_SHADER, cgtk::readGLSLSource(shaderDir + "edge_quad.frag"));
+    mProgram.setName("overdraw heat map");
+    mProgram.update();
+    if (!mProgram.isValid()) {
+        std::cerr << "Error: Could not create overdraw program." << std::endl;
+        return false;
+    }
+
+    // The fullscreen triangle is generated from gl_VertexID
+    glGenVertexArrays(1, &mEmptyVAO);
+
+    return true;
+}
+
+void OverdrawHeatMap::begin()
+{
+    glClearStencil(0);
+    glClear(GL_STENCIL_BUFFER_BIT);
+    glEnable(GL_STENCIL_TEST);
+    glStencilFunc(GL_ALWAYS, 0, 0xff);
+    glStencilOp(GL_KEEP, GL_INCR, GL_INCR);
+}
+
+void OverdrawHeatMap::end()
+{
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    glBindVertexArray(mEmptyVAO);
+    mProgram.enable();
+
+    // Each level covers the pixels with exactly its count, the last
+    // those with at least its count
+    for (int level = 0; level <= NUM_LEVELS; level++) {
+        glStencilFunc(level < NUM_LEVELS ? GL_EQUAL : GL_LEQUAL, level, 0xff);
+        mProgram.setUniform3f("outlineColor", LEVEL_COLORS[level]);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+        countDraw(3, 1);
+    }
+
+    mProgram.disable();
+    glBindVertexArray(0);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_BLEND);
+    glEnable(GL_DEPTH_TEST);
+}
+
+int OverdrawHeatMap::getNumLevels()
+{
+    return NUM_LEVELS;
+}
+
+glm::vec3 OverdrawHeatMap::getColor(int level)
+{
+    return LEVEL_COLORS[std::min(std::max(level, 0), NUM_LEVELS)];
+}
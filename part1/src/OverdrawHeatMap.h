@@ -0,0 +1,75 @@
+//! @file    OverdrawHeatMap.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the OverdrawHeatMap class
+//!
+
+#pragma once
+
+#include "GLSLProgram.h"
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+#include <string>
+
+//! @class OverdrawHeatMap OverdrawHeatMap.h OverdrawHeatMap.h
+//!
+//! @brief Shows how many fragments each pixel received as a heat map.
+//!
+//! Between begin() and end(), every fragment that reaches the depth
+//! test increments the stencil buffer of the bound framebuffer, whether
+//! it passes or not, so the count does not depend on the shaders of
+//! the passes. end() then replaces the image with the color of each
+//! count, one fullscreen pass per level of the scale. Fragments that
+//! the shaders discard are not counted. The framebuffer needs a stencil
+//! buffer.
+//!
+class OverdrawHeatMap {
+public:
+    //! Constructor
+    //!
+    OverdrawHeatMap();
+
+    //! Destructor
+    //!
+    ~OverdrawHeatMap();
+
+    //! Load the shaders and create the GL resources. Requires a
+    //! current OpenGL context.
+    //!
+    //! @param[in] shaderDir Directory containing the fullscreen.vert
+    //! and edge_quad.frag shaders.
+    //! @return true if the program was created, otherwise false.
+    //!
+    bool init(const std::string &shaderDir);
+
+    //! Clear the counts and start counting the fragments.
+    //!
+    void begin();
+
+    //! Stop counting and draw the heat map into the bound framebuffer.
+    //!
+    void end();
+
+    //! Get the number of levels of the color scale. The last level
+    //! stands for that many fragments or more.
+    //!
+    //! @return The number of levels, not counting zero.
+    //!
+    static int getNumLevels();
+
+    //! Get the color of a level of the scale.
+    //!
+    //! @param[in] level Number of fragments, from 0 to getNumLevels().
+    //! @return The color.
+    //!
+    static glm::vec3 getColor(int level);
+private:
+    // Make instances non-copyable.
+    OverdrawHeatMap(const OverdrawHeatMap &);
+    const OverdrawHeatMap &operator=(const OverdrawHeatMap &);
+
+    cgtk::GLSLProgram mProgram;
+    GLuint mEmptyVAO;
+};
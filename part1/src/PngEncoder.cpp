@@ -0,0 +1,792 @@
+//! @file    PngEncoder.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for PngEncoder.h
+//!
+
+#include "PngEncoder.h"
+#include "Trace.h"
+
+#include <zlib.h>
+
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+const unsigned char SIGNATURE[] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+// Size of the deflate window, the amount of preceding data used as the
+// dictionary of a band
+const size_t WINDOW_SIZE = 32768;
+
+const int COLOR_TYPE_RGB = 2;
+const int COLOR_TYPE_PALETTE = 3;
+
+// Everything that is known about a frame while it is encoded
+struct FrameData {
+    std::string filename;
+    std::vector<unsigned char> rgb;
+    int width;
+    int height;
+
+    // The rows that are filtered, either rgb or the packed palette
+    // indices
+    const unsigned char *rows;
+    std::vector<unsigned char> indices;
+    std::vector<unsigned char> palette;
+    int colorType;
+    int bitDepth;
+    size_t rowBytes;
+    int bytesPerPixel;
+    PngFilter filter;
+
+    int bandRows;
+    int numBands;
+    std::vector<std::vector<unsigned char> > bands;
+    std::vector<uLong> adlers;
+    std::vector<size_t> filteredSizes;
+    std::vector<double> times;
+    std::atomic<int> remaining;
+    std::atomic<bool> failed;
+
+    FrameData() : width(0), height(0), rows(0), colorType(COLOR_TYPE_RGB), bitDepth(8),
+        rowBytes(0), bytesPerPixel(3), filter(PNG_FILTER_NONE), bandRows(0), numBands(0),
+        remaining(0), failed(false)
+    {
+    }
+};
+
+// Builds the palette if the image has at most 256 colors and packs the
+// indices with the smallest bit depth
+bool buildPalette(FrameData &frame)
+{
+    // Open addressing table from color to index. Runs of equal colors
+    // are common, so the previous color is checked first.
+    const int TABLE_SIZE = 1024;
+    const uint32_t EMPTY = 0xffffffff;
+    std::vector<uint32_t> keys(TABLE_SIZE, EMPTY);
+    std::vector<unsigned char> values(TABLE_SIZE);
+    int numColors = 0;
+
+    size_t numPixels = size_t(frame.width) * frame.height;
+    std::vector<unsigned char> indices(numPixels);
+    uint32_t previousKey = EMPTY;
+    unsigned char previousIndex = 0;
+    for (size_t i = 0; i < numPixels; i++) {
+        const unsigned char *p = &frame.rgb[3 * i];
+        uint32_t key = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+        if (key != previousKey) {
+            uint32_t slot = (key * 2654435761u) >> 22;
+            while (keys[slot] != key && keys[slot] != EMPTY) {
+                slot = (slot + 1) & (TABLE_SIZE - 1);
+            }
+            if (keys[slot] == EMPTY) {
+                if (numColors == 256) {
+                    return false;
+                }
+                keys[slot] = key;
+                values[slot] = numColors++;
+                frame.palette.push_back(p[0]);
+                frame.palette.push_back(p[1]);
+                frame.palette.push_back(p[2]);
+            }
+            previousKey = key;
+            previousIndex = values[slot];
+        }
+        indices[i] = previousIndex;
+    }
+
+    frame.bitDepth = numColors <= 2 ? 1 : numColors <= 4 ? 2 : numColors <= 16 ? 4 : 8;
+    frame.rowBytes = (size_t(frame.width) * frame.bitDepth + 7) / 8;
+    frame.indices.assign(frame.rowBytes * frame.height, 0);
+    int pixelsPerByte = 8 / frame.bitDepth;
+    for (int y = 0; y < frame.height; y++) {
+        const unsigned char *src = &indices[size_t(y) * frame.width];
+        unsigned char *dst = &frame.indices[y * frame.rowBytes];
+        for (int x = 0; x < frame.width; x++) {
+            int shift = 8 - frame.bitDepth * (x % pixelsPerByte + 1);
+            dst[x / pixelsPerByte] |= src[x] << shift;
+        }
+    }
+    frame.rows = &frame.indices[0];
+    frame.colorType = COLOR_TYPE_PALETTE;
+    frame.bytesPerPixel = 1;
+    return true;
+}
+
+// Chooses the color type and splits the frame into bands
+void analyze(FrameData &frame, const PngSettings &settings, int maxBands)
+{
+    frame.filter = settings.filter;
+    if (!settings.palette || !buildPalette(frame)) {
+        frame.palette.clear();
+        frame.rows = &frame.rgb[0];
+        frame.colorType = COLOR_TYPE_RGB;
+        frame.bitDepth = 8;
+        frame.rowBytes = size_t(frame.width) * 3;
+        frame.bytesPerPixel = 3;
+    }
+    else {
+        // Filtering rarely pays off for indexed images
+        frame.filter = PNG_FILTER_NONE;
+    }
+
+    size_t filteredSize = (frame.rowBytes + 1) * frame.height;
+    int numBands = int(std::min<size_t>(maxBands, filteredSize / std::max(1, settings.minBandBytes)));
+    numBands = std::max(1, std::min(numBands, frame.height));
+    frame.bandRows = (frame.height + numBands - 1) / numBands;
+    frame.numBands = (frame.height + frame.bandRows - 1) / frame.bandRows;
+    frame.bands.resize(frame.numBands);
+    frame.adlers.resize(frame.numBands);
+    frame.filteredSizes.resize(frame.numBands);
+    frame.times.assign(frame.numBands + 1, 0.0);
+    frame.remaining = frame.numBands;
+}
+
+int paeth(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes the filter type and the filtered bytes of one row to out.
+// prev is NULL for the first row. The first pixel has no left
+// neighbor, so it is handled before the main loop of each filter.
+void applyFilter(int type, const unsigned char *row, const unsigned char *prev,
+                 size_t rowBytes, int bpp, unsigned char *out)
+{
+    out[0] = type;
+    out++;
+    size_t first = std::min(rowBytes, size_t(bpp));
+    if (!prev && (type == PNG_FILTER_UP || type == PNG_FILTER_PAETH)) {
+        // Without a row above, up is none and Paeth is sub
+        type = type == PNG_FILTER_UP ? PNG_FILTER_NONE : PNG_FILTER_SUB;
+    }
+    switch (type) {
+    case PNG_FILTER_SUB:
+        std::copy(row, row + first, out);
+        for (size_t i = first; i < rowBytes; i++) {
+            out[i] = row[i] - row[i - bpp];
+        }
+        break;
+    case PNG_FILTER_UP:
+        for (size_t i = 0; i < rowBytes; i++) {
+            out[i] = row[i] - prev[i];
+        }
+        break;
+    case PNG_FILTER_AVERAGE:
+        for (size_t i = 0; i < first; i++) {
+            out[i] = row[i] - (prev ? prev[i] : 0) / 2;
+        }
+        for (size_t i = first; i < rowBytes; i++) {
+            out[i] = row[i] - (row[i - bpp] + (prev ? prev[i] : 0)) / 2;
+        }
+        break;
+    case PNG_FILTER_PAETH:
+        for (size_t i = 0; i < first; i++) {
+            out[i] = row[i] - prev[i];
+        }
+        for (size_t i = first; i < rowBytes; i++) {
+            out[i] = row[i] - paeth(row[i - bpp], prev[i], prev[i - bpp]);
+        }
+        break;
+    default:
+        std::copy(row, row + rowBytes, out);
+        break;
+    }
+}
+
+// Filters one row, choosing the filter with the smallest sum of
+// absolute (signed) differences in adaptive mode
+void filterRow(PngFilter filter, const unsigned char *row, const unsigned char *prev,
+               size_t rowBytes, int bpp, unsigned char *out, std::vector<unsigned char> &scratch)
+{
+    if (filter != PNG_FILTER_ADAPTIVE) {
+        applyFilter(filter, row, prev, rowBytes, bpp, out);
+        return;
+    }
+
+    scratch.resize(rowBytes + 1);
+    long best = -1;
+    for (int type = PNG_FILTER_NONE; type <= PNG_FILTER_PAETH; type++) {
+        applyFilter(type, row, prev, rowBytes, bpp, &scratch[0]);
+        long sum = 0;
+        for (size_t i = 1; i <= rowBytes; i++) {
+            sum += std::abs((signed char) scratch[i]);
+        }
+        if (best < 0 || sum < best) {
+            best = sum;
+            std::copy(scratch.begin(), scratch.end(), out);
+        }
+    }
+}
+
+// Deflates data into a raw deflate stream primed with the dictionary.
+// Z_SYNC_FLUSH ends the stream on a byte boundary so that more can be
+// appended, Z_FINISH ends it with the final block.
+bool deflateData(const unsigned char *dictionary, size_t dictionarySize,
+                 const unsigned char *data, size_t dataSize, int level, int flush,
+                 std::vector<unsigned char> *out)
+{
+    z_stream stream;
+    stream.zalloc = Z_NULL;
+    stream.zfree = Z_NULL;
+    stream.opaque = Z_NULL;
+    if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    if (dictionarySize > 0) {
+        deflateSetDictionary(&stream, dictionary, dictionarySize);
+    }
+
+    out->resize(deflateBound(&stream, dataSize) + 64);
+    stream.next_in = const_cast<unsigned char *>(data);
+    stream.avail_in = dataSize;
+    stream.next_out = &(*out)[0];
+    stream.avail_out = out->size();
+    int result;
+    while ((result = deflate(&stream, flush)) == Z_OK && stream.avail_out == 0) {
+        size_t used = out->size();
+        out->resize(2 * used);
+        stream.next_out = &(*out)[used];
+        stream.avail_out = out->size() - used;
+    }
+    out->resize(stream.total_out);
+    deflateEnd(&stream);
+    return result == (flush == Z_FINISH ? Z_STREAM_END : Z_OK);
+}
+
+// Filters and deflates one band of rows into a raw deflate stream that
+// ends on a byte boundary (or with the final block for the last band)
+bool compressBand(FrameData &frame, int band, int level)
+{
+    int firstRow = band * frame.bandRows;
+    int endRow = std::min(frame.height, firstRow + frame.bandRows);
+    size_t lineSize = frame.rowBytes + 1;
+
+    // The rows preceding the band are filtered again for the dictionary
+    int dictionaryRows = std::min<int>(firstRow, (WINDOW_SIZE + lineSize - 1) / lineSize);
+    std::vector<unsigned char> filtered((endRow - firstRow + dictionaryRows) * lineSize);
+    std::vector<unsigned char> scratch;
+    for (int y = firstRow - dictionaryRows; y < endRow; y++) {
+        const unsigned char *row = frame.rows + y * frame.rowBytes;
+        filterRow(frame.filter, row, y > 0 ? row - frame.rowBytes : NULL, frame.rowBytes,
+                  frame.bytesPerPixel, &filtered[(y - firstRow + dictionaryRows) * lineSize], scratch);
+    }
+    size_t dictionarySize = std::min(WINDOW_SIZE, dictionaryRows * lineSize);
+    const unsigned char *data = &filtered[dictionaryRows * lineSize];
+    size_t dataSize = (endRow - firstRow) * lineSize;
+
+    int flush = band == frame.numBands - 1 ? Z_FINISH : Z_SYNC_FLUSH;
+    if (!deflateData(data - dictionarySize, dictionarySize, data, dataSize, level, flush,
+                     &frame.bands[band])) {
+        return false;
+    }
+
+    frame.adlers[band] = adler32(adler32(0, Z_NULL, 0), data, dataSize);
+    frame.filteredSizes[band] = dataSize;
+    return true;
+}
+
+void appendUint32(std::vector<unsigned char> *png, uint32_t value)
+{
+    png->push_back(value >> 24);
+    png->push_back(value >> 16);
+    png->push_back(value >> 8);
+    png->push_back(value);
+}
+
+// Appends a chunk made of the given pieces of data
+void appendChunk(std::vector<unsigned char> *png, const char *type,
+                 const std::vector<std::pair<const unsigned char *, size_t> > &pieces)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < pieces.size(); i++) {
+        length += pieces[i].second;
+    }
+    appendUint32(png, length);
+    size_t typeStart = png->size();
+    png->insert(png->end(), type, type + 4);
+    for (size_t i = 0; i < pieces.size(); i++) {
+        png->insert(png->end(), pieces[i].first, pieces[i].first + pieces[i].second);
+    }
+    uLong crc = crc32(crc32(0, Z_NULL, 0), &(*png)[typeStart], png->size() - typeStart);
+    appendUint32(png, crc);
+}
+
+// Writes the two byte zlib header matching the compression level
+void makeZlibHeader(int level, unsigned char *header)
+{
+    header[0] = 0x78;
+    int flevel = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+    header[1] = flevel << 6;
+    header[1] += 31 - (header[0] * 256 + header[1]) % 31;
+}
+
+// Builds the IHDR chunk data
+std::vector<unsigned char> makeHeader(int width, int height, int bitDepth, int colorType)
+{
+    std::vector<unsigned char> header;
+    appendUint32(&header, width);
+    appendUint32(&header, height);
+    header.push_back(bitDepth);
+    header.push_back(colorType);
+    header.push_back(0);  // deflate
+    header.push_back(0);  // adaptive filtering
+    header.push_back(0);  // no interlace
+    return header;
+}
+
+// Joins the compressed bands into a PNG file
+void assemble(const FrameData &frame, int level, std::vector<unsigned char> *png)
+{
+    png->assign(SIGNATURE, SIGNATURE + sizeof(SIGNATURE));
+
+    std::vector<unsigned char> header = makeHeader(frame.width, frame.height, frame.bitDepth, frame.colorType);
+    std::vector<std::pair<const unsigned char *, size_t> > pieces;
+    pieces.push_back(std::make_pair(&header[0], header.size()));
+    appendChunk(png, "IHDR", pieces);
+
+    if (frame.colorType == COLOR_TYPE_PALETTE) {
+        pieces.clear();
+        pieces.push_back(std::make_pair(&frame.palette[0], frame.palette.size()));
+        appendChunk(png, "PLTE", pieces);
+    }
+
+    // zlib header, and the Adler-32 of the whole stream combined from
+    // those of the bands
+    unsigned char zlibHeader[2];
+    makeZlibHeader(level, zlibHeader);
+    uLong adler = adler32(0, Z_NULL, 0);
+    for (int band = 0; band < frame.numBands; band++) {
+        adler = adler32_combine(adler, frame.adlers[band], frame.filteredSizes[band]);
+    }
+    std::vector<unsigned char> trailer;
+    appendUint32(&trailer, adler);
+
+    pieces.clear();
+    pieces.push_back(std::make_pair(zlibHeader, size_t(2)));
+    for (int band = 0; band < frame.numBands; band++) {
+        pieces.push_back(std::make_pair(frame.bands[band].data(), frame.bands[band].size()));
+    }
+    pieces.push_back(std::make_pair(&trailer[0], trailer.size()));
+    appendChunk(png, "IDAT", pieces);
+
+    pieces.clear();
+    appendChunk(png, "IEND", pieces);
+}
+
+bool writeFile(const std::string &filename, const std::vector<unsigned char> &data)
+{
+    FILE *file = std::fopen(filename.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    bool success = std::fwrite(&data[0], 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && success;
+}
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+struct PngEncoder::Frame : public FrameData {
+};
+
+PngEncoder::PngEncoder() :
+    mSettings(),
+    mThreads(),
+    mTasks(),
+    mNumInFlight(0),
+    mStopping(false)
+{
+    resetStatistics();
+}
+
+PngEncoder::~PngEncoder()
+{
+    stop();
+}
+
+void PngEncoder::start(const PngSettings &settings)
+{
+    stop();
+    mSettings = settings;
+    if (mSettings.numThreads <= 0) {
+        mSettings.numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    mSettings.queueSize = std::max(1, mSettings.queueSize);
+    mStopping = false;
+    for (int i = 0; i < mSettings.numThreads; i++) {
+        mThreads.push_back(std::thread(&PngEncoder::work, this));
+    }
+}
+
+void PngEncoder::stop()
+{
+    if (mThreads.empty()) {
+        return;
+    }
+    finish();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mTaskAvailable.notify_all();
+    for (size_t i = 0; i < mThreads.size(); i++) {
+        mThreads[i].join();
+    }
+    mThreads.clear();
+}
+
+void PngEncoder::submit(const std::string &filename, std::vector<unsigned char> &rgb, int width, int height)
+{
+    std::shared_ptr<Frame> frame(new Frame());
+    frame->filename = filename;
+    frame->rgb.swap(rgb);
+    frame->width = width;
+    frame->height = height;
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    if (mNumInFlight >= mSettings.queueSize) {
+        mNumQueueWaits++;
+        while (mNumInFlight >= mSettings.queueSize) {
+            mFrameDone.wait(lock);
+        }
+    }
+    mNumInFlight++;
+    Task task = { frame, -1 };
+    mTasks.push_back(task);
+    mTaskAvailable.notify_one();
+}
+
+void PngEncoder::finish()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mNumInFlight > 0) {
+        mFrameDone.wait(lock);
+    }
+}
+
+void PngEncoder::work()
+{
+    CGTK_TRACE_THREAD("png encoder");
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mTasks.empty() && !mStopping) {
+                mTaskAvailable.wait(lock);
+            }
+            if (mTasks.empty()) {
+                return;
+            }
+            task = mTasks.front();
+            mTasks.pop_front();
+        }
+        run(task);
+    }
+}
+
+void PngEncoder::run(const Task &task)
+{
+    CGTK_TRACE_SCOPE(task.band < 0 ? "png analyze" : "png band");
+    auto start = std::chrono::steady_clock::now();
+    Frame &frame = *task.frame;
+
+    if (task.band < 0) {
+        analyze(frame, mSettings, mSettings.numThreads);
+        frame.times[frame.numBands] = millisecondsSince(start);
+        // The bands go to the front of the queue, so that frames are
+        // completed in order rather than all started at once
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (int band = frame.numBands - 1; band >= 0; band--) {
+            Task bandTask = { task.frame, band };
+            mTasks.push_front(bandTask);
+        }
+        mTaskAvailable.notify_all();
+        return;
+    }
+
+    if (!compressBand(frame, task.band, mSettings.level)) {
+        frame.failed = true;
+    }
+    frame.times[task.band] = millisecondsSince(start);
+    if (--frame.remaining > 0) {
+        return;
+    }
+
+    // Last band of the frame
+    auto writeStart = std::chrono::steady_clock::now();
+    std::vector<unsigned char> png;
+    bool success = !frame.failed;
+    if (success) {
+        assemble(frame, mSettings.level, &png);
+        success = writeFile(frame.filename, png);
+    }
+    if (!success) {
+        std::cerr << "Error: Could not write " << frame.filename << std::endl;
+    }
+    double time = millisecondsSince(writeStart);
+    for (size_t i = 0; i < frame.times.size(); i++) {
+        time += frame.times[i];
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (success) {
+        mNumFrames++;
+        mNumPaletteFrames += frame.colorType == COLOR_TYPE_PALETTE;
+        mNumBytes += png.size();
+    }
+    else {
+        mNumErrors++;
+    }
+    mEncodeTime += time;
+    mNumInFlight--;
+    mFrameDone.notify_all();
+}
+
+bool PngEncoder::encode(const unsigned char *rgb, int width, int height,
+                        const PngSettings &settings, std::vector<unsigned char> *png)
+{
+    FrameData frame;
+    frame.rgb.assign(rgb, rgb + size_t(width) * height * 3);
+    frame.width = width;
+    frame.height = height;
+    analyze(frame, settings, 1);
+    if (!compressBand(frame, 0, settings.level)) {
+        return false;
+    }
+    assemble(frame, settings.level, png);
+    return true;
+}
+
+bool PngEncoder::parseFilter(const std::string &name, PngFilter *filter)
+{
+    const char *names[] = { "none", "sub", "up", "average", "paeth", "adaptive" };
+    for (int i = PNG_FILTER_NONE; i <= PNG_FILTER_ADAPTIVE; i++) {
+        if (name == names[i]) {
+            *filter = PngFilter(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+int PngEncoder::getNumFrames() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumFrames;
+}
+
+int PngEncoder::getNumPaletteFrames() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumPaletteFrames;
+}
+
+int PngEncoder::getNumErrors() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumErrors;
+}
+
+int PngEncoder::getNumQueueWaits() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumQueueWaits;
+}
+
+double PngEncoder::getNumBytes() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumBytes;
+}
+
+double PngEncoder::getEncodeTime() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEncodeTime;
+}
+
+void PngEncoder::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mNumFrames = 0;
+    mNumPaletteFrames = 0;
+    mNumErrors = 0;
+    mNumQueueWaits = 0;
+    mNumBytes = 0.0;
+    mEncodeTime = 0.0;
+}
+
+PngStreamWriter::PngStreamWriter() :
+    mFile(NULL),
+    mWidth(0),
+    mHeight(0),
+    mLevel(6),
+    mFilter(PNG_FILTER_ADAPTIVE),
+    mNumRows(0),
+    mFailed(false),
+    mThread(),
+    mAdler(0),
+    mNumBytes(0.0),
+    mEncodeTime(0.0)
+{
+}
+
+PngStreamWriter::~PngStreamWriter()
+{
+    if (mFile) {
+        close();
+    }
+}
+
+bool PngStreamWriter::open(const std::string &filename, int width, int height, int level, PngFilter filter)
+{
+    if (mFile) {
+        close();
+    }
+    mFile = std::fopen(filename.c_str(), "wb");
+    if (!mFile) {
+        return false;
+    }
+    mWidth = width;
+    mHeight = height;
+    mLevel = level;
+    mFilter = filter;
+    mNumRows = 0;
+    mFailed = false;
+    mBand.clear();
+    mPreviousRow.clear();
+    mDictionary.clear();
+    mCompressed.clear();
+    mAdler = adler32(0, Z_NULL, 0);
+    mNumBytes = 0.0;
+    mEncodeTime = 0.0;
+
+    mFailed = std::fwrite(SIGNATURE, 1, sizeof(SIGNATURE), mFile) != sizeof(SIGNATURE);
+    mNumBytes += sizeof(SIGNATURE);
+    std::vector<unsigned char> header = makeHeader(width, height, 8, COLOR_TYPE_RGB);
+    writeChunk("IHDR", &header[0], header.size());
+    return !mFailed;
+}
+
+void PngStreamWriter::writeRows(const unsigned char *rgb, int numRows)
+{
+    waitForBand();
+    mBand.assign(rgb, rgb + size_t(numRows) * mWidth * 3);
+    mNumRows += numRows;
+    mThread = std::thread(&PngStreamWriter::compress, this, int(Z_SYNC_FLUSH));
+}
+
+bool PngStreamWriter::close()
+{
+    if (!mFile) {
+        return false;
+    }
+    waitForBand();
+
+    // The final block is empty, followed by the Adler-32 of the stream
+    mBand.clear();
+    compress(Z_FINISH);
+    appendUint32(&mCompressed, mAdler);
+    writeChunk("IDAT", &mCompressed[0], mCompressed.size());
+    writeChunk("IEND", NULL, 0);
+
+    mFailed |= std::fclose(mFile) != 0;
+    mFile = NULL;
+    std::vector<unsigned char>().swap(mBand);
+    std::vector<unsigned char>().swap(mFiltered);
+    std::vector<unsigned char>().swap(mCompressed);
+    return !mFailed && mNumRows == mHeight;
+}
+
+double PngStreamWriter::getNumBytes() const
+{
+    return mNumBytes;
+}
+
+double PngStreamWriter::getEncodeTime() const
+{
+    return mEncodeTime;
+}
+
+void PngStreamWriter::compress(int flush)
+{
+    CGTK_TRACE_SCOPE("png stream compress");
+    auto start = std::chrono::steady_clock::now();
+    size_t rowBytes = size_t(mWidth) * 3;
+    size_t lineSize = rowBytes + 1;
+    size_t numRows = mBand.size() / rowBytes;
+    mFiltered.resize(numRows * lineSize);
+    std::vector<unsigned char> scratch;
+    for (size_t y = 0; y < numRows; y++) {
+        const unsigned char *row = &mBand[y * rowBytes];
+        const unsigned char *prev = y > 0 ? row - rowBytes : mPreviousRow.empty() ? NULL : &mPreviousRow[0];
+        filterRow(mFilter, row, prev, rowBytes, 3, &mFiltered[y * lineSize], scratch);
+    }
+
+    const unsigned char *data = mFiltered.empty() ? NULL : &mFiltered[0];
+    const unsigned char *dictionary = mDictionary.empty() ? NULL : &mDictionary[0];
+    if (!deflateData(dictionary, mDictionary.size(), data, mFiltered.size(), mLevel, flush, &mCompressed)) {
+        mFailed = true;
+    }
+    mAdler = adler32_combine(mAdler, adler32(adler32(0, Z_NULL, 0), data, mFiltered.size()), mFiltered.size());
+    if (mPreviousRow.empty() && flush != Z_FINISH) {
+        unsigned char zlibHeader[2];
+        makeZlibHeader(mLevel, zlibHeader);
+        mCompressed.insert(mCompressed.begin(), zlibHeader, zlibHeader + 2);
+    }
+
+    if (numRows > 0) {
+        mPreviousRow.assign(mBand.end() - rowBytes, mBand.end());
+        if (mFiltered.size() >= WINDOW_SIZE) {
+            mDictionary.assign(mFiltered.end() - WINDOW_SIZE, mFiltered.end());
+        }
+        else {
+            mDictionary.insert(mDictionary.end(), mFiltered.begin(), mFiltered.end());
+            if (mDictionary.size() > WINDOW_SIZE) {
+                mDictionary.erase(mDictionary.begin(), mDictionary.end() - WINDOW_SIZE);
+            }
+        }
+    }
+    mEncodeTime += millisecondsSince(start);
+}
+
+void PngStreamWriter::writeChunk(const char *type, const unsigned char *data, size_t size)
+{
+    std::vector<std::pair<const unsigned char *, size_t> > pieces;
+    if (size > 0) {
+        pieces.push_back(std::make_pair(data, size));
+    }
+    std::vector<unsigned char> chunk;
+    appendChunk(&chunk, type, pieces);
+    if (std::fwrite(&chunk[0], 1, chunk.size(), mFile) != chunk.size()) {
+        mFailed = true;
+    }
+    mNumBytes += chunk.size();
+}
+
+void PngStreamWriter::waitForBand()
+{
+    if (!mThread.joinable()) {
+        return;
+    }
+    mThread.join();
+    writeChunk("IDAT", &mCompressed[0], mCompressed.size());
+}
@@ -0,0 +1,278 @@
+//! @file    PngEncoder.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the PngEncoder class
+//!
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Row filters. The first five are the PNG filter types, adaptive picks
+// the one with the smallest sum of absolute differences for each row.
+enum PngFilter {
+    PNG_FILTER_NONE = 0,
+    PNG_FILTER_SUB = 1,
+    PNG_FILTER_UP = 2,
+    PNG_FILTER_AVERAGE = 3,
+    PNG_FILTER_PAETH = 4,
+    PNG_FILTER_ADAPTIVE = 5
+};
+
+// Parameters of the encoder
+struct PngSettings {
+    int level;
+    PngFilter filter;
+    bool palette;
+    int numThreads;
+    int queueSize;
+    int minBandBytes;
+
+    PngSettings()
+    {
+        level = 6;
+        filter = PNG_FILTER_ADAPTIVE;
+        palette = true;
+        numThreads = 0;
+        queueSize = 8;
+        minBandBytes = 256 * 1024;
+    }
+};
+
+//! @class PngEncoder PngEncoder.h PngEncoder.h
+//!
+//! @brief Writes PNG files from a pool of worker threads.
+//!
+//! submit() puts a frame in a bounded queue and only blocks when the
+//! queue is full. Every frame is encoded independently; large frames
+//! are additionally split into bands of rows that are filtered and
+//! deflated in parallel, each band primed with the preceding 32 KB as
+//! dictionary and ended with a sync flush so that the bands concatenate
+//! to a single valid zlib stream (as in pigz). Frames with at most 256
+//! distinct colors, which is typical for toon shading, are written as
+//! indexed images with the smallest possible bit depth.
+//!
+class PngEncoder {
+public:
+    //! Constructor
+    //!
+    PngEncoder();
+
+    //! Destructor. Waits for the submitted frames.
+    //!
+    ~PngEncoder();
+
+    //! Start the worker threads.
+    //!
+    //! @param[in] settings Encoder settings. numThreads = 0 uses one
+    //! thread per core.
+    //!
+    void start(const PngSettings &settings);
+
+    //! Wait for the submitted frames and stop the worker threads.
+    //!
+    void stop();
+
+    //! Queue a frame for encoding. Blocks while the queue is full.
+    //!
+    //! @param[in] filename Name of the PNG file to write.
+    //! @param[in,out] rgb Tightly packed RGB rows, top row first. The
+    //! contents are taken over and rgb is left empty.
+    //! @param[in] width Image width.
+    //! @param[in] height Image height.
+    //!
+    void submit(const std::string &filename, std::vector<unsigned char> &rgb, int width, int height);
+
+    //! Wait until all submitted frames have been written.
+    //!
+    void finish();
+
+    //! Encode an image on the calling thread.
+    //!
+    //! @param[in] rgb Tightly packed RGB rows, top row first.
+    //! @param[in] width Image width.
+    //! @param[in] height Image height.
+    //! @param[in] settings Encoder settings (the thread count and queue
+    //! size are ignored).
+    //! @param[out] png The PNG file contents.
+    //! @return true on success, otherwise false.
+    //!
+    static bool encode(const unsigned char *rgb, int width, int height,
+                       const PngSettings &settings, std::vector<unsigned char> *png);
+
+    //! Parse a filter name (none, sub, up, average, paeth or adaptive).
+    //!
+    //! @param[in] name The filter name.
+    //! @param[out] filter The filter.
+    //! @return true if the name is valid, otherwise false.
+    //!
+    static bool parseFilter(const std::string &name, PngFilter *filter);
+
+    //! Get the number of frames written.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumFrames() const;
+
+    //! Get the number of frames written as indexed images.
+    //!
+    //! @return The number of indexed frames.
+    //!
+    int getNumPaletteFrames() const;
+
+    //! Get the number of frames that could not be written.
+    //!
+    //! @return The number of errors.
+    //!
+    int getNumErrors() const;
+
+    //! Get the number of times submit() blocked on a full queue.
+    //!
+    //! @return The number of waits.
+    //!
+    int getNumQueueWaits() const;
+
+    //! Get the total size of the written files.
+    //!
+    //! @return Size in bytes.
+    //!
+    double getNumBytes() const;
+
+    //! Get the worker time spent encoding, summed over all threads.
+    //!
+    //! @return Time in milliseconds.
+    //!
+    double getEncodeTime() const;
+
+    //! Reset the counters.
+    //!
+    void resetStatistics();
+private:
+    // Make instances non-copyable.
+    PngEncoder(const PngEncoder &);
+    const PngEncoder &operator=(const PngEncoder &);
+
+    struct Frame;
+
+    // A frame is first analyzed (band -1) and then its bands are
+    // compressed. The worker finishing the last band writes the file.
+    struct Task {
+        std::shared_ptr<Frame> frame;
+        int band;
+    };
+
+    void work();
+    void run(const Task &task);
+
+    PngSettings mSettings;
+    std::vector<std::thread> mThreads;
+    std::deque<Task> mTasks;
+    mutable std::mutex mMutex;
+    std::condition_variable mTaskAvailable;
+    std::condition_variable mFrameDone;
+    int mNumInFlight;
+    bool mStopping;
+
+    int mNumFrames;
+    int mNumPaletteFrames;
+    int mNumErrors;
+    int mNumQueueWaits;
+    double mNumBytes;
+    double mEncodeTime;
+};
+
+//! @class PngStreamWriter PngEncoder.h PngEncoder.h
+//!
+//! @brief Writes an RGB PNG file band by band, for images too large to
+//! hold in memory.
+//!
+//! Each band of rows is filtered and deflated on a background thread
+//! while the caller produces the next one, and written as its own IDAT
+//! chunk. The bands form one zlib stream: each is primed with the last
+//! 32 KB of the previous one and ended with a sync flush. Memory use is
+//! bounded by a few bands. Since the colors are not known up front, the
+//! file is never written as an indexed image.
+//!
+class PngStreamWriter {
+public:
+    //! Constructor
+    //!
+    PngStreamWriter();
+
+    //! Destructor. Closes the file.
+    //!
+    ~PngStreamWriter();
+
+    //! Create the file and write the header.
+    //!
+    //! @param[in] filename Name of the PNG file.
+    //! @param[in] width Image width.
+    //! @param[in] height Image height.
+    //! @param[in] level Compression level.
+    //! @param[in] filter Row filter.
+    //! @return true if the file was created, otherwise false.
+    //!
+    bool open(const std::string &filename, int width, int height, int level, PngFilter filter);
+
+    //! Queue the next band of rows. Waits for the previous band.
+    //!
+    //! @param[in] rgb Tightly packed RGB rows, top row first. The rows
+    //! are copied, so the buffer can be reused right away.
+    //! @param[in] numRows Number of rows.
+    //!
+    void writeRows(const unsigned char *rgb, int numRows);
+
+    //! Write the remaining bands and finish the file.
+    //!
+    //! @return true if the whole file was written, otherwise false.
+    //!
+    bool close();
+
+    //! Get the number of bytes written.
+    //!
+    //! @return Size in bytes.
+    //!
+    double getNumBytes() const;
+
+    //! Get the time spent filtering and deflating.
+    //!
+    //! @return Time in milliseconds.
+    //!
+    double getEncodeTime() const;
+private:
+    // Make instances non-copyable.
+    PngStreamWriter(const PngStreamWriter &);
+    const PngStreamWriter &operator=(const PngStreamWriter &);
+
+    void compress(int flush);
+    void writeChunk(const char *type, const unsigned char *data, size_t size);
+    void waitForBand();
+
+    FILE *mFile;
+    int mWidth;
+    int mHeight;
+    int mLevel;
+    PngFilter mFilter;
+    int mNumRows;
+    bool mFailed;
+
+    // The band being compressed, the last row and the last 32 KB of
+    // filtered data of the previous band, and the compressed output
+    std::thread mThread;
+    std::vector<unsigned char> mBand;
+    std::vector<unsigned char> mPreviousRow;
+    std::vector<unsigned char> mDictionary;
+    std::vector<unsigned char> mFiltered;
+    std::vector<unsigned char> mCompressed;
+    unsigned long mAdler;
+
+    double mNumBytes;
+    double mEncodeTime;
+};
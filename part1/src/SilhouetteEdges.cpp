@@ -0,0 +1,406 @@
+//! @file    SilhouetteEdges.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for SilhouetteEdges.h
+//!
+
+#include "SilhouetteEdges.h"
+
+#include <glm/gtx/constants.hpp>
+
+#include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Number of edges tested individually at the bottom of the hierarchy
+const uint32_t LEAF_SIZE = 32;
+
+struct PendingNode {
+    int32_t index;
+    int32_t parent;
+    bool right;
+};
+
+struct AdjacentEdge {
+    uint32_t v0;
+    uint32_t v1;
+    glm::vec3 n0;
+    glm::vec3 n1;
+    int numFaces;
+};
+
+uint64_t edgeKey(uint32_t a, uint32_t b)
+{
+    return a < b ? (uint64_t(a) << 32) | b : (uint64_t(b) << 32) | a;
+}
+
+glm::vec3 faceNormal(glm::vec3 p0, glm::vec3 p1, glm::vec3 p2)
+{
+    glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+    float length = glm::length(normal);
+    return length > 0.0f ? normal / length : glm::vec3(0.0f);
+}
+
+// Maps a unit vector to [0,1]^2 with an octahedral projection
+glm::vec2 octahedralMap(glm::vec3 n)
+{
+    n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    glm::vec2 p(n.x, n.y);
+    if (n.z < 0.0f) {
+        p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) *
+            glm::vec2(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+    }
+    return 0.5f * p + 0.5f;
+}
+
+// Interleaves 6 bits of each of the five coordinates (normal direction
+// first, then position), so that edges that are close both in space
+// and in orientation end up close along the sorted order
+uint32_t clusterKey(glm::vec3 p, glm::vec3 n, glm::vec3 minCorner, glm::vec3 extent)
+{
+    glm::vec3 t = glm::clamp((p - minCorner) / extent, 0.0f, 1.0f) * 63.0f;
+    glm::vec2 o = glm::clamp(octahedralMap(n), 0.0f, 1.0f) * 63.0f;
+    uint32_t coords[5] = { uint32_t(o.x), uint32_t(o.y),
+                           uint32_t(t.x), uint32_t(t.y), uint32_t(t.z) };
+    uint32_t key = 0;
+    for (int bit = 5; bit >= 0; bit--) {
+        for (int i = 0; i < 5; i++) {
+            key = (key << 1) | ((coords[i] >> bit) & 1);
+        }
+    }
+    return key;
+}
+
+float angleBetween(glm::vec3 a, glm::vec3 b)
+{
+    return std::acos(glm::clamp(glm::dot(a, b), -1.0f, 1.0f));
+}
+
+// Facing of both faces, as seen from the eye, differs
+bool isSilhouette(glm::vec3 p0, glm::vec3 n0, glm::vec3 n1, glm::vec3 eye)
+{
+    glm::vec3 view = eye - p0;
+    return (glm::dot(n0, view) > 0.0f) != (glm::dot(n1, view) > 0.0f);
+}
+}
+
+SilhouetteEdges::SilhouetteEdges() :
+    mEdges(),
+    mFeatureEdges(),
+    mNodes(),
+    mNumTestedEdges(0),
+    mNumVisitedNodes(0)
+{
+}
+
+SilhouetteEdges::~SilhouetteEdges()
+{
+}
+
+void SilhouetteEdges::build(std::vector<glm::vec3> const &vertices,
+                            std::vector<uint32_t> const &indices,
+                            float creaseAngle)
+{
+    mEdges.clear();
+    mFeatureEdges.clear();
+    mNodes.clear();
+
+    // Build the edge adjacency: every unique edge with the normals of
+    // the (up to) two faces sharing it
+    std::vector<AdjacentEdge> adjacency;
+    adjacency.reserve(indices.size() / 2);
+    std::unordered_map<uint64_t, uint32_t> edgeMap;
+    edgeMap.reserve(indices.size() / 2);
+    int numIndices = indices.size();
+    for (int i = 0; i + 2 < numIndices; i += 3) {
+        glm::vec3 normal = faceNormal(vertices[indices[i]],
+                                      vertices[indices[i + 1]],
+                                      vertices[indices[i + 2]]);
+        for (int k = 0; k < 3; k++) {
+            uint32_t a = indices[i + k];
+            uint32_t b = indices[i + (k + 1) % 3];
+            auto inserted = edgeMap.insert(std::make_pair(edgeKey(a, b), uint32_t(adjacency.size())));
+            if (inserted.second) {
+                AdjacentEdge edge = { a, b, normal, normal, 1 };
+                adjacency.push_back(edge);
+            }
+            else {
+                AdjacentEdge &edge = adjacency[inserted.first->second];
+                edge.n1 = normal;
+                edge.numFaces++;
+            }
+        }
+    }
+
+    // Boundary, non-manifold and crease edges are view independent
+    float creaseCos = std::cos(glm::radians(creaseAngle));
+    for (auto it = adjacency.begin(); it != adjacency.end(); ++it) {
+        Edge edge = { it->v0, it->v1, vertices[it->v0], it->n0, it->n1 };
+        if (it->numFaces != 2 || glm::dot(it->n0, it->n1) < creaseCos) {
+            mFeatureEdges.push_back(edge);
+        }
+        else {
+            mEdges.push_back(edge);
+        }
+    }
+    if (mEdges.empty()) {
+        return;
+    }
+
+    // Sort the candidate edges by position and orientation so that each
+    // leaf covers a compact region with a narrow normal cone
+    glm::vec3 minCorner = mEdges[0].p0;
+    glm::vec3 maxCorner = mEdges[0].p0;
+    for (auto it = mEdges.begin(); it != mEdges.end(); ++it) {
+        minCorner = glm::min(minCorner, it->p0);
+        maxCorner = glm::max(maxCorner, it->p0);
+    }
+    glm::vec3 extent = glm::max(maxCorner - minCorner, glm::vec3(1e-6f));
+    std::vector<std::pair<uint32_t, uint32_t> > codes(mEdges.size());
+    for (size_t i = 0; i < mEdges.size(); i++) {
+        glm::vec3 normal = mEdges[i].n0 + mEdges[i].n1;
+        float length = glm::length(normal);
+        normal = length > 1e-6f ? normal / length : glm::vec3(0.0f, 0.0f, 1.0f);
+        codes[i] = std::make_pair(clusterKey(mEdges[i].p0, normal, minCorner, extent), uint32_t(i));
+    }
+    std::sort(codes.begin(), codes.end());
+    std::vector<Edge> sorted(mEdges.size());
+    for (size_t i = 0; i < codes.size(); i++) {
+        sorted[i] = mEdges[codes[i].second];
+    }
+    mEdges.swap(sorted);
+
+    // Create the leaves with the cone bounding their face normals
+    std::vector<int32_t> level;
+    uint32_t numEdges = mEdges.size();
+    for (uint32_t first = 0; first < numEdges; first += LEAF_SIZE) {
+        Node node = Node();
+        node.first = first;
+        node.count = std::min(LEAF_SIZE, numEdges - first);
+        node.left = -1;
+        node.right = -1;
+
+        glm::vec3 sum(0.0f);
+        for (uint32_t i = first; i < first + node.count; i++) {
+            sum += mEdges[i].n0 + mEdges[i].n1;
+        }
+        float sumLength = glm::length(sum);
+        node.axis = sumLength > 1e-6f ? sum / sumLength : glm::vec3(0.0f, 0.0f, 1.0f);
+        node.angle = sumLength > 1e-6f ? 0.0f : glm::pi<float>();
+        for (uint32_t i = first; i < first + node.count; i++) {
+            node.angle = std::max(node.angle, angleBetween(node.axis, mEdges[i].n0));
+            node.angle = std::max(node.angle, angleBetween(node.axis, mEdges[i].n1));
+        }
+
+        level.push_back(mNodes.size());
+        mNodes.push_back(node);
+    }
+
+    // Merge pairs of neighbouring nodes until only the root is left.
+    // Edge ranges of siblings are adjacent, so the parent range is
+    // simply their union.
+    while (level.size() > 1) {
+        std::vector<int32_t> parents;
+        for (size_t i = 0; i < level.size(); i += 2) {
+            if (i + 1 == level.size()) {
+                parents.push_back(level[i]);
+                continue;
+            }
+            const Node &a = mNodes[level[i]];
+            const Node &b = mNodes[level[i + 1]];
+            Node node = Node();
+            node.first = a.first;
+            node.count = a.count + b.count;
+            node.left = level[i];
+            node.right = level[i + 1];
+
+            glm::vec3 sum = a.axis + b.axis;
+            float sumLength = glm::length(sum);
+            if (sumLength > 1e-6f && a.angle < glm::pi<float>() && b.angle < glm::pi<float>()) {
+                node.axis = sum / sumLength;
+                node.angle = std::max(angleBetween(node.axis, a.axis) + a.angle,
+                                      angleBetween(node.axis, b.axis) + b.angle);
+                node.angle = std::min(node.angle, glm::pi<float>());
+            }
+            else {
+                node.axis = glm::vec3(0.0f, 0.0f, 1.0f);
+                node.angle = glm::pi<float>();
+            }
+
+            parents.push_back(mNodes.size());
+            mNodes.push_back(node);
+        }
+        level.swap(parents);
+    }
+
+    // Anchor the front- and back-facing cones of every node (Shirman
+    // and Abi-Ezzi). With all normals n within alpha of the axis a, every
+    // eye position inside the cone with half-angle 90 - alpha around a
+    // sees a face through p as front-facing as long as the apex q
+    // satisfies dot(n, q - p) >= 0. Moving the apex along the axis by
+    // max(dot(n, p - c) / dot(n, a)) from a reference point c fulfills
+    // this for every face of the node, likewise for the back-facing
+    // cone around -a.
+    for (auto it = mNodes.begin(); it != mNodes.end(); ++it) {
+        Node &node = *it;
+        if (node.angle >= 0.5f * glm::pi<float>() - 1e-3f) {
+            // sin^2 > 1 can never be satisfied, so the node is always
+            // traversed
+            node.sinSqAngle = 2.0f;
+            node.frontApex = glm::vec3(0.0f);
+            node.backApex = glm::vec3(0.0f);
+            continue;
+        }
+        float sinAngle = std::sin(node.angle);
+        node.sinSqAngle = sinAngle * sinAngle;
+
+        glm::vec3 center(0.0f);
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            center += mEdges[i].p0;
+        }
+        center /= float(node.count);
+
+        float frontOffset = -FLT_MAX;
+        float backOffset = -FLT_MAX;
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+            const Edge &edge = mEdges[i];
+            glm::vec3 toPoint = edge.p0 - center;
+            float d0 = glm::dot(edge.n0, toPoint) / glm::dot(edge.n0, node.axis);
+            float d1 = glm::dot(edge.n1, toPoint) / glm::dot(edge.n1, node.axis);
+            frontOffset = std::max(frontOffset, std::max(d0, d1));
+            backOffset = std::max(backOffset, -std::min(d0, d1));
+        }
+        node.frontApex = center + frontOffset * node.axis;
+        node.backApex = center - backOffset * node.axis;
+    }
+
+    // Store the nodes in depth-first order with the root first, so that
+    // the traversal mostly walks forward in memory
+    std::vector<Node> ordered;
+    ordered.reserve(mNodes.size());
+    std::vector<PendingNode> pending;
+    PendingNode root = { int32_t(mNodes.size()) - 1, -1, false };
+    pending.push_back(root);
+    while (!pending.empty()) {
+        PendingNode current = pending.back();
+        pending.pop_back();
+        int32_t slot = ordered.size();
+        ordered.push_back(mNodes[current.index]);
+        if (current.parent >= 0) {
+            if (current.right) {
+                ordered[current.parent].right = slot;
+            }
+            else {
+                ordered[current.parent].left = slot;
+            }
+        }
+        const Node &node = mNodes[current.index];
+        if (node.left >= 0) {
+            PendingNode right = { node.right, slot, true };
+            PendingNode left = { node.left, slot, false };
+            pending.push_back(right);
+            pending.push_back(left);
+        }
+    }
+    mNodes.swap(ordered);
+}
+
+void SilhouetteEdges::extract(glm::vec3 eye, std::vector<uint32_t> &lines)
+{
+    lines.clear();
+    appendFeatureEdges(lines);
+    mNumTestedEdges = 0;
+    mNumVisitedNodes = 0;
+    if (mNodes.empty()) {
+        return;
+    }
+
+    int32_t stack[64];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node &node = mNodes[stack[--top]];
+        mNumVisitedNodes++;
+
+        // Skip the node if the eye lies inside its front-facing or its
+        // back-facing cone. Comparing squared cosines avoids any square
+        // roots or divisions in the traversal.
+        glm::vec3 toFront = eye - node.frontApex;
+        float front = glm::dot(toFront, node.axis);
+        if (front > 0.0f && front * front > node.sinSqAngle * glm::dot(toFront, toFront)) {
+            continue;
+        }
+        glm::vec3 toBack = eye - node.backApex;
+        float back = -glm::dot(toBack, node.axis);
+        if (back > 0.0f && back * back > node.sinSqAngle * glm::dot(toBack, toBack)) {
+            continue;
+        }
+
+        if (node.left < 0) {
+            testEdges(node.first, node.count, eye, lines);
+        }
+        else {
+            stack[top++] = node.right;
+            stack[top++] = node.left;
+        }
+    }
+}
+
+void SilhouetteEdges::extractBruteForce(glm::vec3 eye, std::vector<uint32_t> &lines)
+{
+    lines.clear();
+    appendFeatureEdges(lines);
+    mNumTestedEdges = 0;
+    mNumVisitedNodes = 0;
+    testEdges(0, mEdges.size(), eye, lines);
+}
+
+int SilhouetteEdges::getNumEdges() const
+{
+    return mEdges.size() + mFeatureEdges.size();
+}
+
+int SilhouetteEdges::getNumFeatureEdges() const
+{
+    return mFeatureEdges.size();
+}
+
+int SilhouetteEdges::getNumTestedEdges() const
+{
+    return mNumTestedEdges;
+}
+
+int SilhouetteEdges::getNumVisitedNodes() const
+{
+    return mNumVisitedNodes;
+}
+
+void SilhouetteEdges::appendFeatureEdges(std::vector<uint32_t> &lines) const
+{
+    for (auto it = mFeatureEdges.begin(); it != mFeatureEdges.end(); ++it) {
+        lines.push_back(it->v0);
+        lines.push_back(it->v1);
+    }
+}
+
+void SilhouetteEdges::testEdges(uint32_t first, uint32_t count, glm::vec3 eye,
+                                std::vector<uint32_t> &lines)
+{
+    // Silhouette edges are sparse and unpredictable, so every edge is
+    // written and the output only advances past the silhouettes. This
+    // avoids a mispredicted branch per silhouette edge.
+    size_t size = lines.size();
+    lines.resize(size + 2 * count);
+    uint32_t *out = lines.data() + size;
+    for (uint32_t i = first; i < first + count; i++) {
+        const Edge &edge = mEdges[i];
+        out[0] = edge.v0;
+        out[1] = edge.v1;
+        out += 2 * isSilhouette(edge.p0, edge.n0, edge.n1, eye);
+    }
+    lines.resize(out - lines.data());
+    mNumTestedEdges += count;
+}
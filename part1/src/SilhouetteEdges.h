@@ -0,0 +1,120 @@
+//! @file    SilhouetteEdges.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the SilhouetteEdges class
+//!
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <stdint.h>
+#include <vector>
+
+//! @class SilhouetteEdges SilhouetteEdges.h SilhouetteEdges.h
+//!
+//! @brief Object-space silhouette and crease edge extraction.
+//!
+//! Builds an edge-adjacency structure (each edge with the normals of
+//! its two faces) from an indexed triangle mesh. Boundary, non-manifold
+//! and crease edges are classified once as feature edges. The remaining
+//! edges are clustered by position and orientation into a binary
+//! hierarchy where each node stores a cone bounding its face normals
+//! together with the anchored cones of eye positions from which all of
+//! its faces are front- or back-facing. Whole clusters can thereby be
+//! skipped when searching for the silhouette of a given eye position.
+//!
+class SilhouetteEdges {
+public:
+    //! Constructor
+    //!
+    SilhouetteEdges();
+
+    //! Destructor
+    //!
+    ~SilhouetteEdges();
+
+    //! Build the edge adjacency and the normal cone hierarchy.
+    //!
+    //! @param[in] vertices The vertices of the mesh.
+    //! @param[in] indices The triangle indices of the mesh.
+    //! @param[in] creaseAngle Dihedral angle (in degrees) above which
+    //! an edge is always drawn as a crease.
+    //!
+    void build(std::vector<glm::vec3> const &vertices,
+               std::vector<uint32_t> const &indices,
+               float creaseAngle);
+
+    //! Find the silhouette edges using the normal cone hierarchy.
+    //!
+    //! @param[in] eye The eye position in object space.
+    //! @param[out] lines Vertex index pairs of the feature edges
+    //! followed by the silhouette edges.
+    //!
+    void extract(glm::vec3 eye, std::vector<uint32_t> &lines);
+
+    //! Find the silhouette edges by testing every edge. Produces the
+    //! same set of edges as extract().
+    //!
+    //! @param[in] eye The eye position in object space.
+    //! @param[out] lines Vertex index pairs of the feature edges
+    //! followed by the silhouette edges.
+    //!
+    void extractBruteForce(glm::vec3 eye, std::vector<uint32_t> &lines);
+
+    //! Get the number of unique edges in the mesh.
+    //!
+    //! @return The number of edges.
+    //!
+    int getNumEdges() const;
+
+    //! Get the number of boundary, non-manifold and crease edges.
+    //!
+    //! @return The number of feature edges.
+    //!
+    int getNumFeatureEdges() const;
+
+    //! Get the number of edges that were tested individually by the
+    //! last extraction.
+    //!
+    //! @return The number of tested edges.
+    //!
+    int getNumTestedEdges() const;
+
+    //! Get the number of hierarchy nodes visited by the last
+    //! extraction.
+    //!
+    //! @return The number of visited nodes.
+    //!
+    int getNumVisitedNodes() const;
+private:
+    struct Edge {
+        uint32_t v0;
+        uint32_t v1;
+        glm::vec3 p0;  // position of v0, shared by both faces
+        glm::vec3 n0;
+        glm::vec3 n1;
+    };
+
+    struct Node {
+        glm::vec3 axis;
+        float sinSqAngle;  // squared sine of the normal cone half-angle
+        glm::vec3 frontApex;
+        uint32_t first;
+        glm::vec3 backApex;
+        uint32_t count;
+        int32_t left;
+        int32_t right;
+        float angle;       // half-angle of the normal cone in radians
+    };
+
+    void appendFeatureEdges(std::vector<uint32_t> &lines) const;
+    void testEdges(uint32_t first, uint32_t count, glm::vec3 eye,
+                   std::vector<uint32_t> &lines);
+
+    std::vector<Edge> mEdges;
+    std::vector<Edge> mFeatureEdges;
+    std::vector<Node> mNodes;
+    int mNumTestedEdges;
+    int mNumVisitedNodes;
+};
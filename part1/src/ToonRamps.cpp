@@ -0,0 +1,118 @@
+//! @file    ToonRamps.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for ToonRamps.h
+//!
+
+#include "ToonRamps.h"
+#include "MemoryRegistry.h"
+
+#include <cmath>
+#include <algorithm>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+// Texels per ramp. With nearest filtering a band boundary is off by
+// at most 1/RAMP_WIDTH of the diffuse term.
+const int RAMP_WIDTH = 256;
+
+bool operator!=(const ToonStyle &a, const ToonStyle &b)
+{
+    return a.ambientColor != b.ambientColor || a.diffuseColor != b.diffuseColor ||
+           a.material_kd != b.material_kd || a.colorlvl != b.colorlvl;
+}
+
+uint8_t toByte(float value)
+{
+    return uint8_t(glm::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+// Same banding as mesh.frag used to compute per fragment
+void generateRamp(const ToonStyle &style, uint8_t *texels)
+{
+    int levels = std::max(1, style.colorlvl);
+    for (int i = 0; i < RAMP_WIDTH; i++) {
+        float diffuse = (i + 0.5f) / RAMP_WIDTH;
+        float band = std::floor(diffuse * levels) / levels;
+        glm::vec3 color = style.ambientColor + style.diffuseColor * style.material_kd * band;
+        texels[4 * i + 0] = toByte(color.r);
+        texels[4 * i + 1] = toByte(color.g);
+        texels[4 * i + 2] = toByte(color.b);
+        texels[4 * i + 3] = 255;
+    }
+}
+}
+
+ToonRamps::ToonRamps() :
+    mStyles(),
+    mTexels(),
+    mDirty(),
+    mTexture(0)
+{
+}
+
+ToonRamps::~ToonRamps()
+{
+    if (mTexture) {
+        glDeleteTextures(1, &mTexture);
+    }
+    cgtk::MemoryRegistry::release(this);
+}
+
+void ToonRamps::init(int numRamps)
+{
+    ToonStyle black = { glm::vec3(0.0f), glm::vec3(0.0f), 0.0f, 1 };
+    mStyles.assign(numRamps, black);
+    mTexels.assign(numRamps * RAMP_WIDTH * 4, 0);
+    mDirty.assign(numRamps, false);
+    for (int i = 0; i < numRamps; i++) {
+        generateRamp(mStyles[i], &mTexels[i * RAMP_WIDTH * 4]);
+    }
+
+    glGenTextures(1, &mTexture);
+    glBindTexture(GL_TEXTURE_1D_ARRAY, mTexture);
+    glTexImage2D(GL_TEXTURE_1D_ARRAY, 0, GL_RGBA8, RAMP_WIDTH, numRamps, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, mTexels.data());
+    glTexParameteri(GL_TEXTURE_1D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_1D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_1D_ARRAY, 0);
+    cgtk::MemoryRegistry::set(this, cgtk::MEMORY_TEXTURE, "toon ramps", size_t(RAMP_WIDTH) * numRamps * 4);
+}
+
+void ToonRamps::setStyle(int index, const ToonStyle &style)
+{
+    if (mStyles[index] != style) {
+        mStyles[index] = style;
+        generateRamp(style, &mTexels[index * RAMP_WIDTH * 4]);
+        mDirty[index] = true;
+    }
+}
+
+int ToonRamps::upload()
+{
+    int numUploaded = 0;
+    glBindTexture(GL_TEXTURE_1D_ARRAY, mTexture);
+    for (size_t i = 0; i < mDirty.size(); i++) {
+        if (mDirty[i]) {
+            // For 1D array textures the y offset selects the layer
+            glTexSubImage2D(GL_TEXTURE_1D_ARRAY, 0, 0, i, RAMP_WIDTH, 1,
+                            GL_RGBA, GL_UNSIGNED_BYTE, &mTexels[i * RAMP_WIDTH * 4]);
+            mDirty[i] = false;
+            numUploaded++;
+        }
+    }
+    glBindTexture(GL_TEXTURE_1D_ARRAY, 0);
+    return numUploaded;
+}
+
+void ToonRamps::bind(int unit) const
+{
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_1D_ARRAY, mTexture);
+}
+
+int ToonRamps::getNumRamps() const
+{
+    return mStyles.size();
+}
@@ -0,0 +1,85 @@
+//! @file    ToonRamps.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the ToonRamps class
+//!
+
+#pragma once
+
+#include <glm/glm.hpp>
+#include <GL/glew.h>
+
+#include <stdint.h>
+#include <vector>
+
+// Parameters from which a toon ramp is generated
+struct ToonStyle {
+    glm::vec3 ambientColor;
+    glm::vec3 diffuseColor;
+    float material_kd;
+    int colorlvl;
+};
+
+//! @class ToonRamps ToonRamps.h ToonRamps.h
+//!
+//! @brief Toon shading ramps stored as the layers of a 1D texture
+//! array.
+//!
+//! Each layer maps the diffuse term (0 to 1) to the banded color of one
+//! toon style, so the fragment shader needs a single texture fetch and
+//! objects or instances select their style by layer index. Ramps are
+//! generated on the CPU and only the layers whose style changed are
+//! uploaded again.
+//!
+class ToonRamps {
+public:
+    //! Constructor
+    //!
+    ToonRamps();
+
+    //! Destructor
+    //!
+    ~ToonRamps();
+
+    //! Create the texture array. Requires a current OpenGL context.
+    //!
+    //! @param[in] numRamps The number of ramps (layers).
+    //!
+    void init(int numRamps);
+
+    //! Set the style of a ramp. The ramp is regenerated, and marked for
+    //! upload, only if the style differs from the current one.
+    //!
+    //! @param[in] index Index of the ramp.
+    //! @param[in] style The new style.
+    //!
+    void setStyle(int index, const ToonStyle &style);
+
+    //! Upload the ramps that changed since the last call with
+    //! glTexSubImage2D.
+    //!
+    //! @return The number of ramps uploaded.
+    //!
+    int upload();
+
+    //! Bind the texture array.
+    //!
+    //! @param[in] unit Texture unit, for instance, 0 for GL_TEXTURE0.
+    //!
+    void bind(int unit) const;
+
+    //! Get the number of ramps.
+    //!
+    //! @return The number of ramps.
+    //!
+    int getNumRamps() const;
+private:
+    // Make instances non-copyable.
+    ToonRamps(const ToonRamps &);
+    const ToonRamps &operator=(const ToonRamps &);
+
+    std::vector<ToonStyle> mStyles;
+    std::vector<uint8_t> mTexels;
+    std::vector<bool> mDirty;
+    GLuint mTexture;
+};
@@ -0,0 +1,95 @@
+//! @file    TripleBuffer.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring and defining the TripleBuffer class template
+//!
+
+#pragma once
+
+#include <atomic>
+
+//! @class TripleBuffer TripleBuffer.h TripleBuffer.h
+//!
+//! @brief Lock-free handoff of values from one producer thread to one
+//! consumer thread.
+//!
+//! The producer fills its buffer and publishes it, which swaps it with
+//! the middle buffer. The consumer swaps its buffer with the middle one
+//! when that holds a newer value. Neither side ever waits for the other:
+//! the producer can publish faster than the consumer reads, in which
+//! case the values in between are dropped, and the consumer keeps the
+//! last value until a newer one is published.
+//!
+template <typename T>
+class TripleBuffer {
+public:
+    //! Constructor
+    //!
+    TripleBuffer() :
+        mMiddle(1),
+        mWrite(0),
+        mRead(2)
+    {
+    }
+
+    //! Get the buffer to fill before publish(). Producer only.
+    //!
+    //! @return The producer's buffer. Its contents are stale.
+    //!
+    T &getWriteBuffer()
+    {
+        return mBuffers[mWrite];
+    }
+
+    //! Make the producer's buffer the newest value. Producer only.
+    //!
+    void publish()
+    {
+        mWrite = mMiddle.exchange(mWrite | NEW, std::memory_order_acq_rel) & INDEX;
+    }
+
+    //! Check whether a value newer than the consumer's was published.
+    //! Can be called from either side.
+    //!
+    //! @return true if update() would return a new value.
+    //!
+    bool hasUpdate() const
+    {
+        return (mMiddle.load(std::memory_order_acquire) & NEW) != 0;
+    }
+
+    //! Take the newest value, if there is one. Consumer only.
+    //!
+    //! @return true if getReadBuffer() changed, otherwise false.
+    //!
+    bool update()
+    {
+        if (!hasUpdate()) {
+            return false;
+        }
+        mRead = mMiddle.exchange(mRead, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    //! Get the consumer's value. Consumer only.
+    //!
+    //! @return The value taken by the last successful update().
+    //!
+    const T &getReadBuffer() const
+    {
+        return mBuffers[mRead];
+    }
+private:
+    // Make instances non-copyable.
+    TripleBuffer(const TripleBuffer &);
+    const TripleBuffer &operator=(const TripleBuffer &);
+
+    // The middle index is stored with a flag telling whether it holds
+    // a value the consumer has not taken yet
+    enum { INDEX = 3, NEW = 4 };
+
+    T mBuffers[3];
+    std::atomic<int> mMiddle;
+    int mWrite;
+    int mRead;
+};
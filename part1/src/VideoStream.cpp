@@ -0,0 +1,392 @@
+//! @file    VideoStream.cpp
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Source file with definitions for VideoStream.h
+//!
+
+#include "VideoStream.h"
+#include "Trace.h"
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Unnamed namespace (for helper functions and constants)
+namespace {
+const char FRAME_HEADER[] = "FRAME\n";
+const size_t FRAME_HEADER_SIZE = sizeof(FRAME_HEADER) - 1;
+
+// BT.601 limited range conversion in 8 bit fixed point, as in the
+// SIMD kernel below
+inline unsigned char luma(int r, int g, int b)
+{
+    return ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+}
+
+inline unsigned char chromaU(int r, int g, int b)
+{
+    return ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+}
+
+inline unsigned char chromaV(int r, int g, int b)
+{
+    return ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+}
+
+// Converts the pixels from x on of two RGBA rows. The chroma of each
+// 2x2 block is computed from its average color. row1 and y1 equal row0
+// and y0 for the last row of an image with an odd height.
+void convertRowsScalar(const unsigned char *row0, const unsigned char *row1, int x, int width,
+                       unsigned char *y0, unsigned char *y1, unsigned char *u, unsigned char *v)
+{
+    for (int i = x; i < width; i++) {
+        y0[i] = luma(row0[4 * i], row0[4 * i + 1], row0[4 * i + 2]);
+        y1[i] = luma(row1[4 * i], row1[4 * i + 1], row1[4 * i + 2]);
+    }
+    for (int i = x; i < width; i += 2) {
+        int j = std::min(i + 1, width - 1);
+        int average[3];
+        for (int c = 0; c < 3; c++) {
+            average[c] = (row0[4 * i + c] + row0[4 * j + c] + row1[4 * i + c] + row1[4 * j + c] + 2) >> 2;
+        }
+        u[i / 2] = chromaU(average[0], average[1], average[2]);
+        v[i / 2] = chromaV(average[0], average[1], average[2]);
+    }
+}
+
+#ifdef __SSE2__
+// Splits 8 RGBA pixels into 16 bit lanes of red, green and blue
+inline void deinterleave(const unsigned char *pixels, __m128i *r, __m128i *g, __m128i *b)
+{
+    const __m128i mask = _mm_set1_epi32(0xff);
+    __m128i lo = _mm_loadu_si128((const __m128i *) pixels);
+    __m128i hi = _mm_loadu_si128((const __m128i *) (pixels + 16));
+    *r = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+    *g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 8), mask),
+                         _mm_and_si128(_mm_srli_epi32(hi, 8), mask));
+    *b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(lo, 16), mask),
+                         _mm_and_si128(_mm_srli_epi32(hi, 16), mask));
+}
+
+// The weighted sum of luma stays below 2^16, so it is computed with
+// wrapping 16 bit products and shifted as unsigned
+inline __m128i luma8(__m128i r, __m128i g, __m128i b)
+{
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(66)),
+                                _mm_mullo_epi16(g, _mm_set1_epi16(129)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(25)));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    return _mm_add_epi16(_mm_srli_epi16(sum, 8), _mm_set1_epi16(16));
+}
+
+// Averages the 2x2 blocks of the channel given for two rows of 8
+// pixels, giving 4 values (repeated in the upper half)
+inline __m128i average4(__m128i row0, __m128i row1)
+{
+    __m128i sum = _mm_madd_epi16(_mm_add_epi16(row0, row1), _mm_set1_epi16(1));
+    sum = _mm_srli_epi32(_mm_add_epi32(sum, _mm_set1_epi32(2)), 2);
+    return _mm_packs_epi32(sum, sum);
+}
+
+// Signed chroma of averaged colors, the terms fit in 16 bits
+inline __m128i chroma4(__m128i r, __m128i g, __m128i b, short cr, short cg, short cb)
+{
+    __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(cr)),
+                                _mm_mullo_epi16(g, _mm_set1_epi16(cg)));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(cb)));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(128));
+    return _mm_add_epi16(_mm_srai_epi16(sum, 8), _mm_set1_epi16(128));
+}
+
+// Converts 8 pixels of two rows, giving 2x8 luma and 4 chroma values
+inline void convert8(const unsigned char *row0, const unsigned char *row1,
+                     unsigned char *y0, unsigned char *y1, unsigned char *u, unsigned char *v)
+{
+    __m128i r0, g0, b0, r1, g1, b1;
+    deinterleave(row0, &r0, &g0, &b0);
+    deinterleave(row1, &r1, &g1, &b1);
+    __m128i lumas = _mm_packus_epi16(luma8(r0, g0, b0), luma8(r1, g1, b1));
+    _mm_storel_epi64((__m128i *) y0, lumas);
+    _mm_storel_epi64((__m128i *) y1, _mm_srli_si128(lumas, 8));
+
+    __m128i r = average4(r0, r1);
+    __m128i g = average4(g0, g1);
+    __m128i b = average4(b0, b1);
+    int us = _mm_cvtsi128_si32(_mm_packus_epi16(chroma4(r, g, b, -38, -74, 112), _mm_setzero_si128()));
+    int vs = _mm_cvtsi128_si32(_mm_packus_epi16(chroma4(r, g, b, 112, -94, -18), _mm_setzero_si128()));
+    std::memcpy(u, &us, 4);
+    std::memcpy(v, &vs, 4);
+}
+#endif
+
+double millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+VideoStream::VideoStream() :
+    mFd(-1),
+    mOwnsFd(false),
+    mFlags(0),
+    mFormat(VIDEO_FORMAT_Y4M),
+    mWidth(0),
+    mHeight(0),
+    mFailed(false),
+    mFrame(),
+    mNumFrames(0),
+    mNumBytes(0.0),
+    mNumStalls(0),
+    mStallTime(0.0),
+    mConvertTime(0.0)
+{
+}
+
+VideoStream::~VideoStream()
+{
+    close();
+}
+
+bool VideoStream::open(const std::string &filename, VideoFormat format, int width, int height, int fps)
+{
+    close();
+#ifdef _WIN32
+    // Streaming relies on POSIX pipes
+    return false;
+#else
+    if (filename == "-") {
+        mFd = STDOUT_FILENO;
+        mOwnsFd = false;
+    }
+    else {
+        mFd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        mOwnsFd = true;
+        if (mFd < 0) {
+            return false;
+        }
+    }
+    // Writes to a full pipe return instead of blocking, so that the
+    // waits for the reader can be counted. A reader that quits makes
+    // the writes fail instead of killing the program.
+    mFlags = fcntl(mFd, F_GETFL);
+    fcntl(mFd, F_SETFL, mFlags | O_NONBLOCK);
+    signal(SIGPIPE, SIG_IGN);
+
+    mFormat = format;
+    mWidth = width;
+    mHeight = height;
+    mFailed = false;
+    mNumFrames = 0;
+    mNumBytes = 0.0;
+    mNumStalls = 0;
+    mStallTime = 0.0;
+    mConvertTime = 0.0;
+    if (format == VIDEO_FORMAT_Y4M) {
+        size_t chromaSize = size_t((width + 1) / 2) * ((height + 1) / 2);
+        mFrame.resize(FRAME_HEADER_SIZE + size_t(width) * height + 2 * chromaSize);
+        std::memcpy(&mFrame[0], FRAME_HEADER, FRAME_HEADER_SIZE);
+        char header[128];
+        int size = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+                                 width, height, fps);
+        return write(header, size);
+    }
+    mFrame.clear();
+    return true;
+#endif
+}
+
+bool VideoStream::writeFrame(const unsigned char *pixels)
+{
+    CGTK_TRACE_SCOPE("video frame");
+    if (mFd < 0 || mFailed) {
+        return false;
+    }
+    if (mFormat == VIDEO_FORMAT_RGB) {
+        if (!writeRows(pixels)) {
+            return false;
+        }
+        mNumFrames++;
+        return true;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int chromaWidth = (mWidth + 1) / 2;
+    unsigned char *yPlane = &mFrame[FRAME_HEADER_SIZE];
+    unsigned char *uPlane = yPlane + size_t(mWidth) * mHeight;
+    unsigned char *vPlane = uPlane + size_t(chromaWidth) * ((mHeight + 1) / 2);
+    size_t stride = size_t(mWidth) * 4;
+    for (int y = 0; y < mHeight; y += 2) {
+        // OpenGL stores the bottom row first
+        const unsigned char *row0 = pixels + (mHeight - 1 - y) * stride;
+        const unsigned char *row1 = y + 1 < mHeight ? row0 - stride : row0;
+        unsigned char *y0 = yPlane + size_t(y) * mWidth;
+        unsigned char *y1 = y + 1 < mHeight ? y0 + mWidth : y0;
+        unsigned char *u = uPlane + size_t(y / 2) * chromaWidth;
+        unsigned char *v = vPlane + size_t(y / 2) * chromaWidth;
+        int x = 0;
+#ifdef __SSE2__
+        for (; x + 8 <= mWidth; x += 8) {
+            convert8(row0 + 4 * x, row1 + 4 * x, y0 + x, y1 + x, u + x / 2, v + x / 2);
+        }
+#endif
+        convertRowsScalar(row0, row1, x, mWidth, y0, y1, u, v);
+    }
+    mConvertTime += millisecondsSince(start);
+
+    if (!write(&mFrame[0], mFrame.size())) {
+        return false;
+    }
+    mNumFrames++;
+    return true;
+}
+
+bool VideoStream::close()
+{
+    if (mFd < 0) {
+        return false;
+    }
+#ifndef _WIN32
+    fcntl(mFd, F_SETFL, mFlags);
+    if (mOwnsFd && ::close(mFd) != 0) {
+        mFailed = true;
+    }
+#endif
+    mFd = -1;
+    return !mFailed;
+}
+
+int VideoStream::getBytesPerPixel() const
+{
+    return mFormat == VIDEO_FORMAT_RGB ? 3 : 4;
+}
+
+int VideoStream::getNumFrames() const
+{
+    return mNumFrames;
+}
+
+double VideoStream::getNumBytes() const
+{
+    return mNumBytes;
+}
+
+int VideoStream::getNumStalls() const
+{
+    return mNumStalls;
+}
+
+double VideoStream::getStallTime() const
+{
+    return mStallTime;
+}
+
+double VideoStream::getConvertTime() const
+{
+    return mConvertTime;
+}
+
+#ifndef _WIN32
+bool VideoStream::write(const void *data, size_t size)
+{
+    const char *bytes = (const char *) data;
+    while (size > 0) {
+        ssize_t written = ::write(mFd, bytes, size);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitForReader();
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            mFailed = true;
+            return false;
+        }
+        bytes += written;
+        size -= written;
+        mNumBytes += written;
+    }
+    return true;
+}
+
+bool VideoStream::writeRows(const unsigned char *pixels)
+{
+    // The rows are gathered top row first, IOV_MAX at a time
+    size_t rowBytes = size_t(mWidth) * 3;
+    std::vector<iovec> rows(mHeight);
+    for (int y = 0; y < mHeight; y++) {
+        rows[y].iov_base = const_cast<unsigned char *>(pixels + (mHeight - 1 - y) * rowBytes);
+        rows[y].iov_len = rowBytes;
+    }
+    size_t first = 0;
+    while (first < rows.size()) {
+        int count = int(std::min<size_t>(rows.size() - first, IOV_MAX));
+        ssize_t written = writev(mFd, &rows[first], count);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                waitForReader();
+                continue;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            mFailed = true;
+            return false;
+        }
+        mNumBytes += written;
+        // Skip the rows that were written and the written part of the
+        // next one
+        while (first < rows.size() && size_t(written) >= rows[first].iov_len) {
+            written -= rows[first].iov_len;
+            first++;
+        }
+        if (written > 0) {
+            rows[first].iov_base = (char *) rows[first].iov_base + written;
+            rows[first].iov_len -= written;
+        }
+    }
+    return true;
+}
+
+void VideoStream::waitForReader()
+{
+    auto start = std::chrono::steady_clock::now();
+    pollfd fd;
+    fd.fd = mFd;
+    fd.events = POLLOUT;
+    fd.revents = 0;
+    while (poll(&fd, 1, -1) < 0 && errno == EINTR) {
+    }
+    mNumStalls++;
+    mStallTime += millisecondsSince(start);
+}
+#else
+bool VideoStream::write(const void *, size_t)
+{
+    return false;
+}
+
+bool VideoStream::writeRows(const unsigned char *)
+{
+    return false;
+}
+
+void VideoStream::waitForReader()
+{
+}
+#endif
@@ -0,0 +1,125 @@
+//! @file    VideoStream.h
+//! @date    <2026-10-18 Sun>
+//!
+//! @brief Header declaring the VideoStream class
+//!
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Formats of the stream
+enum VideoFormat {
+    VIDEO_FORMAT_Y4M = 0,  // YUV4MPEG2 with 4:2:0 chroma
+    VIDEO_FORMAT_RGB = 1   // raw RGB frames without any header
+};
+
+//! @class VideoStream VideoStream.h VideoStream.h
+//!
+//! @brief Streams frames to a file, a named pipe or the standard output,
+//! e.g., for an external video encoder.
+//!
+//! Frames are written straight from the caller's pixels, which are
+//! meant to be a mapped pixel pack buffer: raw RGB rows are gathered
+//! with writev() in top-down order without any copy, and Y4M frames
+//! are converted from RGBA to YUV 4:2:0 (BT.601, limited range) in a
+//! single SSE2 pass. A write that has to wait for the reader of a full
+//! pipe is counted as a stall.
+//!
+class VideoStream {
+public:
+    //! Constructor
+    //!
+    VideoStream();
+
+    //! Destructor. Closes the stream.
+    //!
+    ~VideoStream();
+
+    //! Open the stream and write the stream header. Opening a named
+    //! pipe waits until a reader opens it.
+    //!
+    //! @param[in] filename Name of the file or pipe, or "-" for the
+    //! standard output.
+    //! @param[in] format Stream format.
+    //! @param[in] width Width of the frames.
+    //! @param[in] height Height of the frames.
+    //! @param[in] fps Frame rate recorded in the Y4M header.
+    //! @return true if the stream was opened, otherwise false.
+    //!
+    bool open(const std::string &filename, VideoFormat format, int width, int height, int fps);
+
+    //! Write a frame.
+    //!
+    //! @param[in] pixels Tightly packed rows starting with the bottom
+    //! row, RGBA for Y4M and RGB for raw streams.
+    //! @return true if the frame was written, otherwise false.
+    //!
+    bool writeFrame(const unsigned char *pixels);
+
+    //! Close the stream.
+    //!
+    //! @return true if all frames were written, otherwise false.
+    //!
+    bool close();
+
+    //! Get the number of bytes per pixel expected by writeFrame().
+    //!
+    //! @return 4 for Y4M and 3 for raw RGB.
+    //!
+    int getBytesPerPixel() const;
+
+    //! Get the number of frames written.
+    //!
+    //! @return The number of frames.
+    //!
+    int getNumFrames() const;
+
+    //! Get the number of bytes written.
+    //!
+    //! @return Size in bytes.
+    //!
+    double getNumBytes() const;
+
+    //! Get the number of times the reader was not keeping up.
+    //!
+    //! @return The number of stalls.
+    //!
+    int getNumStalls() const;
+
+    //! Get the time spent waiting for the reader.
+    //!
+    //! @return Time in milliseconds.
+    //!
+    double getStallTime() const;
+
+    //! Get the time spent converting to YUV.
+    //!
+    //! @return Time in milliseconds.
+    //!
+    double getConvertTime() const;
+private:
+    // Make instances non-copyable.
+    VideoStream(const VideoStream &);
+    const VideoStream &operator=(const VideoStream &);
+
+    bool write(const void *data, size_t size);
+    bool writeRows(const unsigned char *pixels);
+    void waitForReader();
+
+    int mFd;
+    bool mOwnsFd;
+    int mFlags;
+    VideoFormat mFormat;
+    int mWidth;
+    int mHeight;
+    bool mFailed;
+    std::vector<unsigned char> mFrame;
+
+    int mNumFrames;
+    double mNumBytes;
+    int mNumStalls;
+    double mStallTime;
+    double mConvertTime;
+};
@@ -7,6 +7,28 @@
 #include "GLSLProgram.h"
 #include "OBJFileReader.h"
 #include "Trackball.h"
+#include "JumpFloodOutline.h"
+#include "OverdrawHeatMap.h"
+#include "Mesh.h"
+#include "SilhouetteEdges.h"
+#include "EdgeQuads.h"
+#include "AdjacencyIndices.h"
+#include "ToonRamps.h"
+#include "OffscreenContext.h"
+#include "FrameCapture.h"
+#include "PngEncoder.h"
+#include "GifWriter.h"
+#include "VideoStream.h"
+#include "TripleBuffer.h"
+#include "LatencyHistogram.h"
+#include "InputLog.h"
+#include "GpuProfiler.h"
+#include "Trace.h"
+#include "PerfCounters.h"
+#include "DrawStats.h"
+#include "GLAudit.h"
+#include "MemoryRegistry.h"
+#include "MetricsServer.h"
 
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
@@ -15,10 +37,25 @@
 #include <glm/gtc/matrix_inverse.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <AntTweakBar.h>
+#include <zlib.h>
 
 #include <iostream>
 #include <cstdlib>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
 
 // The attribute locations we will use in the vertex shader
 enum AttributeLocation {
@@ -26,22 +63,124 @@ enum AttributeLocation {
     NORMAL = 1
 };
 
-// Struct for representing an indexed triangle mesh
-struct Mesh {
-    std::vector<glm::vec3> vertices;
-    std::vector<glm::vec3> normals;
-    std::vector<uint32_t> indices;
+// The available methods for drawing the outline
+enum OutlineMode {
+    OUTLINE_FRAGMENT = 0,
+    OUTLINE_JUMP_FLOOD = 1,
+    OUTLINE_SILHOUETTE_EDGES = 2,
+    OUTLINE_GEOMETRY_SHADER = 3,
+    OUTLINE_INVERTED_HULL = 4
 };
 
-// Struct for representing a vertex array object (VAO) created from a
-// mesh. Used for rendering.
-struct MeshVAO {
-    GLuint vao;
-    GLuint vertexVBO;
-    GLuint normalVBO;
-    GLuint indexVBO;
-    int numVertices;
-    int numIndices;
+// Number of toon styles in the ramp texture array
+const int NUM_TOON_RAMPS = 4;
+
+// Number of frames in flight whose GPU times are not read yet
+const int NUM_PROFILED_FRAMES = 3;
+
+// Largest number of passes shown in the Perf bar
+const int MAX_PERF_PASSES = 16;
+
+// Largest number of assets and categories shown in the Memory bar
+const int MAX_MEMORY_USAGES = 32;
+
+// Seconds between queries of the video memory reported by the driver
+const double DRIVER_MEMORY_PERIOD = 1.0;
+
+// The bundled 3D models, in the order of the tweakbar enum
+const char *MODEL_FILENAMES[] = {
+    "bunny.obj", "armadillo.obj", "gargo.obj", "teapot.obj", "icosphere.obj"
+};
+
+// The name of a bundled model, e.g., "bunny"
+std::string modelName(int model)
+{
+    std::string filename = MODEL_FILENAMES[model];
+    return filename.substr(0, filename.size() - 4);
+}
+
+const int NUM_MODELS = sizeof(MODEL_FILENAMES) / sizeof(MODEL_FILENAMES[0]);
+
+// Upper bounds of the buckets of the frame time histogram of the
+// metrics endpoint, in seconds. The last bucket has no bound.
+const double FRAME_TIME_BUCKETS[] = {
+    0.002, 0.004, 0.008, 0.0167, 0.0333, 0.05, 0.1, 0.25, 0.5, 1.0
+};
+const int NUM_FRAME_TIME_BUCKETS = sizeof(FRAME_TIME_BUCKETS) / sizeof(FRAME_TIME_BUCKETS[0]) + 1;
+
+// Longest name of a GPU pass or an asset served by the metrics endpoint
+const int MAX_METRICS_NAME = 32;
+
+// Bytes of an asset in a category, copied from the registry for the
+// metrics endpoint
+struct AssetMetrics {
+    char asset[MAX_METRICS_NAME];
+    cgtk::MemoryCategory category;
+    size_t bytes;
+};
+
+// Counters and statistics served by the metrics endpoint. The render
+// thread accumulates them and publishes a copy after each frame, which
+// the server thread reads, so the struct holds no pointers and copying
+// it never allocates.
+struct FrameMetrics {
+    long long frames;
+    long long frameTimeCounts[NUM_FRAME_TIME_BUCKETS];
+    double frameTimeSum;
+
+    // Draw calls and triangles submitted in the last frame and in all
+    // frames
+    long long drawCalls;
+    long long triangles;
+    long long drawCallsTotal;
+    long long trianglesTotal;
+
+    // Edges of the silhouette hierarchy, the extractions of the last
+    // frame, one per instance, or 0 if it drew no silhouette edges, and
+    // the edges they tested and drew in sum
+    int edges;
+    int extractions;
+    int edgesTested;
+    int edgesDrawn;
+
+    // GPU time of each pass, average and 99th percentile, in seconds
+    int numPasses;
+    char passNames[MAX_PERF_PASSES][MAX_METRICS_NAME];
+    double passTimes[MAX_PERF_PASSES][2];
+
+    // Seconds the last load of each model took, or 0 if never loaded
+    double loadSeconds[NUM_MODELS];
+
+    // The memory of the registry, copied when its generation changed:
+    // the CPU and GPU bytes now and at most, the free video memory
+    // reported by the driver, or -1, and the bytes of each asset
+    unsigned memoryGeneration;
+    size_t memoryTotals[2][2];
+    double driverAvailable;
+    int numAssets;
+    AssetMetrics assets[MAX_MEMORY_USAGES];
+
+    FrameMetrics()
+    {
+        frames = 0;
+        std::fill(frameTimeCounts, frameTimeCounts + NUM_FRAME_TIME_BUCKETS, 0);
+        frameTimeSum = 0.0;
+        drawCalls = 0;
+        triangles = 0;
+        drawCallsTotal = 0;
+        trianglesTotal = 0;
+        edges = 0;
+        extractions = 0;
+        edgesTested = 0;
+        edgesDrawn = 0;
+        numPasses = 0;
+        std::fill(loadSeconds, loadSeconds + NUM_MODELS, 0.0);
+        memoryGeneration = 0;
+        memoryTotals[0][0] = memoryTotals[0][1] = 0;
+        memoryTotals[1][0] = memoryTotals[1][1] = 0;
+        driverAvailable = -1.0;
+        numAssets = 0;
+    }
 };
 
 // Struct for global resources
@@ -49,7 +188,10 @@ struct Globals {
     int width;
     int height;
     cgtk::GLSLProgram program;
-    cgtk::Trackball trackball;
+    cgtk::GLSLProgram silhouetteProgram;
+    cgtk::GLSLProgram hullProgram;
+    glm::mat4 rotation;
+    int model;
     Mesh mesh;
     MeshVAO meshVAO;
     glm::vec3 lightDir;
@@ -61,11 +203,76 @@ struct Globals {
     float zoomfactor;
     glm::vec3 bg_color;
     int colorlvl;
+    OutlineMode outlineMode;
+    float outline_width;
+    JumpFloodOutline jumpFlood;
+    SilhouetteEdges silhouetteEdges;
+    EdgeQuads silhouetteQuads;
+    std::vector<uint32_t> silhouetteLines;
+    bool silhouette_brute_force;
+    float crease_angle;
+    double silhouette_time;
+    int silhouette_tested;
+    int silhouette_drawn;
+    bool vsync;
+    double frame_time;
+
+    // Time from an input event to the swap of the first frame showing
+    // it, for every event, and optionally logged to a file
+    LatencyHistogram latency;
+    double latency_p50;
+    double latency_p99;
+    std::ofstream latency_log;
+    std::chrono::steady_clock::time_point latency_epoch;
+    unsigned events_shown;
+    bool single_thread;
+    std::chrono::steady_clock::time_point last_swap;
+    bool drew_last;
+
+    // Late latching: while the trackball is dragged, the rotation is
+    // recomputed from the newest cursor position right before drawing,
+    // from the trackball of the snapshot being drawn
+    bool late_latch;
+    cgtk::Trackball trackball;
+    int drag;
+    unsigned input_events;
+    unsigned latched_events;
 
     glm::vec3 diffuseColor;
     glm::vec3 ambientColor;
     glm::vec3 outlineColor;
 
+    ToonRamps toonRamps;
+    GpuProfiler gpuProfiler;
+    bool pipeline_statistics;
+    OverdrawHeatMap overdrawHeatMap;
+    bool overdraw;
+    bool gl_audit;
+    std::string trace_file;
+    std::string memory_report;
+    std::chrono::steady_clock::time_point memory_sampled;
+    int ramp;
+    int instances;
+    float instance_spacing;
+    float turntable_angle;
+
+    // Region of the whole image covered by the framebuffer, in pixels
+    // from its lower left corner, when it is rendered in tiles. Empty
+    // otherwise.
+    glm::ivec4 tile;
+    glm::ivec2 image_size;
+
+    // The offscreen framebuffer frames are drawn into without a window
+    const OffscreenContext *offscreen;
+
+    // With --metrics, the statistics of the frames and loads and the
+    // copies the render thread publishes to the server thread. The
+    // server comes last, so that it stops before the copies are
+    // destroyed.
+    FrameMetrics metrics;
+    TripleBuffer<FrameMetrics> metrics_snapshots;
+    MetricsServer metricsServer;
+
     Globals()
     {
         width = 800;
@@ -82,11 +289,394 @@ struct Globals {
         outline_intensity = 0.4;
         zoomfactor = 1.5f;
         colorlvl = 5;
+        model = 0;
+        outlineMode = OUTLINE_FRAGMENT;
+        outline_width = 8.0f;
+        silhouette_brute_force = false;
+        crease_angle = 60.0f;
+        silhouette_time = 0.0;
+        silhouette_tested = 0;
+        silhouette_drawn = 0;
+        vsync = true;
+        ramp = 0;
+        rotation = glm::mat4(1.0f);
+        instances = 1;
+        instance_spacing = 2.0f;
+        turntable_angle = 0.0f;
+        tile = glm::ivec4(0);
+        image_size = glm::ivec2(0);
+        offscreen = NULL;
+        frame_time = 0.0;
+        latency_p50 = 0.0;
+        latency_p99 = 0.0;
+        events_shown = 0;
+        single_thread = false;
+        drew_last = false;
+        late_latch = true;
+        drag = 0;
+        input_events = 0;
+        latched_events = 0;
+        pipeline_statistics = false;
+        overdraw = false;
+        gl_audit = false;
     }
 };
 
 Globals globals;
 
+// The parameters of the view that input changes. The input thread
+// passes snapshots of them to the render thread, which copies them to
+// the globals before drawing.
+struct ViewParams {
+    int width;
+    int height;
+    glm::mat4 rotation;
+    float zoomfactor;
+    glm::vec3 lightDir;
+    float material_kd;
+    float outline_intensity;
+    glm::vec3 bg_color;
+    int colorlvl;
+    OutlineMode outlineMode;
+    float outline_width;
+    bool silhouette_brute_force;
+    float crease_angle;
+    bool vsync;
+    glm::vec3 diffuseColor;
+    glm::vec3 ambientColor;
+    glm::vec3 outlineColor;
+    int ramp;
+    int instances;
+    int model;
+
+    // Debug views of the Perf bar
+    bool pipeline_statistics;
+    bool overdraw;
+
+    // The window is only redrawn when something changed, unless
+    // continuous_redraw is set (e.g., to measure the frame time) or a
+    // button of the tweakbar is held, which repeats the change
+    bool continuous_redraw;
+    bool tweakbar_pressed;
+
+    // The trackball and the number of its drags, for late latching
+    bool late_latch;
+    cgtk::Trackball trackball;
+    int drag;
+
+    // Number of input events the snapshot includes
+    unsigned input_events;
+};
+
+// The view parameters in input logs, which record their changes. The
+// values are stored in the logs, so new parameters are appended.
+enum ParameterId {
+    PARAMETER_LIGHT_DIR = 0,
+    PARAMETER_MATERIAL_KD = 1,
+    PARAMETER_OUTLINE_INTENSITY = 2,
+    PARAMETER_BG_COLOR = 3,
+    PARAMETER_COLOR_LEVELS = 4,
+    PARAMETER_OUTLINE_MODE = 5,
+    PARAMETER_OUTLINE_WIDTH = 6,
+    PARAMETER_BRUTE_FORCE = 7,
+    PARAMETER_CREASE_ANGLE = 8,
+    PARAMETER_VSYNC = 9,
+    PARAMETER_DIFFUSE_COLOR = 10,
+    PARAMETER_AMBIENT_COLOR = 11,
+    PARAMETER_OUTLINE_COLOR = 12,
+    PARAMETER_RAMP = 13,
+    PARAMETER_INSTANCES = 14,
+    PARAMETER_MODEL = 15,
+    PARAMETER_CONTINUOUS_REDRAW = 16,
+    PARAMETER_LATE_LATCH = 17,
+    PARAMETER_PIPELINE_STATISTICS = 18,
+    PARAMETER_OVERDRAW = 19,
+    NUM_PARAMETERS = 20
+};
+
+// Converts a view parameter to the values of an input record
+struct ParameterReader {
+    float values[3];
+    int numValues;
+
+    void operator()(float &value) { values[0] = value; numValues = 1; }
+    void operator()(int &value) { values[0] = float(value); numValues = 1; }
+    void operator()(bool &value) { values[0] = value ? 1.0f : 0.0f; numValues = 1; }
+    void operator()(glm::vec3 &value) { values[0] = value.x; values[1] = value.y; values[2] = value.z; numValues = 3; }
+};
+
+// Sets a view parameter from the values of an input record
+struct ParameterWriter {
+    const float *values;
+
+    void operator()(float &value) { value = values[0]; }
+    void operator()(int &value) { value = int(values[0]); }
+    void operator()(bool &value) { value = values[0] != 0.0f; }
+    void operator()(glm::vec3 &value) { value = glm::vec3(values[0], values[1], values[2]); }
+};
+
+// Calls visit with the view parameter of an id. Returns false for an
+// unknown id.
+template <typename Visitor>
+bool visitParameter(ViewParams *params, int id, Visitor &visit)
+{
+    switch (id) {
+    case PARAMETER_LIGHT_DIR: visit(params->lightDir); break;
+    case PARAMETER_MATERIAL_KD: visit(params->material_kd); break;
+    case PARAMETER_OUTLINE_INTENSITY: visit(params->outline_intensity); break;
+    case PARAMETER_BG_COLOR: visit(params->bg_color); break;
+    case PARAMETER_COLOR_LEVELS: visit(params->colorlvl); break;
+    case PARAMETER_OUTLINE_MODE: {
+        int mode = params->outlineMode;
+        visit(mode);
+        params->outlineMode = OutlineMode(std::min(std::max(mode, 0), int(OUTLINE_INVERTED_HULL)));
+        break;
+    }
+    case PARAMETER_OUTLINE_WIDTH: visit(params->outline_width); break;
+    case PARAMETER_BRUTE_FORCE: visit(params->silhouette_brute_force); break;
+    case PARAMETER_CREASE_ANGLE: visit(params->crease_angle); break;
+    case PARAMETER_VSYNC: visit(params->vsync); break;
+    case PARAMETER_DIFFUSE_COLOR: visit(params->diffuseColor); break;
+    case PARAMETER_AMBIENT_COLOR: visit(params->ambientColor); break;
+    case PARAMETER_OUTLINE_COLOR: visit(params->outlineColor); break;
+    case PARAMETER_RAMP: visit(params->ramp); break;
+    case PARAMETER_INSTANCES: visit(params->instances); break;
+    case PARAMETER_MODEL: visit(params->model); break;
+    case PARAMETER_CONTINUOUS_REDRAW: visit(params->continuous_redraw); break;
+    case PARAMETER_LATE_LATCH: visit(params->late_latch); break;
+    case PARAMETER_PIPELINE_STATISTICS: visit(params->pipeline_statistics); break;
+    case PARAMETER_OVERDRAW: visit(params->overdraw); break;
+    default: return false;
+    }
+    return true;
+}
+
+// Number of input events whose times are kept for the render thread
+const int INPUT_EVENT_LOG_SIZE = 4096;
+
+// An entry of the ring of input event times. The input thread
+// overwrites it INPUT_EVENT_LOG_SIZE events later, so the render thread
+// checks the number of the event before and after reading it.
+struct InputEvent {
+    std::atomic<unsigned> number;  // one more than the event's index, zero while written
+    std::atomic<std::chrono::steady_clock::rep> time;
+    std::atomic<bool> cursor;
+};
+
+// Newest cursor position of a drag, passed to the render thread as
+// soon as it arrives rather than with the next snapshot
+struct CursorSample {
+    glm::vec2 point;
+    int drag;
+    unsigned events;
+
+    CursorSample()
+    {
+        point = glm::vec2(0.0f);
+        drag = 0;
+        events = 0;
+    }
+};
+
+// The values shown in the Perf bar: the GPU times of the passes,
+// average and 99th percentile, their pipeline statistics and, with
+// --gl-audit, the GL calls of the last frame, all, sync and redundant
+struct PerfValues {
+    int numPasses;
+    double times[MAX_PERF_PASSES][2];
+    double statistics[MAX_PERF_PASSES][NUM_PIPELINE_STATISTICS];
+    double fragmentsPerPixel;
+    int dropped;
+    int glCalls[3];
+};
+
+// Time a thread waited for input.mutex because the other thread held
+// it, counted by InputLock
+struct LockWaits {
+    std::atomic<unsigned> count;
+    std::atomic<long long> totalNanoseconds;
+    std::atomic<long long> maxNanoseconds;
+};
+
+// State of the input thread. The GLFW callbacks and AntTweakBar run on
+// it, the latter also inside TwDraw() on the render thread, so both
+// hold the mutex while using the tweakbar or the parameters.
+struct InputState {
+    std::mutex mutex;
+    ViewParams params;
+    cgtk::Trackball trackball;
+    bool dirty;
+    int frames_skipped;
+
+    TripleBuffer<ViewParams> snapshots;
+    TripleBuffer<CursorSample> cursor;
+    InputEvent events[INPUT_EVENT_LOG_SIZE];
+
+    // With --record, the events and the parameters last written to the
+    // log
+    InputLogWriter recorder;
+    ViewParams recorded;
+
+    // The values of the Perf bar, gathered by the render thread before
+    // it takes the mutex and copied in with it held, and the number of
+    // passes added to the bar
+    TwBar *perfBar;
+    PerfValues perf;
+    int numPerfPasses;
+
+    // The memory of the CPU and GPU and their high-water marks, the
+    // video memory reported by the driver and the memory of each asset
+    // and category now and at most, in MB, copied from the registry by
+    // the render thread whenever the generation of the registry changed
+    TwBar *memoryBar;
+    unsigned memoryGeneration;
+    double memoryTotals[4];
+    double driverMemory[2];
+    std::vector<std::string> memoryUsageNames;
+    double memoryUsages[MAX_MEMORY_USAGES][2];
+
+    // The waits of the input and the render thread for the mutex
+    LockWaits inputWaits;
+    LockWaits renderWaits;
+
+    // The render thread sleeps on wake while there is nothing to draw
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> quit;
+
+    InputState()
+    {
+        dirty = false;
+        frames_skipped = 0;
+        quit = false;
+        perfBar = NULL;
+        std::memset(&perf, 0, sizeof(perf));
+        numPerfPasses = 0;
+        memoryBar = NULL;
+        memoryGeneration = 0;
+        std::fill(memoryTotals, memoryTotals + 4, 0.0);
+        driverMemory[0] = driverMemory[1] = 0.0;
+        LockWaits *waits[] = { &inputWaits, &renderWaits };
+        for (int i = 0; i < 2; i++) {
+            waits[i]->count = 0;
+            waits[i]->totalNanoseconds = 0;
+            waits[i]->maxNanoseconds = 0;
+        }
+    }
+};
+
+InputState input;
+
+// Locks input.mutex like std::lock_guard, and adds the time waited to
+// the waits of the calling thread when the other thread holds it. The
+// render thread holds it while drawing the tweakbar, which is not
+// thread-safe, and the input thread while handling an event, which is
+// how long each can wait for the other.
+struct InputLock {
+    std::unique_lock<std::mutex> lock;
+
+    explicit InputLock(LockWaits &waits) :
+        lock(input.mutex, std::try_to_lock)
+    {
+        if (lock.owns_lock()) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        lock.lock();
+        long long waited = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        waits.count++;
+        waits.totalNanoseconds += waited;
+        long long longest = waits.maxNanoseconds;
+        while (waited > longest && !waits.maxNanoseconds.compare_exchange_weak(longest, waited)) {
+        }
+    }
+};
+
+// Marks the frame as out of date, so that it is drawn again. Called
+// with input.mutex held.
+void invalidate(void)
+{
+    input.dirty = true;
+}
+
+// Records the time of an input event that changes the view, and
+// invalidates the frame. Called with input.mutex held.
+void inputEvent(bool cursor = false)
+{
+    unsigned index = input.params.input_events;
+    InputEvent &event = input.events[index % INPUT_EVENT_LOG_SIZE];
+    event.number.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.time.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    event.cursor.store(cursor, std::memory_order_relaxed);
+    event.number.store(index + 1, std::memory_order_release);
+    input.params.input_events = index + 1;
+    invalidate();
+}
+
+// Writes an input event to the log when recording. Called with
+// input.mutex held.
+void recordEvent(InputRecordType type, bool tweakbar, int a0, int a1, int a2, int a3, float x, float y)
+{
+    if (!input.recorder.isOpen()) {
+        return;
+    }
+    InputRecord record;
+    record.type = type;
+    record.tweakbar = tweakbar;
+    record.args[0] = a0;
+    record.args[1] = a1;
+    record.args[2] = a2;
+    record.args[3] = a3;
+    record.values[0] = x;
+    record.values[1] = y;
+    input.recorder.write(record);
+}
+
+// Writes the view parameters that changed since they were last written
+// to the log when recording, or all of them. Called with input.mutex
+// held.
+void recordParameters(bool all)
+{
+    if (!input.recorder.isOpen()) {
+        return;
+    }
+    for (int id = 0; id < NUM_PARAMETERS; id++) {
+        ParameterReader current;
+        ParameterReader recorded;
+        visitParameter(&input.params, id, current);
+        visitParameter(&input.recorded, id, recorded);
+        if (all || !std::equal(current.values, current.values + current.numValues, recorded.values)) {
+            InputRecord record;
+            record.type = INPUT_RECORD_PARAMETER;
+            record.args[0] = id;
+            record.args[1] = current.numValues;
+            std::copy(current.values, current.values + current.numValues, record.values);
+            input.recorder.write(record);
+        }
+    }
+    input.recorded = input.params;
+}
+
+// Reads the time of an input event. Returns false if it was
+// overwritten by a newer event. Runs on the render thread.
+bool readInputEvent(unsigned index, std::chrono::steady_clock::time_point *time, bool *cursor)
+{
+    const InputEvent &event = input.events[index % INPUT_EVENT_LOG_SIZE];
+    if (event.number.load(std::memory_order_acquire) != index + 1) {
+        return false;
+    }
+    std::chrono::steady_clock::rep ticks = event.time.load(std::memory_order_relaxed);
+    *cursor = event.cursor.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (event.number.load(std::memory_order_relaxed) != index + 1) {
+        return false;
+    }
+    *time = std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(ticks));
+    return true;
+}
+
 void errorCallback(int error, const char* description)
 {
     std::cerr << description << std::endl;
@@ -131,6 +721,7 @@ void loadProgram(const std::string &vertexShaderFilename,
                  const std::string &fragmentShaderFilename,
                  cgtk::GLSLProgram *program)
 {
+    CGTK_TRACE_FUNCTION();
     std::string vertexShaderSource = cgtk::readGLSLSource(vertexShaderFilename);
     std::string fragmentShaderSource = cgtk::readGLSLSource(fragmentShaderFilename);
 
@@ -143,17 +734,40 @@ void loadProgram(const std::string &vertexShaderFilename,
     }
 }
 
-void loadMesh(const std::string &filename, Mesh *mesh)
+void loadProgram(const std::string &vertexShaderFilename,
+                 const std::string &geometryShaderFilename,
+                 const std::string &fragmentShaderFilename,
+                 cgtk::GLSLProgram *program)
+{
+    program->setShaderSource(GL_GEOMETRY_SHADER, cgtk::readGLSLSource(geometryShaderFilename));
+    loadProgram(vertexShaderFilename, fragmentShaderFilename, program);
+}
+
+// Accounts the mesh under an asset name unless it is empty. The copy
+// of the reader is still alive then, so the high-water mark includes
+// it.
+void loadMesh(const std::string &filename, Mesh *mesh, const std::string &asset = "")
 {
+    CGTK_TRACE_FUNCTION();
     cgtk::OBJFileReader reader;
     reader.load(filename.c_str());
     mesh->vertices = reader.getVertices();
     mesh->normals = reader.getNormals();
     mesh->indices = reader.getIndices();
+    CGTK_TRACE_SCOPE("buildAdjacencyIndices");
+    buildAdjacencyIndices(mesh->indices, mesh->adjacencyIndices);
+    if (!asset.empty()) {
+        cgtk::MemoryRegistry::set(mesh, cgtk::MEMORY_MESH, asset,
+                                  cgtk::getMemoryBytes(mesh->vertices) + cgtk::getMemoryBytes(mesh->normals) +
+                                  cgtk::getMemoryBytes(mesh->indices) + cgtk::getMemoryBytes(mesh->adjacencyIndices));
+    }
 }
 
-void createMeshVAO(const Mesh &mesh, MeshVAO *meshVAO)
+void createMeshVAO(const Mesh &mesh, const std::string &asset, MeshVAO *meshVAO)
 {
+    CGTK_TRACE_FUNCTION();
+    cgtk::PerfScope perf("GPU upload");
+
     // Generates and populates a VBO for the vertices
     glGenBuffers(1, &(meshVAO->vertexVBO));
     glBindBuffer(GL_ARRAY_BUFFER, meshVAO->vertexVBO);
@@ -184,40 +798,182 @@ void createMeshVAO(const Mesh &mesh, MeshVAO *meshVAO)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshVAO->indexVBO);
     glBindVertexArray(0); // unbinds the VAO
 
+    // Generates and populates a VBO for the triangles-with-adjacency
+    // indices, and a VAO sharing the vertex VBO for drawing them
+    glGenBuffers(1, &(meshVAO->adjacencyIndexVBO));
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshVAO->adjacencyIndexVBO);
+    auto adjacencyNBytes = mesh.adjacencyIndices.size() * sizeof(mesh.adjacencyIndices[0]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, adjacencyNBytes, mesh.adjacencyIndices.data(), GL_STATIC_DRAW);
+
+    glGenVertexArrays(1, &(meshVAO->adjacencyVAO));
+    glBindVertexArray(meshVAO->adjacencyVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, meshVAO->vertexVBO);
+    glEnableVertexAttribArray(POSITION);
+    glVertexAttribPointer(POSITION, 3, GL_FLOAT, GL_FALSE, 0, NULL);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, meshVAO->adjacencyIndexVBO);
+    glBindVertexArray(0);
+
     // Additional information required by draw calls
     meshVAO->numVertices = mesh.vertices.size();
     meshVAO->numIndices = mesh.indices.size();
+    meshVAO->numAdjacencyIndices = mesh.adjacencyIndices.size();
+    cgtk::MemoryRegistry::set(meshVAO, cgtk::MEMORY_BUFFER, asset,
+                              verticesNBytes + normalsNBytes + indicesNBytes + adjacencyNBytes);
+    perf.stop(mesh.vertices.size(), mesh.indices.size() / 3);
+}
+
+void deleteMeshVAO(MeshVAO *meshVAO)
+{
+    glDeleteVertexArrays(1, &(meshVAO->vao));
+    glDeleteVertexArrays(1, &(meshVAO->adjacencyVAO));
+    glDeleteBuffers(1, &(meshVAO->vertexVBO));
+    glDeleteBuffers(1, &(meshVAO->normalVBO));
+    glDeleteBuffers(1, &(meshVAO->indexVBO));
+    glDeleteBuffers(1, &(meshVAO->adjacencyIndexVBO));
+    cgtk::MemoryRegistry::release(meshVAO);
+}
+
+// Loads one of the bundled models together with everything derived
+// from its mesh
+void loadModel(int model)
+{
+    auto start = std::chrono::steady_clock::now();
+    globals.model = model;
+    loadMesh(modelDir() + MODEL_FILENAMES[model], &globals.mesh, modelName(model));
+    createMeshVAO(globals.mesh, modelName(model), &globals.meshVAO);
+    CGTK_TRACE_SCOPE("SilhouetteEdges::build");
+    globals.silhouetteEdges.build(globals.mesh.vertices, globals.mesh.indices, globals.crease_angle);
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    globals.metrics.loadSeconds[model] = time.count();
 }
 
 void initializeTrackball(void)
 {
     double radius = double(std::min(globals.width, globals.height)) / 2.0;
-    globals.trackball.setRadius(radius);
+    input.trackball.setRadius(radius);
     glm::vec2 center = glm::vec2(globals.width, globals.height) / 2.0f;
-    globals.trackball.setCenter(center);
+    input.trackball.setCenter(center);
 }
 
 void init(void)
 {
+    CGTK_TRACE_FUNCTION();
+
     glClearColor(globals.bg_color.x, globals.bg_color.y, globals.bg_color.z, 1.0);
 
+    globals.program.setName("mesh");
+    globals.silhouetteProgram.setName("silhouette fins");
+    globals.hullProgram.setName("inverted hull");
     loadProgram(shaderDir() + "mesh.vert",
                 shaderDir() + "mesh.frag",
                 &globals.program);
+    loadProgram(shaderDir() + "silhouette.vert",
+                shaderDir() + "silhouette.geom",
+                shaderDir() + "edge_quad.frag",
+                &globals.silhouetteProgram);
 
-    loadMesh((modelDir() + "bunny.obj"), &globals.mesh);
-    createMeshVAO(globals.mesh, &globals.meshVAO);
+    loadProgram(shaderDir() + "hull.vert",
+                shaderDir() + "edge_quad.frag",
+                &globals.hullProgram);
 
-    initializeTrackball();
+    loadModel(globals.model);
+
+    globals.toonRamps.init(NUM_TOON_RAMPS);
+
+    if (!globals.jumpFlood.init(shaderDir())) {
+        std::exit(EXIT_FAILURE);
+    }
+    globals.jumpFlood.resize(globals.width, globals.height);
+
+    if (!globals.silhouetteQuads.init(shaderDir())) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    if (!globals.overdrawHeatMap.init(shaderDir())) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    globals.gpuProfiler.init(NUM_PROFILED_FRAMES);
+    if (!globals.gpuProfiler.setPipelineStatistics(globals.pipeline_statistics)) {
+        std::cerr << "Pipeline statistics are not supported (ARB_pipeline_statistics_query)." << std::endl;
+        globals.pipeline_statistics = false;
+    }
+}
+
+// Position of the eye in world space
+const glm::vec3 EYE_POSITION(0.0f, 0.0f, 1.5f);
+
+glm::mat4 modelMatrix(void)
+{
+    glm::mat4 turntable = glm::rotate(glm::mat4(1.0f), globals.turntable_angle, glm::vec3(0.0f, 1.0f, 0.0f));
+    return turntable * globals.rotation;
+}
+
+glm::mat4 viewMatrix(void)
+{
+    return glm::lookAt(EYE_POSITION, glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+glm::mat4 projectionMatrix(void)
+{
+    if (globals.tile.z == 0) {
+        return glm::perspective(90.0f+globals.zoomfactor, (float) globals.width/globals.height, 0.1f, 100.0f);
+    }
+
+    // The frustum of the whole image, narrowed to the tile by scaling
+    // and translating the tile's part of normalized device coordinates
+    // to [-1, 1]
+    glm::vec2 image(globals.image_size);
+    glm::mat4 projection = glm::perspective(90.0f+globals.zoomfactor, image.x/image.y, 0.1f, 100.0f);
+    glm::mat4 crop(1.0f);
+    crop[0][0] = image.x / globals.tile.z;
+    crop[1][1] = image.y / globals.tile.w;
+    crop[3][0] = (image.x - 2.0f * globals.tile.x - globals.tile.z) / globals.tile.z;
+    crop[3][1] = (image.y - 2.0f * globals.tile.y - globals.tile.w) / globals.tile.w;
+    return crop * projection;
+}
+
+// Returns the style of a toon ramp. Ramp 0 uses the tweakbar
+// parameters, the others are variations of it.
+ToonStyle toonStyle(int index)
+{
+    ToonStyle style;
+    style.ambientColor = globals.ambientColor;
+    style.diffuseColor = globals.diffuseColor;
+    style.material_kd = globals.material_kd;
+    style.colorlvl = globals.colorlvl;
+
+    if (index == 1 || index == 2) {
+        // Rotate the color channels
+        for (int i = 0; i < index; i++) {
+            style.ambientColor = glm::vec3(style.ambientColor.z, style.ambientColor.x, style.ambientColor.y);
+            style.diffuseColor = glm::vec3(style.diffuseColor.z, style.diffuseColor.x, style.diffuseColor.y);
+        }
+    }
+    else if (index == 3) {
+        // Classic two-tone
+        style.colorlvl = 2;
+    }
+    return style;
+}
+
+// Regenerates the toon ramps whose parameters changed and uploads them
+void updateToonRamps(void)
+{
+    CGTK_TRACE_FUNCTION();
+    for (int i = 0; i < globals.toonRamps.getNumRamps(); i++) {
+        globals.toonRamps.setStyle(i, toonStyle(i));
+    }
+    globals.toonRamps.upload();
 }
 
 // MODIFY THIS FUNCTION
-void drawMesh(cgtk::GLSLProgram &program, const MeshVAO &meshVAO)
+void drawMesh(cgtk::GLSLProgram &program, const MeshVAO &meshVAO, int numInstances = 1)
 {
 
-    glm::mat4 model = globals.trackball.getRotationMatrix() * glm::mat4(1.0f);
-    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 0.0f, 1.5f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-    glm::mat4 projection = glm::perspective(90.0f+globals.zoomfactor, (float) globals.width/globals.height, 0.1f, 100.0f);
+    glm::mat4 model = modelMatrix();
+    glm::mat4 view = viewMatrix();
+    glm::mat4 projection = projectionMatrix();
 
     glm::mat4 mvp = projection * view * model;
     glm::mat4 mv = view * model;
@@ -229,113 +985,344 @@ void drawMesh(cgtk::GLSLProgram &program, const MeshVAO &meshVAO)
     program.setUniformMatrix4f("view", view);
     program.setUniformMatrix4f("model", model);
     program.setUniform3f("lightDir", globals.lightDir);
-    program.setUniform3f("eye_position", glm::vec3(0.0f, 0.0f, 1.5f));
-    program.setUniform1f("material_kd", globals.material_kd);
+    program.setUniformMatrix4f("view_projection", projection * view);
+    program.setUniform3f("eye_position", EYE_POSITION);
     program.setUniform1f("outline_intensity", globals.outline_intensity);
+    program.setUniform1i("edge_detection", globals.outlineMode == OUTLINE_FRAGMENT);
+
+    program.setUniform3f("outlineColor", globals.outlineColor);
+
+    globals.toonRamps.bind(0);
+    program.setUniform1i("toonRamps", 0);
+    program.setUniform1i("ramp", globals.ramp);
+    program.setUniform1i("num_ramps", globals.toonRamps.getNumRamps());
+    program.setUniform1f("instance_spacing", globals.instance_spacing);
+
+
+    // All instances, each with its own toon style, in one draw call
+    glBindVertexArray(meshVAO.vao);
+    glDrawElementsInstanced(GL_TRIANGLES, meshVAO.numIndices, GL_UNSIGNED_INT, 0, numInstances);
+    countDraw((long long) meshVAO.numIndices * numInstances, (long long) meshVAO.numIndices / 3 * numInstances);
+    glBindVertexArray(0);
+
+    program.disable();
+
+}
+
+// Offset of an instance in world space, as in mesh.vert: the instances
+// are placed alternately right and left of instance 0
+glm::vec3 instanceOffset(int instance)
+{
+    int k = (instance + 1) / 2;
+    return glm::vec3(float(instance % 2 == 1 ? k : -k) * globals.instance_spacing, 0.0f, 0.0f);
+}
+
+void drawSilhouetteEdges(void)
+{
+    // The silhouette is searched in object space, once per instance
+    // since each sees the eye from elsewhere. The statistics are the
+    // sums over the instances.
+    glm::mat4 model = modelMatrix();
+    glm::mat4 viewProjection = projectionMatrix() * viewMatrix();
+    double extractTime = 0.0;
+    globals.silhouette_tested = 0;
+    globals.silhouette_drawn = 0;
+    for (int i = 0; i < globals.instances; i++) {
+        glm::mat4 instanceModel = glm::translate(glm::mat4(1.0f), instanceOffset(i)) * model;
+        glm::vec3 eye = glm::vec3(glm::inverse(instanceModel) * glm::vec4(EYE_POSITION, 1.0f));
+        {
+            CGTK_TRACE_SCOPE("silhouette extraction");
+            auto start = std::chrono::steady_clock::now();
+            if (globals.silhouette_brute_force) {
+                globals.silhouetteEdges.extractBruteForce(eye, globals.silhouetteLines);
+            }
+            else {
+                globals.silhouetteEdges.extract(eye, globals.silhouetteLines);
+            }
+            std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+            extractTime += time.count();
+        }
+        globals.silhouette_tested += globals.silhouetteEdges.getNumTestedEdges();
+        globals.silhouette_drawn += globals.silhouetteLines.size() / 2;
+
+        globals.silhouetteQuads.update(globals.mesh.vertices, globals.silhouetteLines);
+        globals.silhouetteQuads.draw(viewProjection * instanceModel, glm::vec2(globals.width, globals.height),
+                                     globals.outline_width, globals.outlineColor);
+    }
+    globals.silhouette_time = extractTime;
+}
+
+// Draws silhouette fins emitted by the geometry shader in one pass
+// over the triangles-with-adjacency index buffer
+void drawSilhouetteFins(cgtk::GLSLProgram &program, const MeshVAO &meshVAO, int numInstances = 1)
+{
+    glm::mat4 viewProjection = projectionMatrix() * viewMatrix();
+    glm::mat4 mvp = viewProjection * modelMatrix();
 
-    program.setUniform3f("diffuseColor", globals.diffuseColor);
-    program.setUniform3f("ambientColor", globals.ambientColor);
+    program.enable();
+    program.setUniformMatrix4f("mvp", mvp);
+    program.setUniformMatrix4f("view_projection", viewProjection);
+    program.setUniform1f("instance_spacing", globals.instance_spacing);
+    program.setUniform2f("viewport", glm::vec2(globals.width, globals.height));
+    program.setUniform1f("line_width", globals.outline_width);
     program.setUniform3f("outlineColor", globals.outlineColor);
 
-    program.setUniform1i("colorlvl", globals.colorlvl);
+    glBindVertexArray(meshVAO.adjacencyVAO);
+    glDrawElementsInstanced(GL_TRIANGLES_ADJACENCY, meshVAO.numAdjacencyIndices, GL_UNSIGNED_INT, 0, numInstances);
+    countDraw((long long) meshVAO.numAdjacencyIndices * numInstances,
+              (long long) meshVAO.numAdjacencyIndices / 6 * numInstances);
+    glBindVertexArray(0);
+
+    program.disable();
+}
+
+// Draws the back faces of the mesh extruded along its normals, which
+// shows up as an outline of constant width around the model
+void drawInvertedHull(cgtk::GLSLProgram &program, const MeshVAO &meshVAO, int numInstances = 1)
+{
+    glm::mat4 projection = projectionMatrix();
+    glm::mat4 viewProjection = projection * viewMatrix();
+    glm::mat4 mvp = viewProjection * modelMatrix();
+
+    // An offset d at clip-space w covers d * projection[1][1] / w in
+    // normalized device coordinates, i.e., half the viewport height
+    // times that in pixels
+    float offset = globals.outline_width * 2.0f / (globals.height * projection[1][1]);
 
+    program.enable();
+    program.setUniformMatrix4f("mvp", mvp);
+    program.setUniform1f("hull_offset", offset);
+    program.setUniformMatrix4f("view_projection", viewProjection);
+    program.setUniform1f("instance_spacing", globals.instance_spacing);
+    program.setUniform3f("outlineColor", globals.outlineColor);
 
+    glEnable(GL_CULL_FACE);
+    glCullFace(GL_FRONT);
     glBindVertexArray(meshVAO.vao);
-    glDrawElements(GL_TRIANGLES, meshVAO.numIndices, GL_UNSIGNED_INT, 0);
+    glDrawElementsInstanced(GL_TRIANGLES, meshVAO.numIndices, GL_UNSIGNED_INT, 0, numInstances);
+    countDraw((long long) meshVAO.numIndices * numInstances, (long long) meshVAO.numIndices / 3 * numInstances);
     glBindVertexArray(0);
+    glCullFace(GL_BACK);
+    glDisable(GL_CULL_FACE);
 
     program.disable();
+}
+
+// Recomputes the rotation of a drag of the trackball from the newest
+// cursor position, which may have arrived after the snapshot being
+// drawn was published. Called after the work of the frame that does
+// not depend on the rotation, as drivers often wait for the previous
+// swap in the first call that touches the back buffer, and right
+// before the draw calls, which only need new matrix uniforms.
+void latchRotation(void)
+{
+    if (!globals.late_latch || !globals.trackball.tracking()) {
+        return;
+    }
+    input.cursor.update();
+    const CursorSample &sample = input.cursor.getReadBuffer();
+    if (sample.drag != globals.drag || sample.events <= globals.input_events) {
+        return;
+    }
+    cgtk::Trackball trackball = globals.trackball;
+    trackball.move(sample.point);
+    globals.rotation = trackball.getRotationMatrix();
+    globals.latched_events = sample.events;
+}
 
+// The framebuffer display() draws into, known without asking OpenGL
+GLuint targetFramebuffer(void)
+{
+    return globals.offscreen ? globals.offscreen->getFramebuffer() : 0;
 }
 
+// The passes are timed on the GPU by the profiler when it is in a frame.
+// With the overdraw heat map, the fragments of all passes are counted
+// and the heat map replaces the image at the end.
 void display(void)
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    CGTK_TRACE_FUNCTION();
+    cgtk::PerfScope perf("frame submission");
+    {
+        CGTK_TRACE_SCOPE("clear");
+        GpuScope scope(globals.gpuProfiler, "clear");
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        if (globals.overdraw) {
+            globals.overdrawHeatMap.begin();
+        }
+    }
 
     glEnable(GL_DEPTH_TEST); // ensures that polygons overlap correctly
-    drawMesh(globals.program, globals.meshVAO);
 
+    updateToonRamps();
+    latchRotation();
+
+    if (globals.outlineMode == OUTLINE_JUMP_FLOOD) {
+        // Rasterize the silhouette mask that seeds the jump flood
+        CGTK_TRACE_SCOPE("seed");
+        GpuScope scope(globals.gpuProfiler, "seed");
+        globals.jumpFlood.beginSeed(targetFramebuffer());
+        drawMesh(globals.jumpFlood.getSeedProgram(), globals.meshVAO, globals.instances);
+        globals.jumpFlood.endSeed();
+    }
+
+    {
+        CGTK_TRACE_SCOPE("mesh");
+        GpuScope scope(globals.gpuProfiler, "mesh");
+        drawMesh(globals.program, globals.meshVAO, globals.instances);
+    }
+
+    {
+        CGTK_TRACE_SCOPE("outline");
+        GpuScope scope(globals.gpuProfiler, "outline");
+        if (globals.outlineMode == OUTLINE_JUMP_FLOOD) {
+            globals.jumpFlood.draw(targetFramebuffer(), globals.outlineColor, globals.outline_width);
+        }
+        else if (globals.outlineMode == OUTLINE_SILHOUETTE_EDGES) {
+            drawSilhouetteEdges();
+        }
+        else if (globals.outlineMode == OUTLINE_GEOMETRY_SHADER) {
+            drawSilhouetteFins(globals.silhouetteProgram, globals.meshVAO, globals.instances);
+        }
+        else if (globals.outlineMode == OUTLINE_INVERTED_HULL) {
+            drawInvertedHull(globals.hullProgram, globals.meshVAO, globals.instances);
+        }
+    }
+
+    if (globals.overdraw) {
+        CGTK_TRACE_SCOPE("overdraw");
+        GpuScope scope(globals.gpuProfiler, "overdraw");
+        globals.overdrawHeatMap.end();
+    }
+
+    perf.stop(globals.meshVAO.numVertices * globals.instances,
+              globals.meshVAO.numIndices / 3 * globals.instances);
 }
 
 
+// The tweakbar callbacks run with input.mutex held, on the input
+// thread or inside TwDraw()
 void TW_CALL setDifflvl(const void *value, void *clientData)
 {
-  globals.material_kd = *(const float *) value;
+  input.params.material_kd = *(const float *) value;
+  invalidate();
 }
 
 void TW_CALL getDifflvl(void *value, void *clientData)
 {
-  *(float *)value = globals.material_kd;  // for instance
+  *(float *)value = input.params.material_kd;  // for instance
 }
 
 void TW_CALL setOutlinelvl(const void *value, void *clientData)
 {
-  globals.outline_intensity = *(const float *) value;
+  input.params.outline_intensity = *(const float *) value;
+  invalidate();
 }
 
 void TW_CALL getOutlinelvl(void *value, void *clientData)
 {
-  *(float *)value = globals.outline_intensity;  // for instance
+  *(float *)value = input.params.outline_intensity;  // for instance
 }
 
 
 void TW_CALL setColorlvl(const void *value, void *clientData)
 {
-  globals.colorlvl = *(const int *) value;
+  input.params.colorlvl = *(const int *) value;
+  invalidate();
 }
 
 void TW_CALL getColorlvl(void *value, void *clientData)
 {
-  *(int *)value = globals.colorlvl;  // for instance
+  *(int *)value = input.params.colorlvl;  // for instance
 }
 
 
 void TW_CALL setLightXpos(const void *value, void *clientData)
 {
-  globals.lightDir.x = *(const float *) value;
+  input.params.lightDir.x = *(const float *) value;
+  invalidate();
 }
 
 void TW_CALL getLightXpos(void *value, void *clientData)
 {
-  *(float *)value = globals.lightDir.x;  // for instance
+  *(float *)value = input.params.lightDir.x;  // for instance
 }
 
 void TW_CALL setLightYpos(const void *value, void *clientData)
 {
-  globals.lightDir.y = *(const float *) value;
+  input.params.lightDir.y = *(const float *) value;
+  invalidate();
 }
 
 void TW_CALL getLightYpos(void *value, void *clientData)
 {
-  *(float *)value = globals.lightDir.y;  // for instance
+  *(float *)value = input.params.lightDir.y;  // for instance
 }
 
 void TW_CALL setLightZpos(const void *value, void *clientData)
 {
-  globals.lightDir.z = *(const float *) value;
+  input.params.lightDir.z = *(const float *) value;
+  invalidate();
 }
 
 void TW_CALL getLightZpos(void *value, void *clientData)
 {
-  *(float *)value = globals.lightDir.z;  // for instance
+  *(float *)value = input.params.lightDir.z;  // for instance
+}
+
+void TW_CALL setCreaseAngle(const void *value, void *clientData)
+{
+  input.params.crease_angle = *(const float *) value;
+  invalidate();
+}
+
+void TW_CALL getCreaseAngle(void *value, void *clientData)
+{
+  *(float *)value = input.params.crease_angle;
+}
+
+void TW_CALL setModel(const void *value, void *clientData)
+{
+  input.params.model = *(const int *) value;
+  invalidate();
+}
+
+void TW_CALL getModel(void *value, void *clientData)
+{
+  *(int *)value = input.params.model;
+}
+
+void TW_CALL setVsync(const void *value, void *clientData)
+{
+  input.params.vsync = *(const bool *) value;
+  invalidate();
+}
+
+void TW_CALL getVsync(void *value, void *clientData)
+{
+  *(bool *)value = input.params.vsync;
 }
 
 void TW_CALL setBgcolorCallBack(const void *value, void *clientData)
 {
-  globals.bg_color = *(const glm::vec3 *)value;
-  glClearColor(globals.bg_color.x, globals.bg_color.y, globals.bg_color.z, 1.0);
+  input.params.bg_color = *(const glm::vec3 *)value;
+  invalidate();
 }
 
 void TW_CALL getBgcolorCallBack(void *value, void *clientData)
 {
-  *(glm::vec3 *)value = globals.bg_color;  // for instance
+  *(glm::vec3 *)value = input.params.bg_color;  // for instance
 }
 
 // MODIFY THIS FUNCTION
 void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods)
 {
-  if( !TwEventKeyGLFW(key, action) )  // Send event to AntTweakBar
+  InputLock lock(input.inputWaits);
+  bool handled = TwEventKeyGLFW(key, action);  // Send event to AntTweakBar
+  recordEvent(INPUT_RECORD_KEY, handled, key, scancode, action, mods, 0.0f, 0.0f);
+  if( handled )
   {
+    inputEvent();
   }
     // Define your keyboard shortcuts here
 }
@@ -343,31 +1330,48 @@ void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods
 void mouseButtonPressed(int button, int x, int y)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        globals.trackball.setCenter(glm::vec2(x, y));
-        globals.trackball.startTracking(glm::vec2(x, y));
+        input.trackball.setCenter(glm::vec2(x, y));
+        input.trackball.startTracking(glm::vec2(x, y));
+        input.params.drag++;
     }
 }
 
 void mouseButtonReleased(int button, int x, int y)
 {
     if (button == GLFW_MOUSE_BUTTON_LEFT) {
-        globals.trackball.stopTracking();
+        input.trackball.stopTracking();
     }
 }
 
-void scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+void zoom(double yoffset)
 {
   //if(globals.zoomfactor > -90.f && globals.zoomfactor < 90.f)
-    globals.zoomfactor += yoffset;
+    input.params.zoomfactor += yoffset;
   //else
   //  globals.zoomfactor = 89.f;
+    inputEvent();
+}
+
+void scrollCallback(GLFWwindow* window, double xoffset, double yoffset)
+{
+    InputLock lock(input.inputWaits);
+    recordEvent(INPUT_RECORD_SCROLL, false, 0, 0, 0, 0, xoffset, yoffset);
+    zoom(yoffset);
 }
 
 void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 {
     double x, y;
     glfwGetCursorPos(window, &x, &y);
-    if(!TwEventMouseButtonGLFW(button, action)){
+    InputLock lock(input.inputWaits);
+    input.params.tweakbar_pressed = false;
+    bool handled = TwEventMouseButtonGLFW(button, action);
+    recordEvent(INPUT_RECORD_MOUSE_BUTTON, handled, button, action, mods, 0, x, y);
+    if (handled) {
+      input.params.tweakbar_pressed = action == GLFW_PRESS;
+      inputEvent();
+    }
+    else {
       if (action == GLFW_PRESS) {
           mouseButtonPressed(button, x, y);
       }
@@ -379,65 +1383,2407 @@ void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
 
 void moveTrackball(int x, int y)
 {
-    if (globals.trackball.tracking()) {
-        globals.trackball.move(glm::vec2(x, y));
+    if (input.trackball.tracking()) {
+        input.trackball.move(glm::vec2(x, y));
+        input.params.rotation = input.trackball.getRotationMatrix();
+        inputEvent(true);
+
+        // The snapshot waits for the rest of the events, the cursor
+        // position is passed on right away for late latching
+        CursorSample &sample = input.cursor.getWriteBuffer();
+        sample.point = glm::vec2(x, y);
+        sample.drag = input.params.drag;
+        sample.events = input.params.input_events;
+        input.cursor.publish();
     }
 }
 
 void cursorPosCallback(GLFWwindow* window, double x, double y)
 {
-  if( !TwEventMousePosGLFW(x, y) )  // Send event to AntTweakBar
+  InputLock lock(input.inputWaits);
+  bool handled = TwEventMousePosGLFW(x, y);  // Send event to AntTweakBar
+  recordEvent(INPUT_RECORD_CURSOR_POS, handled, 0, 0, 0, 0, x, y);
+  if( !handled )
   {
     moveTrackball(x, y);
   }
+  else {
+    inputEvent();
+  }
+}
+
+// The render thread resizes the framebuffer-sized resources when it
+// gets the new size
+void resizeView(int width, int height)
+{
+    input.params.width = width;
+    input.params.height = height;
+    input.trackball.setRadius(double(std::min(width, height)) / 2.0);
+    input.trackball.setCenter(glm::vec2(width, height) / 2.0f);
+    inputEvent();
 }
 
 void framebufferSizeCallback(GLFWwindow *window, int width, int height)
 {
-    globals.width = width;
-    globals.height = height;
-    globals.trackball.setRadius(double(std::min(width, height)) / 2.0);
-    globals.trackball.setCenter(glm::vec2(width, height) / 2.0f);
-    glViewport(0, 0, width, height);
+    InputLock lock(input.inputWaits);
+    recordEvent(INPUT_RECORD_FRAMEBUFFER_SIZE, false, width, height, 0, 0, 0.0f, 0.0f);
+    resizeView(width, height);
 }
 
-int main(void)
+// Applies a record of an input log as if its event happened now. The
+// events the tweakbar handled are skipped, the parameter records
+// written after them repeat their effect. Called with input.mutex held.
+void replayRecord(const InputRecord &record)
 {
-    // Create window and load extensions
-    glfwSetErrorCallback(errorCallback);
-    if (!glfwInit()) {
-        std::exit(EXIT_FAILURE);
+    switch (record.type) {
+    case INPUT_RECORD_MOUSE_BUTTON:
+        if (!record.tweakbar && record.args[1] == GLFW_PRESS) {
+            mouseButtonPressed(record.args[0], record.values[0], record.values[1]);
+        }
+        else if (!record.tweakbar) {
+            mouseButtonReleased(record.args[0], record.values[0], record.values[1]);
+        }
+        break;
+    case INPUT_RECORD_CURSOR_POS:
+        if (!record.tweakbar) {
+            moveTrackball(record.values[0], record.values[1]);
+        }
+        break;
+    case INPUT_RECORD_SCROLL:
+        zoom(record.values[1]);
+        break;
+    case INPUT_RECORD_FRAMEBUFFER_SIZE:
+        resizeView(record.args[0], record.args[1]);
+        break;
+    case INPUT_RECORD_PARAMETER: {
+        // Parameters that were added after the log was written keep
+        // their values
+        ParameterWriter writer;
+        writer.values = record.values;
+        ParameterReader reader;
+        if (visitParameter(&input.params, record.args[0], reader) && reader.numValues == record.args[1]) {
+            visitParameter(&input.params, record.args[0], writer);
+            invalidate();
+        }
+        break;
     }
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-    GLFWwindow* window = glfwCreateWindow(globals.width, globals.height,
-        "Toon shading", NULL, NULL);
-    if (!window) {
-        glfwTerminate();
-        std::exit(EXIT_FAILURE);
+    default:
+        break;
     }
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+}
 
-    glewExperimental = GL_TRUE;
-    GLenum status = glewInit();
-    if (status != GLEW_OK) {
-        std::cerr << "Error: " << glewGetErrorString(status) << std::endl;
-        std::exit(EXIT_FAILURE);
-    }
-    std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+void windowRefreshCallback(GLFWwindow *window)
+{
+    InputLock lock(input.inputWaits);
+    invalidate();
+}
 
-    glfwSetKeyCallback(window, keyCallback);
-    glfwSetMouseButtonCallback(window, mouseButtonCallback);
-    glfwSetCursorPosCallback(window, cursorPosCallback);
-    glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
-    glfwSetScrollCallback(window, scrollCallback);
+// Returns the view parameters of the globals
+ViewParams currentViewParams(void)
+{
+    ViewParams params;
+    params.width = globals.width;
+    params.height = globals.height;
+    params.rotation = globals.rotation;
+    params.zoomfactor = globals.zoomfactor;
+    params.lightDir = globals.lightDir;
+    params.material_kd = globals.material_kd;
+    params.outline_intensity = globals.outline_intensity;
+    params.bg_color = globals.bg_color;
+    params.colorlvl = globals.colorlvl;
+    params.outlineMode = globals.outlineMode;
+    params.outline_width = globals.outline_width;
+    params.silhouette_brute_force = globals.silhouette_brute_force;
+    params.crease_angle = globals.crease_angle;
+    params.vsync = globals.vsync;
+    params.diffuseColor = globals.diffuseColor;
+    params.ambientColor = globals.ambientColor;
+    params.outlineColor = globals.outlineColor;
+    params.ramp = globals.ramp;
+    params.instances = globals.instances;
+    params.model = globals.model;
+    params.pipeline_statistics = globals.pipeline_statistics;
+    params.overdraw = globals.overdraw;
+    params.continuous_redraw = false;
+    params.tweakbar_pressed = false;
+    params.late_latch = globals.late_latch;
+    params.trackball = globals.trackball;
+    params.drag = globals.drag;
+    params.input_events = globals.input_events;
+    return params;
+}
 
-    TwInit(TW_OPENGL_CORE, NULL);
+// Prints the percentiles of the input latency
+void reportLatency(void)
+{
+    if (globals.latency.getCount() == 0) {
+        return;
+    }
+    std::cout << "Input latency: " << globals.latency.getPercentile(50.0) << " ms median, "
+              << globals.latency.getPercentile(99.0) << " ms 99th percentile, "
+              << globals.latency.getMax() << " ms maximum over " << globals.latency.getCount() << " events ("
+              << (globals.single_thread ? "single thread" : "separate render thread") << ", late latching "
+              << (globals.late_latch ? "on" : "off") << ")" << std::endl;
+    if (!globals.single_thread) {
+        const char *names[] = { "input", "render" };
+        const LockWaits *waits[] = { &input.inputWaits, &input.renderWaits };
+        for (int i = 0; i < 2; i++) {
+            std::cout << "Waits of the " << names[i] << " thread for the input mutex: " << waits[i]->count
+                      << ", " << waits[i]->totalNanoseconds / 1.0e6 << " ms in total, "
+                      << waits[i]->maxNanoseconds / 1.0e6 << " ms maximum" << std::endl;
+        }
+    }
+}
+
+// Copies a snapshot of the view parameters to the globals and updates
+// what depends on them. Runs on the render thread.
+void applyViewParams(const ViewParams &params)
+{
+    CGTK_TRACE_FUNCTION();
+    if (params.width != globals.width || params.height != globals.height) {
+        globals.width = params.width;
+        globals.height = params.height;
+        glViewport(0, 0, params.width, params.height);
+        globals.jumpFlood.resize(params.width, params.height);
+    }
+    bool creaseChanged = params.crease_angle != globals.crease_angle;
+    globals.crease_angle = params.crease_angle;
+    if (params.model != globals.model) {
+        deleteMeshVAO(&globals.meshVAO);
+        loadModel(params.model);
+    }
+    else if (creaseChanged) {
+        globals.silhouetteEdges.build(globals.mesh.vertices, globals.mesh.indices, globals.crease_angle);
+    }
+    if (params.vsync != globals.vsync) {
+        globals.vsync = params.vsync;
+        glfwSwapInterval(globals.vsync ? 1 : 0);
+    }
+    if (params.bg_color != globals.bg_color) {
+        globals.bg_color = params.bg_color;
+        glClearColor(globals.bg_color.x, globals.bg_color.y, globals.bg_color.z, 1.0);
+    }
+    globals.rotation = params.rotation;
+    globals.zoomfactor = params.zoomfactor;
+    globals.lightDir = params.lightDir;
+    globals.material_kd = params.material_kd;
+    globals.outline_intensity = params.outline_intensity;
+    globals.colorlvl = params.colorlvl;
+    globals.outlineMode = params.outlineMode;
+    globals.outline_width = params.outline_width;
+    globals.silhouette_brute_force = params.silhouette_brute_force;
+    globals.diffuseColor = params.diffuseColor;
+    globals.ambientColor = params.ambientColor;
+    globals.outlineColor = params.outlineColor;
+    globals.ramp = params.ramp;
+    globals.instances = params.instances;
+    globals.trackball = params.trackball;
+    globals.drag = params.drag;
+    globals.input_events = params.input_events;
+    globals.overdraw = params.overdraw;
+    if (params.pipeline_statistics != globals.pipeline_statistics) {
+        globals.pipeline_statistics = params.pipeline_statistics;
+        globals.gpuProfiler.setPipelineStatistics(globals.pipeline_statistics);
+    }
+
+    // The percentiles are restarted to compare with and without late
+    // latching
+    if (params.late_latch != globals.late_latch) {
+        reportLatency();
+        globals.late_latch = params.late_latch;
+        globals.latency.reset();
+    }
+}
+
+// Hands the parameters of the input thread to the render thread and
+// wakes it up. Called with input.mutex held.
+void publishViewParams(void)
+{
+    CGTK_TRACE_FUNCTION();
+    recordParameters(false);
+    input.params.trackball = input.trackball;
+    input.snapshots.getWriteBuffer() = input.params;
+    input.snapshots.publish();
+    input.dirty = false;
+    {
+        std::lock_guard<std::mutex> lock(input.wakeMutex);
+    }
+    input.wake.notify_one();
+}
+
+// Measures the latency of the input events that the frame just
+// swapped shows for the first time: those of its snapshot, and the
+// cursor moves after them that were late latched. Other events after
+// the snapshot wait for the next one. Runs on the render thread.
+void recordLatency(unsigned snapshotEvents, unsigned latchedEvents, std::chrono::steady_clock::time_point swap)
+{
+    unsigned newest = std::max(snapshotEvents, latchedEvents);
+    while (int(newest - globals.events_shown) > 0) {
+        unsigned index = globals.events_shown;
+        std::chrono::steady_clock::time_point time;
+        bool cursor;
+        bool valid = readInputEvent(index, &time, &cursor);
+        if (valid && !cursor && int(index - snapshotEvents) >= 0) {
+            break;
+        }
+        globals.events_shown++;
+        if (!valid) {
+            continue;
+        }
+
+        double latency = std::chrono::duration<double, std::milli>(swap - time).count();
+        globals.latency.add(latency);
+        if (globals.latency_log.is_open()) {
+            globals.latency_log << std::chrono::duration<double, std::milli>(time - globals.latency_epoch).count() << ","
+                                << std::chrono::duration<double, std::milli>(swap - globals.latency_epoch).count() << ","
+                                << latency << "," << cursor << "," << (int(index - snapshotEvents) >= 0) << "\n";
+        }
+    }
+    globals.latency_p50 = globals.latency.getPercentile(50.0);
+    globals.latency_p99 = globals.latency.getPercentile(99.0);
+}
+
+// Labels of the pipeline statistics in the Perf bar
+const char *STATISTIC_LABELS[NUM_PIPELINE_STATISTICS] = {
+    "vertex shaders", "fragment shaders", "clipper in", "clipper out"
+};
+
+// Average fragment shader invocations per pixel of the frame
+double fragmentsPerPixel(const GpuProfiler &profiler)
+{
+    if (profiler.getNumStatisticFrames() == 0) {
+        return 0.0;
+    }
+    return profiler.getAverageStatistic(0, FRAGMENT_SHADER_INVOCATIONS) / (double(globals.width) * globals.height);
+}
+
+// Gathers the values of the Perf bar from the profiler and the audit.
+// Called on the render thread without input.mutex, since the
+// percentiles take a while.
+void collectPerfValues(PerfValues *values)
+{
+    GpuProfiler &profiler = globals.gpuProfiler;
+    values->numPasses = std::min(profiler.getNumPasses(), MAX_PERF_PASSES);
+    for (int i = 0; i < values->numPasses; i++) {
+        values->times[i][0] = profiler.getAverage(i);
+        values->times[i][1] = profiler.getPercentile(i, 99.0);
+        for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+            values->statistics[i][j] = profiler.getAverageStatistic(i, PipelineStatistic(j));
+        }
+    }
+    values->fragmentsPerPixel = fragmentsPerPixel(profiler);
+    values->dropped = profiler.getNumDropped();
+    values->glCalls[0] = cgtk::GLAudit::getNumCalls();
+    values->glCalls[1] = cgtk::GLAudit::getNumSyncCalls();
+    values->glCalls[2] = cgtk::GLAudit::getNumRedundantCalls();
+}
+
+// Copies the values to the Perf bar, adding the passes that are new.
+// Called with input.mutex held.
+void updatePerfBar(const PerfValues &values)
+{
+    GpuProfiler &profiler = globals.gpuProfiler;
+    input.perf = values;
+    for (int i = input.numPerfPasses; i < values.numPasses && input.perfBar; i++) {
+        std::string name = profiler.getPassName(i);
+        std::string def = "group='" + name + "' precision=3 label=";
+        TwAddVarRO(input.perfBar, (name + " avg").c_str(), TW_TYPE_DOUBLE, &input.perf.times[i][0], (def + "'avg (ms)'").c_str());
+        TwAddVarRO(input.perfBar, (name + " p99").c_str(), TW_TYPE_DOUBLE, &input.perf.times[i][1], (def + "'p99 (ms)'").c_str());
+        if (profiler.isPipelineStatisticsSupported()) {
+            def = "group='" + name + "' precision=0 label=";
+            for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+                TwAddVarRO(input.perfBar, (name + " " + STATISTIC_LABELS[j]).c_str(), TW_TYPE_DOUBLE,
+                           &input.perf.statistics[i][j], (def + "'" + STATISTIC_LABELS[j] + "'").c_str());
+            }
+        }
+    }
+    input.numPerfPasses = std::max(input.numPerfPasses, values.numPasses);
+}
+
+// Stores the video memory reported by the driver, if it does. Needs
+// the context to be current.
+void sampleDriverMemory(void)
+{
+    cgtk::DriverMemory memory;
+    GLint kilobytes[4] = { 0, 0, 0, 0 };
+    if (GLEW_NVX_gpu_memory_info) {
+        glGetIntegerv(GL_GPU_MEMORY_INFO_DEDICATED_VIDMEM_NVX, kilobytes);
+        glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, kilobytes + 1);
+        memory.total = 1024.0 * kilobytes[0];
+        memory.available = 1024.0 * kilobytes[1];
+    }
+    else if (GLEW_ATI_meminfo) {
+        // The free memory of the texture pool, its largest free block
+        // and the same of the auxiliary memory. There is no total.
+        glGetIntegerv(GL_TEXTURE_FREE_MEMORY_ATI, kilobytes);
+        memory.total = -1.0;
+        memory.available = 1024.0 * kilobytes[0];
+    }
+    else {
+        return;
+    }
+    cgtk::MemoryRegistry::setDriverMemory(memory);
+}
+
+// Copies the memory of the registry to the Memory bar, adding the
+// assets and categories that are new. Called with input.mutex held.
+// The registry is only read after it changed, which is rare once the
+// model is loaded.
+void updateMemoryBar(void)
+{
+    unsigned generation = cgtk::MemoryRegistry::getGeneration();
+    if (generation == input.memoryGeneration) {
+        return;
+    }
+    input.memoryGeneration = generation;
+    const double MB = 1024.0 * 1024.0;
+    input.memoryTotals[0] = cgtk::MemoryRegistry::getTotalBytes(false) / MB;
+    input.memoryTotals[1] = cgtk::MemoryRegistry::getTotalBytes(false, true) / MB;
+    input.memoryTotals[2] = cgtk::MemoryRegistry::getTotalBytes(true) / MB;
+    input.memoryTotals[3] = cgtk::MemoryRegistry::getTotalBytes(true, true) / MB;
+    cgtk::DriverMemory driver;
+    if (cgtk::MemoryRegistry::getDriverMemory(&driver)) {
+        input.driverMemory[0] = driver.total / MB;
+        input.driverMemory[1] = driver.available / MB;
+    }
+
+    std::vector<cgtk::MemoryUsage> usages = cgtk::MemoryRegistry::getUsages();
+    std::vector<std::string> &names = input.memoryUsageNames;
+    for (size_t i = 0; i < usages.size(); i++) {
+        const char *category = cgtk::MemoryRegistry::getCategoryName(usages[i].category);
+        std::string name = usages[i].asset + " " + category;
+        size_t j = std::find(names.begin(), names.end(), name) - names.begin();
+        if (j == names.size()) {
+            if (j == size_t(MAX_MEMORY_USAGES)) {
+                continue;
+            }
+            names.push_back(name);
+            if (input.memoryBar) {
+                std::string def = "group='" + usages[i].asset + "' precision=2 label=";
+                TwAddVarRO(input.memoryBar, name.c_str(), TW_TYPE_DOUBLE, &input.memoryUsages[j][0],
+                           (def + "'" + category + " (MB)'").c_str());
+                TwAddVarRO(input.memoryBar, (name + " peak").c_str(), TW_TYPE_DOUBLE, &input.memoryUsages[j][1],
+                           (def + "'" + category + " peak (MB)'").c_str());
+            }
+        }
+        input.memoryUsages[j][0] = usages[i].bytes / MB;
+        input.memoryUsages[j][1] = usages[i].peak / MB;
+    }
+}
+
+// Writes the memory of the assets with --memory-report. The driver is
+// asked for its video memory first if the context is current.
+void writeMemoryReport(bool contextCurrent)
+{
+    if (globals.memory_report.empty()) {
+        return;
+    }
+    if (contextCurrent) {
+        sampleDriverMemory();
+    }
+    std::ofstream file(globals.memory_report.c_str());
+    cgtk::MemoryRegistry::writeJson(file);
+    file.close();
+    if (file.fail()) {
+        std::cerr << "Error: Could not write " << globals.memory_report << std::endl;
+    }
+    else {
+        std::cout << "Wrote memory report to " << globals.memory_report << std::endl;
+    }
+}
+
+// Prints the GPU times of the passes
+void reportGpuProfile(void)
+{
+    GpuProfiler &profiler = globals.gpuProfiler;
+    profiler.finish();
+    if (profiler.getNumFrames() == 0) {
+        return;
+    }
+    std::cout << "GPU time per frame, over the last frames of " << profiler.getNumFrames()
+              << " measured (" << profiler.getNumDropped() << " dropped):" << std::endl;
+    for (int i = 0; i < profiler.getNumPasses(); i++) {
+        std::cout << "  " << profiler.getPassName(i) << ": " << profiler.getAverage(i) << " ms average, "
+                  << profiler.getPercentile(i, 99.0) << " ms 99th percentile" << std::endl;
+    }
+    if (profiler.getNumStatisticFrames() == 0) {
+        return;
+    }
+    std::cout << "Pipeline statistics per frame, over the last frames of " << profiler.getNumStatisticFrames()
+              << " counted (" << fragmentsPerPixel(profiler) << " fragments per pixel):" << std::endl;
+    for (int i = 0; i < profiler.getNumPasses(); i++) {
+        std::cout << "  " << profiler.getPassName(i) << ":";
+        for (int j = 0; j < NUM_PIPELINE_STATISTICS; j++) {
+            std::cout << (j > 0 ? ", " : " ") << profiler.getAverageStatistic(i, PipelineStatistic(j))
+                      << " " << STATISTIC_LABELS[j];
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Writes the CPU scopes recorded with --trace
+void writeTrace(void)
+{
+    cgtk::Trace::setEnabled(false);
+    if (cgtk::Trace::write(globals.trace_file)) {
+        std::cout << "Wrote CPU trace to " << globals.trace_file << std::endl;
+    }
+    else {
+        std::cerr << "Error: Could not write " << globals.trace_file << std::endl;
+    }
+}
+
+// Records CPU scopes from now on. The trace is written at exit, which
+// is a call to std::exit on every path.
+void startTrace(const std::string &filename)
+{
+#ifdef CGTK_NO_TRACE
+    std::cerr << "Warning: Built with tracing disabled (TRACE=OFF)" << std::endl;
+#endif
+    globals.trace_file = filename;
+    cgtk::Trace::setEnabled(true);
+    CGTK_TRACE_THREAD("main");
+    std::atexit(writeTrace);
+}
+
+// Prints the CPU events counted with --perf-counters
+void reportPerfCounters(void)
+{
+    cgtk::PerfCounters::report(std::cout);
+}
+
+// Counts CPU events in the loader and render regions from now on. They
+// are reported at exit, like the trace.
+void startPerfCounters(void)
+{
+    if (!cgtk::PerfCounters::setEnabled(true)) {
+        std::cerr << "Warning: Could not open the CPU counters with perf_event_open, see "
+                  << "/proc/sys/kernel/perf_event_paranoid" << std::endl;
+        return;
+    }
+    std::atexit(reportPerfCounters);
+}
+
+// Prints the GL calls per frame counted with --gl-audit
+void reportGLAudit(void)
+{
+    cgtk::GLAudit::report(std::cout);
+}
+
+// Reads the resident and peak resident memory of the process in MB,
+// which are zero where /proc is not available
+void residentMemory(double *resident, double *peak)
+{
+    *resident = 0.0;
+    *peak = 0.0;
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        double kilobytes = std::atof(line.c_str() + std::min(line.size(), size_t(6)));
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            *resident = kilobytes / 1024.0;
+        }
+        else if (line.compare(0, 6, "VmHWM:") == 0) {
+            *peak = kilobytes / 1024.0;
+        }
+    }
+}
+
+// Copies the memory of the registry to the metrics. Takes the mutex of
+// the registry, so it is only called after the memory changed.
+void copyMemoryMetrics(FrameMetrics *m)
+{
+    for (int gpu = 0; gpu < 2; gpu++) {
+        m->memoryTotals[gpu][0] = cgtk::MemoryRegistry::getTotalBytes(gpu != 0);
+        m->memoryTotals[gpu][1] = cgtk::MemoryRegistry::getTotalBytes(gpu != 0, true);
+    }
+    cgtk::DriverMemory driver;
+    m->driverAvailable = cgtk::MemoryRegistry::getDriverMemory(&driver) ? driver.available : -1.0;
+    std::vector<cgtk::MemoryUsage> usages = cgtk::MemoryRegistry::getUsages();
+    m->numAssets = std::min(int(usages.size()), MAX_MEMORY_USAGES);
+    for (int i = 0; i < m->numAssets; i++) {
+        AssetMetrics &asset = m->assets[i];
+        std::strncpy(asset.asset, usages[i].asset.c_str(), MAX_METRICS_NAME - 1);
+        asset.asset[MAX_METRICS_NAME - 1] = '\0';
+        asset.category = usages[i].category;
+        asset.bytes = usages[i].bytes;
+    }
+}
+
+// Adds a frame that took seconds to the metrics and publishes them to
+// the metrics server. Runs on the render thread, which never waits for
+// the server.
+void publishMetrics(double seconds)
+{
+    if (!globals.metricsServer.isRunning()) {
+        return;
+    }
+    FrameMetrics &m = globals.metrics;
+    m.frames++;
+    int bucket = 0;
+    while (bucket < NUM_FRAME_TIME_BUCKETS - 1 && seconds > FRAME_TIME_BUCKETS[bucket]) {
+        bucket++;
+    }
+    m.frameTimeCounts[bucket]++;
+    m.frameTimeSum += seconds;
+    m.drawCalls = drawStats.drawCalls;
+    m.triangles = drawStats.triangles;
+    m.drawCallsTotal += drawStats.drawCalls;
+    m.trianglesTotal += drawStats.triangles;
+    m.edges = globals.silhouetteEdges.getNumEdges();
+    m.extractions = globals.outlineMode == OUTLINE_SILHOUETTE_EDGES ? globals.instances : 0;
+    m.edgesTested = m.extractions > 0 ? globals.silhouette_tested : 0;
+    m.edgesDrawn = m.extractions > 0 ? globals.silhouette_drawn : 0;
+    const GpuProfiler &profiler = globals.gpuProfiler;
+    m.numPasses = std::min(profiler.getNumPasses(), MAX_PERF_PASSES);
+    for (int i = 0; i < m.numPasses; i++) {
+        std::strncpy(m.passNames[i], profiler.getPassName(i), MAX_METRICS_NAME - 1);
+        m.passNames[i][MAX_METRICS_NAME - 1] = '\0';
+        m.passTimes[i][0] = profiler.getAverage(i) / 1000.0;
+        m.passTimes[i][1] = profiler.getPercentile(i, 99.0) / 1000.0;
+    }
+    unsigned generation = cgtk::MemoryRegistry::getGeneration();
+    if (generation != m.memoryGeneration) {
+        copyMemoryMetrics(&m);
+        m.memoryGeneration = generation;
+    }
+    globals.metrics_snapshots.getWriteBuffer() = m;
+    globals.metrics_snapshots.publish();
+}
+
+// Writes a label value, escaped as in the Prometheus text format
+std::string metricsLabel(const std::string &value)
+{
+    std::string escaped;
+    for (size_t i = 0; i < value.size(); i++) {
+        if (value[i] == '\\' || value[i] == '"') {
+            escaped += '\\';
+            escaped += value[i];
+        }
+        else if (value[i] == '\n') {
+            escaped += "\\n";
+        }
+        else {
+            escaped += value[i];
+        }
+    }
+    return escaped;
+}
+
+// Writes the HELP and TYPE lines of a metric
+void metricsHeader(std::ostream &out, const char *name, const char *type, const char *help)
+{
+    out << "# HELP " << name << " " << help << "\n"
+        << "# TYPE " << name << " " << type << "\n";
+}
+
+// Formats the newest published metrics in the Prometheus text format.
+// Runs on the thread of the metrics server, and only reads the
+// snapshot, so it never holds a lock the render thread takes.
+std::string formatMetrics(void)
+{
+    globals.metrics_snapshots.update();
+    const FrameMetrics &m = globals.metrics_snapshots.getReadBuffer();
+    std::ostringstream out;
+    out << std::setprecision(9);
+
+    metricsHeader(out, "toon_frames_total", "counter", "Frames drawn.");
+    out << "toon_frames_total " << m.frames << "\n";
+
+    metricsHeader(out, "toon_frame_seconds", "histogram", "CPU time of a frame up to its swap or end.");
+    long long count = 0;
+    for (int i = 0; i < NUM_FRAME_TIME_BUCKETS; i++) {
+        count += m.frameTimeCounts[i];
+        out << "toon_frame_seconds_bucket{le=\"";
+        if (i < NUM_FRAME_TIME_BUCKETS - 1) {
+            out << FRAME_TIME_BUCKETS[i];
+        }
+        else {
+            out << "+Inf";
+        }
+        out << "\"} " << count << "\n";
+    }
+    out << "toon_frame_seconds_sum " << m.frameTimeSum << "\n"
+        << "toon_frame_seconds_count " << count << "\n";
+
+    if (m.numPasses > 0) {
+        metricsHeader(out, "toon_gpu_pass_seconds", "gauge", "GPU time of a pass over the recent frames.");
+        for (int i = 0; i < m.numPasses; i++) {
+            std::string pass = metricsLabel(m.passNames[i]);
+            out << "toon_gpu_pass_seconds{pass=\"" << pass << "\",stat=\"mean\"} " << m.passTimes[i][0] << "\n"
+                << "toon_gpu_pass_seconds{pass=\"" << pass << "\",stat=\"p99\"} " << m.passTimes[i][1] << "\n";
+        }
+    }
+
+    metricsHeader(out, "toon_draw_calls", "gauge", "Draw calls of the last frame.");
+    out << "toon_draw_calls " << m.drawCalls << "\n";
+    metricsHeader(out, "toon_draw_calls_total", "counter", "Draw calls of all frames.");
+    out << "toon_draw_calls_total " << m.drawCallsTotal << "\n";
+    metricsHeader(out, "toon_triangles", "gauge", "Triangles submitted in the last frame.");
+    out << "toon_triangles " << m.triangles << "\n";
+    metricsHeader(out, "toon_triangles_total", "counter", "Triangles submitted in all frames.");
+    out << "toon_triangles_total " << m.trianglesTotal << "\n";
+
+    // The tested and drawn edges only exist while the silhouette edges
+    // are the outline, so they are left out otherwise rather than
+    // repeating the values of the last such frame
+    metricsHeader(out, "toon_silhouette_edges", "gauge",
+                  "Edges of the silhouette hierarchy, and those tested and drawn by the last frame over all instances.");
+    out << "toon_silhouette_edges{kind=\"all\"} " << m.edges << "\n";
+    if (m.extractions > 0) {
+        out << "toon_silhouette_edges{kind=\"tested\"} " << m.edgesTested << "\n"
+            << "toon_silhouette_edges{kind=\"drawn\"} " << m.edgesDrawn << "\n";
+        if (m.edges > 0) {
+            metricsHeader(out, "toon_silhouette_culled_ratio", "gauge",
+                          "Fraction of the edges the hierarchy culled without testing them, over all instances.");
+            out << "toon_silhouette_culled_ratio "
+                << 1.0 - double(m.edgesTested) / (double(m.edges) * m.extractions) << "\n";
+        }
+    }
+
+    metricsHeader(out, "toon_model_load_seconds", "gauge",
+                  "Time of the last load of a model, including its mesh upload and hierarchy.");
+    for (int i = 0; i < NUM_MODELS; i++) {
+        if (m.loadSeconds[i] > 0.0) {
+            out << "toon_model_load_seconds{model=\"" << modelName(i) << "\"} " << m.loadSeconds[i] << "\n";
+        }
+    }
+
+    metricsHeader(out, "toon_memory_bytes", "gauge", "Memory of the meshes (cpu) and OpenGL objects (gpu).");
+    out << "toon_memory_bytes{kind=\"cpu\"} " << m.memoryTotals[0][0] << "\n"
+        << "toon_memory_bytes{kind=\"gpu\"} " << m.memoryTotals[1][0] << "\n";
+    metricsHeader(out, "toon_memory_peak_bytes", "gauge", "High-water mark of toon_memory_bytes.");
+    out << "toon_memory_peak_bytes{kind=\"cpu\"} " << m.memoryTotals[0][1] << "\n"
+        << "toon_memory_peak_bytes{kind=\"gpu\"} " << m.memoryTotals[1][1] << "\n";
+    metricsHeader(out, "toon_asset_memory_bytes", "gauge", "Memory of an asset in a category.");
+    for (int i = 0; i < m.numAssets; i++) {
+        out << "toon_asset_memory_bytes{asset=\"" << metricsLabel(m.assets[i].asset) << "\",category=\""
+            << cgtk::MemoryRegistry::getCategoryName(m.assets[i].category) << "\"} " << m.assets[i].bytes << "\n";
+    }
+    if (m.driverAvailable >= 0.0) {
+        metricsHeader(out, "toon_driver_available_bytes", "gauge", "Free video memory reported by the driver.");
+        out << "toon_driver_available_bytes " << (long long)(m.driverAvailable) << "\n";
+    }
+
+    double resident;
+    double peak;
+    residentMemory(&resident, &peak);
+    if (resident > 0.0) {
+        metricsHeader(out, "toon_resident_memory_bytes", "gauge", "Resident memory of the process.");
+        out << "toon_resident_memory_bytes " << (long long)(resident * 1024.0 * 1024.0) << "\n";
+    }
+    return out.str();
+}
+
+// Draws a frame with the newest view parameters if they changed or the
+// view is redrawn continuously. Returns false if there was nothing to
+// draw. Runs on the render thread.
+bool drawFrame(GLFWwindow *window)
+{
+    CGTK_TRACE_FUNCTION();
+    bool fresh = input.snapshots.update();
+    const ViewParams &params = input.snapshots.getReadBuffer();
+    if (!fresh && !params.continuous_redraw && !params.tweakbar_pressed) {
+        globals.drew_last = false;
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+    bool resized = params.width != globals.width || params.height != globals.height;
+    if (fresh) {
+        applyViewParams(params);
+    }
+
+    globals.latched_events = 0;
+    std::chrono::duration<double> sinceSampled = std::chrono::steady_clock::now() - globals.memory_sampled;
+    if (sinceSampled.count() >= DRIVER_MEMORY_PERIOD) {
+        sampleDriverMemory();
+        globals.memory_sampled = std::chrono::steady_clock::now();
+    }
+    resetDrawStats();
+    cgtk::GLAudit::beginFrame();
+    globals.gpuProfiler.beginFrame();
+    display();
+    PerfValues perf;
+    collectPerfValues(&perf);
+    bool dirty;
+    {
+        InputLock lock(input.renderWaits);
+        if (resized) {
+            TwWindowSize(globals.width, globals.height);
+        }
+        updatePerfBar(perf);
+        updateMemoryBar();
+        CGTK_TRACE_SCOPE("TwDraw");
+        GpuScope scope(globals.gpuProfiler, "tweakbar");
+        TwDraw();
+        dirty = input.dirty;
+    }
+    // AntTweakBar changes the state behind the back of the audit
+    cgtk::GLAudit::invalidate();
+    globals.gpuProfiler.endFrame();
+    cgtk::GLAudit::endFrame(&std::cout);
+    {
+        CGTK_TRACE_SCOPE("glfwSwapBuffers");
+        glfwSwapBuffers(window);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    recordLatency(globals.input_events, globals.latched_events, now);
+    publishMetrics(std::chrono::duration<double>(now - start).count());
+
+    // Smoothed time between swaps of consecutive frames, turn on
+    // continuous redraw and turn off vsync to compare the cost of the
+    // outline modes
+    if (globals.drew_last) {
+        double time = std::chrono::duration<double, std::milli>(now - globals.last_swap).count();
+        globals.frame_time = 0.9 * globals.frame_time + 0.1 * time;
+    }
+    globals.last_swap = now;
+    globals.drew_last = true;
+
+    // The tweakbar changed a parameter while drawing, e.g., because a
+    // button is held. The input thread publishes it.
+    if (dirty) {
+        glfwPostEmptyEvent();
+    }
+    return true;
+}
+
+// Draws frames until the input thread quits. The render thread owns the
+// OpenGL context and sleeps while there is nothing new to draw.
+void renderLoop(GLFWwindow *window)
+{
+    CGTK_TRACE_THREAD("render");
+    glfwMakeContextCurrent(window);
+    while (!input.quit) {
+        if (!drawFrame(window)) {
+            std::unique_lock<std::mutex> lock(input.wakeMutex);
+            while (!input.snapshots.hasUpdate() && !input.quit) {
+                input.wake.wait(lock);
+            }
+        }
+    }
+    glfwMakeContextCurrent(NULL);
+}
+
+// Compares the normal cone hierarchy against testing every edge, for
+// eye positions spread evenly around the armadillo and gargo models
+void benchmarkSilhouettes(void)
+{
+    const char *models[] = { "armadillo.obj", "gargo.obj" };
+    const int numEyes = 256;
+    const int numRepetitions = 10;
+
+    std::vector<glm::vec3> eyes;
+    for (int i = 0; i < numEyes; i++) {
+        float z = 1.0f - 2.0f * (i + 0.5f) / numEyes;
+        float r = std::sqrt(1.0f - z * z);
+        float phi = 2.39996323f * i;
+        eyes.push_back(glm::length(EYE_POSITION) * glm::vec3(r * std::cos(phi), r * std::sin(phi), z));
+    }
+
+    for (int m = 0; m < 2; m++) {
+        Mesh mesh;
+        loadMesh(modelDir() + models[m], &mesh);
+
+        SilhouetteEdges edges;
+        auto buildStart = std::chrono::steady_clock::now();
+        edges.build(mesh.vertices, mesh.indices, globals.crease_angle);
+        std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+        std::cout << models[m] << ": " << edges.getNumEdges() << " edges, "
+                  << edges.getNumFeatureEdges() << " feature edges, build "
+                  << buildTime.count() << " ms" << std::endl;
+
+        std::vector<uint32_t> lines;
+        const char *names[] = { "hierarchy  ", "brute force" };
+        for (int method = 0; method < 2; method++) {
+            double best = 1e30;
+            long tested = 0;
+            long drawn = 0;
+            for (int rep = 0; rep < numRepetitions; rep++) {
+                tested = 0;
+                drawn = 0;
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < numEyes; i++) {
+                    if (method == 0) {
+                        edges.extract(eyes[i], lines);
+                    }
+                    else {
+                        edges.extractBruteForce(eyes[i], lines);
+                    }
+                    tested += edges.getNumTestedEdges();
+                    drawn += lines.size() / 2;
+                }
+                std::chrono::duration<double, std::milli> time = std::chrono::steady_clock::now() - start;
+                best = std::min(best, time.count() / numEyes);
+            }
+            std::cout << "  " << names[method] << ": " << best << " ms, "
+                      << tested / numEyes << " edges tested, "
+                      << drawn / numEyes << " edges drawn" << std::endl;
+        }
+    }
+}
+
+// Loads the OpenGL entry points for the current context
+bool loadExtensions(void)
+{
+    CGTK_TRACE_FUNCTION();
+    glewExperimental = GL_TRUE;
+    GLenum status;
+    {
+        CGTK_TRACE_SCOPE("glewInit");
+        status = glewInit();
+    }
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // GLEW built for GLX also looks for a GLX display, which an EGL
+    // context does not have. The GL entry points are loaded anyway.
+    if (status == GLEW_ERROR_NO_GLX_DISPLAY) {
+        status = GLEW_OK;
+    }
+#endif
+    if (status != GLEW_OK) {
+        std::cerr << "Error: " << glewGetErrorString(status) << std::endl;
+        return false;
+    }
+    // glewExperimental can leave a GL_INVALID_ENUM behind
+    glGetError();
+    std::cout << "OpenGL version: " << glGetString(GL_VERSION) << std::endl;
+    std::cout << "OpenGL renderer: " << glGetString(GL_RENDERER) << std::endl;
+    if (globals.gl_audit) {
+        if (!cgtk::GLAudit::isInstalled()) {
+            std::atexit(reportGLAudit);
+        }
+        cgtk::GLAudit::install();
+    }
+    return true;
+}
+
+// Settings of one headless or turntable rendering job. The defaults
+// are those of the interactive viewer.
+struct RenderJob {
+    std::string output;
+    std::string gif;
+    std::string poster;
+    int tileSize;
+    GifSettings gifSettings;
+    std::string video;
+    VideoFormat videoFormat;
+    int fps;
+    int model;
+    int numFrames;
+    int width;
+    int height;
+    glm::vec3 diffuseColor;
+    glm::vec3 ambientColor;
+    glm::vec3 outlineColor;
+    float material_kd;
+    int colorlvl;
+    OutlineMode outlineMode;
+    float outline_width;
+
+    RenderJob()
+    {
+        model = globals.model;
+        tileSize = 1024;
+        videoFormat = VIDEO_FORMAT_Y4M;
+        fps = 25;
+        numFrames = 100;
+        width = globals.width;
+        height = globals.height;
+        diffuseColor = globals.diffuseColor;
+        ambientColor = globals.ambientColor;
+        outlineColor = globals.outlineColor;
+        material_kd = globals.material_kd;
+        colorlvl = globals.colorlvl;
+        outlineMode = globals.outlineMode;
+        outline_width = globals.outline_width;
+    }
+};
+
+const char *OUTLINE_MODE_NAMES[] = {
+    "fragment", "jump-flood", "silhouette-edges", "geometry-shader", "inverted-hull"
+};
+
+bool parseColor(const std::string &value, glm::vec3 *color)
+{
+    return std::sscanf(value.c_str(), "%f,%f,%f", &color->x, &color->y, &color->z) == 3;
+}
+
+// Parses the option at args[*i] (and its value) into the job. Returns
+// false if the option is unknown or its value is malformed.
+bool parseJobOption(const std::vector<std::string> &args, size_t *i, RenderJob *job)
+{
+    const std::string &arg = args[*i];
+    if (*i + 1 >= args.size()) {
+        return false;
+    }
+    const std::string &value = args[++*i];
+
+    if (arg == "--turntable") {
+        job->output = value;
+        return true;
+    }
+    if (arg == "--gif") {
+        job->gif = value;
+        return true;
+    }
+    if (arg == "--gif-delay") {
+        job->gifSettings.delay = std::atoi(value.c_str());
+        return job->gifSettings.delay >= 0;
+    }
+    if (arg == "--gif-palette") {
+        job->gifSettings.palette = value == "global" ? GIF_PALETTE_GLOBAL : GIF_PALETTE_LOCAL;
+        return value == "global" || value == "local";
+    }
+    if (arg == "--video") {
+        job->video = value;
+        return true;
+    }
+    if (arg == "--video-format") {
+        job->videoFormat = value == "rgb" ? VIDEO_FORMAT_RGB : VIDEO_FORMAT_Y4M;
+        return value == "rgb" || value == "y4m";
+    }
+    if (arg == "--fps") {
+        job->fps = std::atoi(value.c_str());
+        return job->fps > 0;
+    }
+    if (arg == "--poster") {
+        job->poster = value;
+        return true;
+    }
+    if (arg == "--tile") {
+        job->tileSize = std::atoi(value.c_str());
+        return job->tileSize >= 16;
+    }
+    if (arg == "--model") {
+        for (int m = 0; m < int(sizeof(MODEL_FILENAMES) / sizeof(MODEL_FILENAMES[0])); m++) {
+            if (value + ".obj" == MODEL_FILENAMES[m]) {
+                job->model = m;
+                return true;
+            }
+        }
+        return false;
+    }
+    if (arg == "--frames") {
+        job->numFrames = std::atoi(value.c_str());
+        return job->numFrames > 0;
+    }
+    if (arg == "--size") {
+        return std::sscanf(value.c_str(), "%dx%d", &job->width, &job->height) == 2 &&
+               job->width > 0 && job->height > 0;
+    }
+    if (arg == "--diffuse") {
+        return parseColor(value, &job->diffuseColor);
+    }
+    if (arg == "--ambient") {
+        return parseColor(value, &job->ambientColor);
+    }
+    if (arg == "--outline-color") {
+        return parseColor(value, &job->outlineColor);
+    }
+    if (arg == "--kd") {
+        job->material_kd = std::atof(value.c_str());
+        return true;
+    }
+    if (arg == "--levels") {
+        job->colorlvl = std::atoi(value.c_str());
+        return job->colorlvl >= 2 && job->colorlvl <= 6;
+    }
+    if (arg == "--outline") {
+        for (int mode = OUTLINE_FRAGMENT; mode <= OUTLINE_INVERTED_HULL; mode++) {
+            if (value == OUTLINE_MODE_NAMES[mode]) {
+                job->outlineMode = OutlineMode(mode);
+                return true;
+            }
+        }
+        return false;
+    }
+    if (arg == "--outline-width") {
+        job->outline_width = std::atof(value.c_str());
+        return job->outline_width >= 1.0f;
+    }
+    return false;
+}
+
+// Checks whether a job writes anything, i.e., has --turntable, --gif,
+// --video or --poster
+bool hasJobOutput(const RenderJob &job)
+{
+    return !job.output.empty() || !job.gif.empty() || !job.video.empty() || !job.poster.empty();
+}
+
+// Reads a jobs file, where each non-empty line that does not start with
+// '#' holds the options of one job, which must write an output
+bool readJobsFile(const std::string &filename, std::vector<RenderJob> *jobs)
+{
+    std::ifstream file(filename.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not open jobs file " << filename << std::endl;
+        return false;
+    }
+    std::string line;
+    for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+        std::istringstream stream(line);
+        std::vector<std::string> args;
+        std::string arg;
+        while (stream >> arg) {
+            args.push_back(arg);
+        }
+        if (args.empty() || args[0][0] == '#') {
+            continue;
+        }
+        RenderJob job;
+        for (size_t i = 0; i < args.size(); i++) {
+            if (!parseJobOption(args, &i, &job)) {
+                std::cerr << "Error: Invalid option " << args[i] << " on line "
+                          << lineNumber << " of " << filename << std::endl;
+                return false;
+            }
+        }
+        if (!hasJobOutput(job)) {
+            std::cerr << "Error: No --turntable, --gif, --video or --poster on line "
+                      << lineNumber << " of " << filename << std::endl;
+            return false;
+        }
+        jobs->push_back(job);
+    }
+    return true;
+}
+
+// Extra pixels rendered on each side of a poster tile, so that the
+// outlines of silhouettes just outside the tile reach into it
+int posterMargin(const RenderJob &job)
+{
+    return int(std::ceil(job.outline_width)) + 2;
+}
+
+// Copies the settings of a job to the globals. Does not touch any GL
+// resources. The framebuffer of a poster job has the size of a tile.
+void applyJob(const RenderJob &job)
+{
+    globals.model = job.model;
+    globals.width = job.width;
+    globals.height = job.height;
+    if (!job.poster.empty()) {
+        globals.width = std::min(job.tileSize, job.width) + 2 * posterMargin(job);
+        globals.height = std::min(job.tileSize, job.height) + 2 * posterMargin(job);
+    }
+    globals.diffuseColor = job.diffuseColor;
+    globals.ambientColor = job.ambientColor;
+    globals.outlineColor = job.outlineColor;
+    globals.material_kd = job.material_kd;
+    globals.colorlvl = job.colorlvl;
+    globals.outlineMode = job.outlineMode;
+    globals.outline_width = job.outline_width;
+}
+
+// Creates the offscreen context and initializes rendering for the
+// first job
+bool initHeadless(OffscreenContext *context, const RenderJob &job)
+{
+    auto createStart = std::chrono::steady_clock::now();
+    if (!context->create() || !loadExtensions()) {
+        return false;
+    }
+    std::chrono::duration<double, std::milli> createTime = std::chrono::steady_clock::now() - createStart;
+    std::cout << "Context creation (" << context->getPlatformName() << "): "
+              << createTime.count() << " ms" << std::endl;
+
+    applyJob(job);
+    globals.offscreen = context;
+    context->resize(globals.width, globals.height);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_BLEND);
+    init();
+    return true;
+}
+
+// Renders numFrames frames into an offscreen framebuffer, without
+// creating a window or the tweakbar
+void runHeadless(const RenderJob &job)
+{
+    OffscreenContext context;
+    if (!initHeadless(&context, job)) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    // The first frame compiles shader variants and uploads the ramps,
+    // so it is timed separately
+    auto start = std::chrono::steady_clock::now();
+    display();
+    glFinish();
+    std::chrono::duration<double, std::milli> firstTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 1; i < job.numFrames; i++) {
+        auto frameStart = std::chrono::steady_clock::now();
+        resetDrawStats();
+        cgtk::GLAudit::beginFrame();
+        display();
+        cgtk::GLAudit::endFrame(&std::cout);
+        publishMetrics(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count());
+    }
+    glFinish();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    std::cout << "First frame: " << firstTime.count() << " ms" << std::endl;
+    if (job.numFrames > 1) {
+        std::cout << job.numFrames - 1 << " frames at " << globals.width << "x" << globals.height
+                  << " in " << time.count() << " s (" << (job.numFrames - 1) / time.count()
+                  << " fps)" << std::endl;
+    }
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error: OpenGL error 0x" << std::hex << error << std::dec << std::endl;
+    }
+    writeMemoryReport(true);
+    context.destroy();
+}
+
+// An input log replayed on a fixed timestep, one frame per step
+struct Replay {
+    std::vector<InputRecord> records;
+    size_t next;
+    double step;
+    int numFrames;
+    int frame;
+    LatencyHistogram frameTimes;
+
+    Replay()
+    {
+        next = 0;
+        step = 1.0 / 60.0;
+        numFrames = 0;
+        frame = 0;
+    }
+};
+
+// Reads an input log. The replay lasts until the last record.
+bool loadReplay(const std::string &filename, Replay *replay)
+{
+    InputLogReader reader;
+    if (!reader.open(filename)) {
+        std::cerr << "Error: " << filename << " is not an input log" << std::endl;
+        return false;
+    }
+    InputRecord record;
+    while (reader.read(&record)) {
+        replay->records.push_back(record);
+    }
+    if (reader.failed()) {
+        std::cerr << "Warning: " << filename << " ends in the middle of a record" << std::endl;
+    }
+    double duration = replay->records.empty() ? 0.0 : replay->records.back().time;
+    replay->numFrames = int(duration / replay->step) + 1;
+    return true;
+}
+
+// Applies the records up to the time of the next frame and publishes
+// the view parameters. Returns false after the last frame.
+bool replayStep(Replay *replay)
+{
+    if (replay->frame >= replay->numFrames) {
+        return false;
+    }
+    double time = replay->frame * replay->step;
+    std::lock_guard<std::mutex> lock(input.mutex);
+    while (replay->next < replay->records.size() && replay->records[replay->next].time <= time) {
+        replayRecord(replay->records[replay->next++]);
+    }
+    // Frames are drawn as fast as they can be, whatever was recorded
+    input.params.vsync = false;
+    publishViewParams();
+    replay->frame++;
+    return true;
+}
+
+// Adds the time since the previous frame of the replay. The first
+// frame, which compiles the shaders, has none.
+void addReplayFrameTime(Replay *replay, std::chrono::steady_clock::time_point *last)
+{
+    auto now = std::chrono::steady_clock::now();
+    if (replay->frame > 1) {
+        replay->frameTimes.add(std::chrono::duration<double, std::milli>(now - *last).count());
+    }
+    *last = now;
+}
+
+void reportReplay(const Replay &replay, std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    std::cout << "Replay: " << replay.frame << " frames of " << replay.step * 1000.0 << " ms of input in "
+              << time.count() << " s, frame time " << replay.frameTimes.getPercentile(50.0) << " ms median, "
+              << replay.frameTimes.getPercentile(99.0) << " ms 99th percentile, "
+              << replay.frameTimes.getMean() << " ms mean" << std::endl;
+}
+
+// Returns the framebuffer size of the log, or the default if it
+// records none
+glm::ivec2 replaySize(const Replay &replay, glm::ivec2 size)
+{
+    for (size_t i = 0; i < replay.records.size(); i++) {
+        if (replay.records[i].type == INPUT_RECORD_FRAMEBUFFER_SIZE) {
+            return glm::ivec2(replay.records[i].args[0], replay.records[i].args[1]);
+        }
+    }
+    return size;
+}
+
+// Replays an input log in the window, drawing a frame per step with
+// vsync off. The events of the window are ignored.
+void runReplay(GLFWwindow *window, Replay *replay)
+{
+    glm::ivec2 size = replaySize(*replay, glm::ivec2(globals.width, globals.height));
+    glfwSetWindowSize(window, size.x, size.y);
+
+    auto start = std::chrono::steady_clock::now();
+    auto last = start;
+    while (!glfwWindowShouldClose(window) && replayStep(replay)) {
+        drawFrame(window);
+        addReplayFrameTime(replay, &last);
+        glfwPollEvents();
+    }
+    reportReplay(*replay, start);
+}
+
+// Replays an input log without a window or the tweakbar, e.g., to
+// compare the frame times of two builds on a server. Each frame is
+// finished before the next one starts. With checksum, each frame is
+// read back instead and a CRC of all of them is printed, which is
+// the same for every run of the same log and build.
+void runHeadlessReplay(RenderJob job, Replay *replay, bool checksum)
+{
+    glm::ivec2 size = replaySize(*replay, glm::ivec2(job.width, job.height));
+    job.width = size.x;
+    job.height = size.y;
+    OffscreenContext context;
+    if (!initHeadless(&context, job)) {
+        std::exit(EXIT_FAILURE);
+    }
+    globals.vsync = false;
+    input.params = currentViewParams();
+    initializeTrackball();
+
+    uLong crc = crc32(0, Z_NULL, 0);
+    std::vector<unsigned char> pixels;
+    auto start = std::chrono::steady_clock::now();
+    auto last = start;
+    while (replayStep(replay)) {
+        CGTK_TRACE_SCOPE("replay frame");
+        input.snapshots.update();
+        const ViewParams &params = input.snapshots.getReadBuffer();
+        if (params.width != globals.width || params.height != globals.height) {
+            context.resize(params.width, params.height);
+        }
+        applyViewParams(params);
+        auto frameStart = std::chrono::steady_clock::now();
+        resetDrawStats();
+        cgtk::GLAudit::beginFrame();
+        globals.gpuProfiler.beginFrame();
+        display();
+        globals.gpuProfiler.endFrame();
+        cgtk::GLAudit::endFrame(&std::cout);
+        publishMetrics(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count());
+        if (checksum) {
+            pixels.resize(size_t(globals.width) * globals.height * 4);
+            glReadPixels(0, 0, globals.width, globals.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+            crc = crc32(crc, &pixels[0], pixels.size());
+        }
+        else {
+            glFinish();
+        }
+        addReplayFrameTime(replay, &last);
+    }
+    reportReplay(*replay, start);
+    reportGpuProfile();
+    if (checksum) {
+        std::cout << "Checksum: " << std::hex << crc << std::dec << std::endl;
+    }
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error: OpenGL error 0x" << std::hex << error << std::dec << std::endl;
+    }
+    writeMemoryReport(true);
+    context.destroy();
+}
+
+// Frames drawn before each case of the frame benchmark is measured
+const int BENCHMARK_WARMUP_FRAMES = 5;
+
+// Settings of the frame benchmark: every model is drawn at every size
+// with every outline mode, turning once around the vertical axis
+struct FrameBenchmark {
+    std::string output;
+    std::string baseline;
+    double threshold;  // percent
+    std::vector<int> models;
+    std::vector<glm::ivec2> sizes;
+    std::vector<int> outlineModes;
+
+    FrameBenchmark()
+    {
+        threshold = 10.0;
+        for (int m = 0; m < int(sizeof(MODEL_FILENAMES) / sizeof(MODEL_FILENAMES[0])); m++) {
+            models.push_back(m);
+        }
+        sizes.push_back(glm::ivec2(640, 480));
+        sizes.push_back(glm::ivec2(1280, 720));
+        for (int mode = OUTLINE_FRAGMENT; mode <= OUTLINE_INVERTED_HULL; mode++) {
+            outlineModes.push_back(mode);
+        }
+    }
+};
+
+// Splits a comma-separated list
+std::vector<std::string> splitList(const std::string &value)
+{
+    std::vector<std::string> items;
+    std::istringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+// Parses the option at args[*i] (and its value) into the benchmark
+// settings. Returns false if the option is not one of them or its
+// value is malformed.
+bool parseBenchmarkOption(const std::vector<std::string> &args, size_t *i, FrameBenchmark *bench)
+{
+    const std::string &arg = args[*i];
+    if (arg.compare(0, 12, "--benchmark-") != 0 || *i + 1 >= args.size()) {
+        return false;
+    }
+    std::vector<std::string> items = splitList(args[++*i]);
+    if (arg == "--benchmark-baseline") {
+        bench->baseline = args[*i];
+        return true;
+    }
+    if (arg == "--benchmark-threshold") {
+        bench->threshold = std::atof(args[*i].c_str());
+        return bench->threshold > 0.0;
+    }
+    if (arg == "--benchmark-models") {
+        bench->models.clear();
+        for (size_t j = 0; j < items.size(); j++) {
+            int m = 0;
+            while (m < int(sizeof(MODEL_FILENAMES) / sizeof(MODEL_FILENAMES[0])) &&
+                   items[j] + ".obj" != MODEL_FILENAMES[m]) {
+                m++;
+            }
+            if (m == int(sizeof(MODEL_FILENAMES) / sizeof(MODEL_FILENAMES[0]))) {
+                return false;
+            }
+            bench->models.push_back(m);
+        }
+        return !bench->models.empty();
+    }
+    if (arg == "--benchmark-sizes") {
+        bench->sizes.clear();
+        for (size_t j = 0; j < items.size(); j++) {
+            glm::ivec2 size;
+            if (std::sscanf(items[j].c_str(), "%dx%d", &size.x, &size.y) != 2 ||
+                size.x <= 0 || size.y <= 0) {
+                return false;
+            }
+            bench->sizes.push_back(size);
+        }
+        return !bench->sizes.empty();
+    }
+    if (arg == "--benchmark-outlines") {
+        bench->outlineModes.clear();
+        for (size_t j = 0; j < items.size(); j++) {
+            int mode = OUTLINE_FRAGMENT;
+            while (mode <= OUTLINE_INVERTED_HULL && items[j] != OUTLINE_MODE_NAMES[mode]) {
+                mode++;
+            }
+            if (mode > OUTLINE_INVERTED_HULL) {
+                return false;
+            }
+            bench->outlineModes.push_back(mode);
+        }
+        return !bench->outlineModes.empty();
+    }
+    return false;
+}
+
+// Returns the smallest of the times that a percentage of them is not
+// greater than
+double percentile(std::vector<double> times, double percent)
+{
+    if (times.empty()) {
+        return 0.0;
+    }
+    int count = times.size();
+    int rank = std::min(std::max(int(std::ceil(percent / 100.0 * count)), 1), count);
+    std::nth_element(times.begin(), times.begin() + rank - 1, times.end());
+    return times[rank - 1];
+}
+
+// Writes the contents of a JSON string, escaped
+std::string jsonString(const std::string &value)
+{
+    std::string escaped;
+    for (size_t i = 0; i < value.size(); i++) {
+        unsigned char c = value[i];
+        if (c == '\\' || c == '"') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (c < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// Reads JSON text at pos, which is moved past what was read. Each
+// returns false if the text there is not what it reads.
+
+void skipJsonSpace(const std::string &text, size_t *pos)
+{
+    while (*pos < text.size() && std::isspace((unsigned char)(text[*pos]))) {
+        (*pos)++;
+    }
+}
+
+bool readJsonString(const std::string &text, size_t *pos, std::string *value)
+{
+    skipJsonSpace(text, pos);
+    if (*pos >= text.size() || text[*pos] != '"') {
+        return false;
+    }
+    value->clear();
+    for ((*pos)++; *pos < text.size(); (*pos)++) {
+        char c = text[*pos];
+        if (c == '"') {
+            (*pos)++;
+            return true;
+        }
+        if (c != '\\') {
+            *value += c;
+            continue;
+        }
+        if (++(*pos) >= text.size()) {
+            return false;
+        }
+        switch (text[*pos]) {
+        case 'b': *value += '\b'; break;
+        case 'f': *value += '\f'; break;
+        case 'n': *value += '\n'; break;
+        case 'r': *value += '\r'; break;
+        case 't': *value += '\t'; break;
+        case 'u': {
+            // Code points of the basic plane only, as UTF-8
+            unsigned code;
+            if (*pos + 4 >= text.size() || std::sscanf(text.c_str() + *pos + 1, "%4x", &code) != 1) {
+                return false;
+            }
+            if (code < 0x80) {
+                *value += char(code);
+            }
+            else if (code < 0x800) {
+                *value += char(0xc0 | (code >> 6));
+                *value += char(0x80 | (code & 0x3f));
+            }
+            else {
+                *value += char(0xe0 | (code >> 12));
+                *value += char(0x80 | ((code >> 6) & 0x3f));
+                *value += char(0x80 | (code & 0x3f));
+            }
+            *pos += 4;
+            break;
+        }
+        default: *value += text[*pos]; break;
+        }
+    }
+    return false;
+}
+
+bool readJsonNumber(const std::string &text, size_t *pos, double *value)
+{
+    skipJsonSpace(text, pos);
+    const char *start = text.c_str() + *pos;
+    char *end;
+    *value = std::strtod(start, &end);
+    *pos += end - start;
+    return end != start;
+}
+
+// Calls member with the key of each member of an object, which has to
+// read the value
+bool readJsonObject(const std::string &text, size_t *pos,
+                    const std::function<bool (const std::string &key)> &member)
+{
+    skipJsonSpace(text, pos);
+    if (*pos >= text.size() || text[*pos] != '{') {
+        return false;
+    }
+    (*pos)++;
+    skipJsonSpace(text, pos);
+    if (*pos < text.size() && text[*pos] == '}') {
+        (*pos)++;
+        return true;
+    }
+    for (;;) {
+        std::string key;
+        if (!readJsonString(text, pos, &key)) {
+            return false;
+        }
+        skipJsonSpace(text, pos);
+        if (*pos >= text.size() || text[(*pos)++] != ':' || !member(key)) {
+            return false;
+        }
+        skipJsonSpace(text, pos);
+        if (*pos >= text.size()) {
+            return false;
+        }
+        char c = text[(*pos)++];
+        if (c == '}') {
+            return true;
+        }
+        if (c != ',') {
+            return false;
+        }
+    }
+}
+
+// Calls element for each element of an array, which has to read it
+bool readJsonArray(const std::string &text, size_t *pos, const std::function<bool ()> &element)
+{
+    skipJsonSpace(text, pos);
+    if (*pos >= text.size() || text[*pos] != '[') {
+        return false;
+    }
+    (*pos)++;
+    skipJsonSpace(text, pos);
+    if (*pos < text.size() && text[*pos] == ']') {
+        (*pos)++;
+        return true;
+    }
+    for (;;) {
+        if (!element()) {
+            return false;
+        }
+        skipJsonSpace(text, pos);
+        if (*pos >= text.size()) {
+            return false;
+        }
+        char c = text[(*pos)++];
+        if (c == ']') {
+            return true;
+        }
+        if (c != ',') {
+            return false;
+        }
+    }
+}
+
+bool skipJsonValue(const std::string &text, size_t *pos)
+{
+    skipJsonSpace(text, pos);
+    if (*pos >= text.size()) {
+        return false;
+    }
+    switch (text[*pos]) {
+    case '"': {
+        std::string value;
+        return readJsonString(text, pos, &value);
+    }
+    case '{':
+        return readJsonObject(text, pos, [&](const std::string &) { return skipJsonValue(text, pos); });
+    case '[':
+        return readJsonArray(text, pos, [&]() { return skipJsonValue(text, pos); });
+    }
+    const char *literals[] = { "true", "false", "null" };
+    for (int i = 0; i < 3; i++) {
+        if (text.compare(*pos, std::strlen(literals[i]), literals[i]) == 0) {
+            *pos += std::strlen(literals[i]);
+            return true;
+        }
+    }
+    double number;
+    return readJsonNumber(text, pos, &number);
+}
+
+// Reads the median frame times of the cases of a report written by
+// the frame benchmark. Fails unless every case has a name and a median
+// and there is at least one.
+bool readBaseline(const std::string &filename, std::map<std::string, double> *frameTimes)
+{
+    std::ifstream file(filename.c_str());
+    if (!file) {
+        std::cerr << "Error: Could not read " << filename << std::endl;
+        return false;
+    }
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    const std::string text = contents.str();
+
+    size_t pos = 0;
+    int numCases = 0;
+    bool complete = true;
+    bool valid = readJsonObject(text, &pos, [&](const std::string &key) {
+        if (key != "cases") {
+            return skipJsonValue(text, &pos);
+        }
+        return readJsonArray(text, &pos, [&]() {
+            std::string name;
+            double median = 0.0;
+            numCases++;
+            bool read = readJsonObject(text, &pos, [&](const std::string &caseKey) {
+                if (caseKey == "name") {
+                    return readJsonString(text, &pos, &name);
+                }
+                if (caseKey == "frame_ms") {
+                    return readJsonObject(text, &pos, [&](const std::string &timeKey) {
+                        return timeKey == "median" ? readJsonNumber(text, &pos, &median)
+                                                   : skipJsonValue(text, &pos);
+                    });
+                }
+                return skipJsonValue(text, &pos);
+            });
+            if (read && (name.empty() || median <= 0.0)) {
+                std::cerr << "Error: Case " << numCases << " of " << filename
+                          << " has no name or median frame time" << std::endl;
+                complete = false;
+            }
+            (*frameTimes)[name] = median;
+            return read;
+        });
+    });
+    skipJsonSpace(text, &pos);
+    if (!valid || pos != text.size()) {
+        std::cerr << "Error: Invalid JSON at byte " << pos << " of " << filename << std::endl;
+        return false;
+    }
+    if (frameTimes->empty()) {
+        std::cerr << "Error: No cases in " << filename << std::endl;
+        return false;
+    }
+    return complete;
+}
+
+// Writes the average pipeline statistics of the passes per frame to a
+// case of the benchmark report, or null without them
+void writePipelineStatistics(std::ostream &report, const GpuProfiler &profiler)
+{
+    if (profiler.getNumStatisticFrames() == 0) {
+        report << ", \"pipeline_statistics\": null";
+        return;
+    }
+    report << ", \"pipeline_statistics\": {\"fragments_per_pixel\": " << fragmentsPerPixel(profiler);
+    for (int p = 0; p < profiler.getNumPasses(); p++) {
+        report << ", \"" << jsonString(profiler.getPassName(p)) << "\": {";
+        for (int i = 0; i < NUM_PIPELINE_STATISTICS; i++) {
+            report << (i > 0 ? ", " : "") << "\"" << jsonString(GpuProfiler::getStatisticName(PipelineStatistic(i)))
+                   << "\": " << std::llround(profiler.getAverageStatistic(p, PipelineStatistic(i)));
+        }
+        report << "}";
+    }
+    report << "}";
+}
+
+// Renders every case of the benchmark without a window and writes the
+// times to a JSON report. Each frame is finished before the next one
+// starts, and nothing waits for vsync, which only applies to windows.
+// Returns false if a case got slower than the baseline by more than
+// the threshold.
+bool runFrameBenchmark(const FrameBenchmark &bench, RenderJob job)
+{
+    std::map<std::string, double> baseline;
+    if (!bench.baseline.empty() && !readBaseline(bench.baseline, &baseline)) {
+        std::exit(EXIT_FAILURE);
+    }
+    // With the report on the standard output, the messages of the
+    // loaders and the table go to the standard error
+    std::ofstream file;
+    std::streambuf *stdoutBuffer = std::cout.rdbuf();
+    if (bench.output == "-") {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+    else {
+        file.open(bench.output.c_str());
+        if (!file) {
+            std::cerr << "Error: Could not open " << bench.output << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    std::ostream report(bench.output == "-" ? stdoutBuffer : file.rdbuf());
+
+    job.model = bench.models[0];
+    job.width = bench.sizes[0].x;
+    job.height = bench.sizes[0].y;
+    OffscreenContext context;
+    if (!initHeadless(&context, job)) {
+        std::exit(EXIT_FAILURE);
+    }
+    globals.gpuProfiler.setPipelineStatistics(true);
+    // The GPU profiler keeps the times of the last 240 frames
+    const int numFrames = std::max(std::min(job.numFrames, 240), 1);
+
+    report << std::fixed << std::setprecision(4);
+    report << "{\n  \"renderer\": \"" << jsonString((const char *)glGetString(GL_RENDERER)) << "\",\n"
+           << "  \"frames\": " << numFrames << ",\n"
+           << "  \"warmup_frames\": " << BENCHMARK_WARMUP_FRAMES << ",\n"
+           << "  \"cases\": [";
+    bool first = true;
+    bool regressed = false;
+    int numUnmatched = 0;
+    std::vector<double> cpuTimes;
+    std::vector<double> frameTimes;
+    for (size_t m = 0; m < bench.models.size(); m++) {
+        if (bench.models[m] != globals.model) {
+            deleteMeshVAO(&globals.meshVAO);
+            loadModel(bench.models[m]);
+        }
+        for (size_t s = 0; s < bench.sizes.size(); s++) {
+            context.resize(bench.sizes[s].x, bench.sizes[s].y);
+            globals.width = bench.sizes[s].x;
+            globals.height = bench.sizes[s].y;
+            globals.jumpFlood.resize(globals.width, globals.height);
+            for (size_t o = 0; o < bench.outlineModes.size(); o++) {
+                globals.outlineMode = OutlineMode(bench.outlineModes[o]);
+                std::ostringstream name;
+                name << modelName(globals.model)
+                     << "/" << globals.width << "x" << globals.height << "/" << OUTLINE_MODE_NAMES[globals.outlineMode];
+
+                // The camera turns once around the model over the
+                // measured frames
+                cpuTimes.clear();
+                frameTimes.clear();
+                long drawCalls = 0;
+                long long vertices = 0;
+                for (int i = -BENCHMARK_WARMUP_FRAMES; i < numFrames; i++) {
+                    globals.turntable_angle = 360.0f * std::max(i, 0) / numFrames;
+                    resetDrawStats();
+                    auto start = std::chrono::steady_clock::now();
+                    globals.gpuProfiler.beginFrame();
+                    display();
+                    globals.gpuProfiler.endFrame();
+                    auto submitted = std::chrono::steady_clock::now();
+                    glFinish();
+                    auto finished = std::chrono::steady_clock::now();
+                    if (i == -1) {
+                        // Only the measured frames count
+                        globals.gpuProfiler.finish();
+                        globals.gpuProfiler.reset();
+                    }
+                    if (i >= 0) {
+                        cpuTimes.push_back(std::chrono::duration<double, std::milli>(submitted - start).count());
+                        frameTimes.push_back(std::chrono::duration<double, std::milli>(finished - start).count());
+                        drawCalls += drawStats.drawCalls;
+                        vertices += drawStats.vertices;
+                    }
+                }
+                globals.gpuProfiler.finish();
+                double resident;
+                double peak;
+                residentMemory(&resident, &peak);
+
+                double frameMedian = percentile(frameTimes, 50.0);
+                report << (first ? "\n" : ",\n") << "    {\"name\": \"" << jsonString(name.str()) << "\""
+                       << ", \"frame_ms\": {\"median\": " << frameMedian
+                       << ", \"p95\": " << percentile(frameTimes, 95.0) << "}"
+                       << ", \"cpu_ms\": {\"median\": " << percentile(cpuTimes, 50.0)
+                       << ", \"p95\": " << percentile(cpuTimes, 95.0) << "}";
+                if (globals.gpuProfiler.isEnabled() && globals.gpuProfiler.getNumFrames() > 0) {
+                    report << ", \"gpu_ms\": {\"mean\": " << globals.gpuProfiler.getAverage(0)
+                           << ", \"p95\": " << globals.gpuProfiler.getPercentile(0, 95.0) << ", \"passes\": {";
+                    for (int p = 1; p < globals.gpuProfiler.getNumPasses(); p++) {
+                        report << (p > 1 ? ", " : "") << "\"" << jsonString(globals.gpuProfiler.getPassName(p))
+                               << "\": " << globals.gpuProfiler.getAverage(p);
+                    }
+                    report << "}}";
+                }
+                else {
+                    report << ", \"gpu_ms\": null";
+                }
+                writePipelineStatistics(report, globals.gpuProfiler);
+                report << ", \"draw_calls\": " << drawCalls / numFrames
+                       << ", \"vertices\": " << vertices / numFrames
+                       << ", \"rss_mb\": " << resident << ", \"peak_rss_mb\": " << peak
+                       << ", \"gpu_mb\": " << cgtk::MemoryRegistry::getTotalBytes(true) / (1024.0 * 1024.0) << "}";
+                first = false;
+                globals.gpuProfiler.reset();
+
+                std::cout << std::left << std::setw(36) << name.str() << std::right
+                          << std::setw(10) << frameMedian << " ms";
+                std::map<std::string, double>::const_iterator base = baseline.find(name.str());
+                if (base != baseline.end()) {
+                    double change = 100.0 * (frameMedian - base->second) / base->second;
+                    std::cout << "  (" << std::showpos << change << std::noshowpos << "% from "
+                              << base->second << " ms)";
+                    if (change > bench.threshold) {
+                        std::cout << "  REGRESSION";
+                        regressed = true;
+                    }
+                }
+                else if (!bench.baseline.empty()) {
+                    std::cout << "  (no baseline)";
+                    numUnmatched++;
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    report << "\n  ]\n}\n";
+    report.flush();
+    std::cout.rdbuf(stdoutBuffer);
+    if (file.is_open()) {
+        file.close();
+    }
+    globals.turntable_angle = 0.0f;
+
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        std::cerr << "Error: OpenGL error 0x" << std::hex << error << std::dec << std::endl;
+    }
+    writeMemoryReport(true);
+    context.destroy();
+    if (report.fail() || file.fail()) {
+        std::cerr << "Error: Could not write " << bench.output << std::endl;
+        return false;
+    }
+    if (regressed) {
+        std::cerr << "Frame times regressed by more than " << bench.threshold << "% from "
+                  << bench.baseline << std::endl;
+    }
+    if (numUnmatched > 0) {
+        // A renamed case would otherwise pass without being compared
+        std::cerr << "Error: " << numUnmatched << " cases are not in " << bench.baseline << std::endl;
+    }
+    return !regressed && numUnmatched == 0;
+}
+
+// Number of frames in flight between rendering and PNG encoding
+const int NUM_CAPTURE_BUFFERS = 3;
+
+// Renders a full turn of the model around the vertical axis and writes
+// the frames as numbered PNG files, e.g., output0000.png, and/or as an
+// animated GIF and/or as a video stream
+bool renderTurntable(const RenderJob &job, FrameCapture *capture, PngEncoder *encoder)
+{
+    const int width = globals.width;
+    const int height = globals.height;
+    int digits = std::max(4, int(std::to_string(job.numFrames - 1).size()));
+    GifWriter gifWriter;
+    if (!job.gif.empty() && !gifWriter.open(job.gif, width, height, job.gifSettings)) {
+        return false;
+    }
+    VideoStream videoStream;
+    if (!job.video.empty() &&
+        !videoStream.open(job.video, job.videoFormat, width, height, job.fps)) {
+        std::cerr << "Error: Could not open " << job.video << std::endl;
+        return false;
+    }
+    // Raw RGB streams are written straight from the pixel pack buffers,
+    // so they are read back without alpha
+    const int bytesPerPixel = job.video.empty() ? 4 : videoStream.getBytesPerPixel();
+    capture->setFormat(bytesPerPixel == 3 ? GL_RGB : GL_RGBA);
+
+    double copyTime = 0.0;
+    bool videoFailed = false;
+    capture->setConsumer([&](const unsigned char *pixels, int w, int h, int frame) {
+        if (!job.video.empty() && !videoStream.writeFrame(pixels)) {
+            videoFailed = true;
+        }
+        if (job.output.empty() && job.gif.empty()) {
+            return;
+        }
+
+        auto copyStart = std::chrono::steady_clock::now();
+        // OpenGL stores the bottom row first, and the alpha channel is
+        // not written to the file
+        std::vector<unsigned char> image(size_t(w) * h * 3);
+        for (int y = 0; y < h; y++) {
+            const unsigned char *src = pixels + size_t(y) * w * bytesPerPixel;
+            unsigned char *dst = &image[size_t(h - 1 - y) * w * 3];
+            for (int x = 0; x < w; x++) {
+                dst[3 * x + 0] = src[bytesPerPixel * x + 0];
+                dst[3 * x + 1] = src[bytesPerPixel * x + 1];
+                dst[3 * x + 2] = src[bytesPerPixel * x + 2];
+            }
+        }
+        copyTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - copyStart).count();
+        if (!job.output.empty()) {
+            std::string number = std::to_string(frame);
+            std::string filename = job.output + std::string(digits - number.size(), '0') + number + ".png";
+            if (job.gif.empty()) {
+                encoder->submit(filename, image, w, h);
+            }
+            else {
+                std::vector<unsigned char> copy(image);
+                encoder->submit(filename, copy, w, h);
+            }
+        }
+        if (!job.gif.empty()) {
+            gifWriter.addFrame(image);
+        }
+    });
+    capture->resetStatistics();
+    encoder->resetStatistics();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < job.numFrames; frame++) {
+        CGTK_TRACE_SCOPE("turntable frame");
+        globals.turntable_angle = 360.0f * frame / job.numFrames;
+        auto frameStart = std::chrono::steady_clock::now();
+        resetDrawStats();
+        cgtk::GLAudit::beginFrame();
+        display();
+        capture->capture(width, height);
+        cgtk::GLAudit::endFrame(&std::cout);
+        publishMetrics(std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count());
+    }
+    capture->flush();
+    encoder->finish();
+    bool gifWritten = gifWriter.close();
+    bool videoWritten = videoStream.close();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    globals.turntable_angle = 0.0f;
+    capture->setFormat(GL_RGBA);
+    if (encoder->getNumErrors() > 0) {
+        return false;
+    }
+    if (!gifWritten) {
+        std::cerr << "Error: Could not write " << job.gif << std::endl;
+        return false;
+    }
+    if (!job.video.empty() && (videoFailed || !videoWritten)) {
+        std::cerr << "Error: Could not write " << job.video << std::endl;
+        return false;
+    }
+
+    const std::string &name = !job.output.empty() ? job.output : !job.gif.empty() ? job.gif : job.video;
+    std::cout << name << ": " << job.numFrames << " frames of "
+              << MODEL_FILENAMES[job.model] << " at " << width << "x" << height
+              << " in " << time.count() << " s (" << job.numFrames / time.count() << " fps)" << std::endl
+              << "  readback: " << capture->getBytesPerSecond() / (1024.0 * 1024.0) << " MB/s, "
+              << capture->getLatencyFrames() << " frames latency, "
+              << capture->getNumStalls() << " stalls, "
+              << copyTime / job.numFrames << " ms copy per frame" << std::endl;
+    if (!job.output.empty()) {
+        std::cout << "  PNG: " << encoder->getEncodeTime() / job.numFrames << " ms per frame, "
+                  << encoder->getNumPaletteFrames() << " indexed frames, "
+                  << encoder->getNumBytes() / job.numFrames / 1024.0 << " KB per frame, "
+                  << encoder->getNumQueueWaits() << " waits for a full queue" << std::endl;
+    }
+    if (!job.gif.empty()) {
+        std::cout << "  GIF: " << gifWriter.getEncodeTime() / job.numFrames << " ms per frame, "
+                  << gifWriter.getEncodedFraction() * 100.0 << "% of the pixels encoded, "
+                  << gifWriter.getNumQuantizedFrames() << " quantized frames, "
+                  << gifWriter.getNumBytes() / 1024.0 << " KB, "
+                  << gifWriter.getNumQueueWaits() << " waits for a full queue" << std::endl;
+    }
+    if (!job.video.empty()) {
+        std::cout << "  video: " << videoStream.getNumFrames() << " frames, "
+                  << videoStream.getConvertTime() / job.numFrames << " ms YUV conversion per frame, "
+                  << videoStream.getNumBytes() / (1024.0 * 1024.0) << " MB, "
+                  << videoStream.getNumStalls() << " stalls waiting "
+                  << videoStream.getStallTime() << " ms for the reader" << std::endl;
+    }
+    return true;
+}
+
+// Renders one image of any size in tiles and streams it to a PNG file.
+// Each tile is rendered with a margin, so that screen space outlines
+// match across tile borders. Only one row of tiles is held in memory.
+bool renderPoster(const RenderJob &job, OffscreenContext *context, const PngSettings &pngSettings)
+{
+    const int imageWidth = job.width;
+    const int imageHeight = job.height;
+    const int margin = posterMargin(job);
+    GLint maxViewport[2];
+    GLint maxRenderbuffer;
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxViewport);
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRenderbuffer);
+    int maxTile = std::min<int>(std::min(maxViewport[0], maxViewport[1]), maxRenderbuffer) - 2 * margin;
+    int tileWidth = std::min(globals.width - 2 * margin, maxTile);
+    int tileHeight = std::min(globals.height - 2 * margin, maxTile);
+    if (tileWidth < 1 || tileHeight < 1) {
+        std::cerr << "Error: The outline is too wide for poster tiles" << std::endl;
+        return false;
+    }
+    if (globals.width != tileWidth + 2 * margin || globals.height != tileHeight + 2 * margin) {
+        globals.width = tileWidth + 2 * margin;
+        globals.height = tileHeight + 2 * margin;
+        context->resize(globals.width, globals.height);
+        globals.jumpFlood.resize(globals.width, globals.height);
+    }
+
+    PngStreamWriter writer;
+    if (!writer.open(job.poster, imageWidth, imageHeight, pngSettings.level, pngSettings.filter)) {
+        std::cerr << "Error: Could not write " << job.poster << std::endl;
+        return false;
+    }
+    std::vector<unsigned char> band(size_t(tileHeight) * imageWidth * 3);
+    size_t rowBytes = size_t(imageWidth) * 3;
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, imageWidth);
+    globals.image_size = glm::ivec2(imageWidth, imageHeight);
+
+    // PNG stores the top row first, so the rows of tiles are rendered
+    // from the top of the image down
+    auto start = std::chrono::steady_clock::now();
+    int numTiles = 0;
+    for (int top = imageHeight; top > 0; top -= tileHeight) {
+        int bottom = std::max(0, top - tileHeight);
+        int rows = top - bottom;
+        for (int left = 0; left < imageWidth; left += tileWidth) {
+            CGTK_TRACE_SCOPE("poster tile");
+            globals.tile = glm::ivec4(left - margin, bottom - margin, globals.width, globals.height);
+            cgtk::GLAudit::beginFrame();
+            display();
+            glReadPixels(margin, margin, std::min(tileWidth, imageWidth - left), rows,
+                         GL_RGB, GL_UNSIGNED_BYTE, &band[size_t(left) * 3]);
+            cgtk::GLAudit::endFrame(&std::cout);
+            numTiles++;
+        }
+        for (int y = 0; y < rows / 2; y++) {
+            std::swap_ranges(band.begin() + y * rowBytes, band.begin() + (y + 1) * rowBytes,
+                             band.begin() + (rows - 1 - y) * rowBytes);
+        }
+        writer.writeRows(&band[0], rows);
+    }
+    bool written = writer.close();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    globals.tile = glm::ivec4(0);
+    globals.image_size = glm::ivec2(0);
+    if (!written) {
+        std::cerr << "Error: Could not write " << job.poster << std::endl;
+        return false;
+    }
+
+    std::cout << job.poster << ": " << MODEL_FILENAMES[job.model] << " at " << imageWidth << "x" << imageHeight
+              << " in " << numTiles << " tiles of " << tileWidth << "x" << tileHeight
+              << " in " << time.count() << " s" << std::endl
+              << "  PNG: " << writer.getEncodeTime() << " ms encoding, "
+              << writer.getNumBytes() / (1024.0 * 1024.0) << " MB, "
+              << band.size() / (1024.0 * 1024.0) << " MB per row of tiles" << std::endl;
+    return true;
+}
+
+// Runs the turntable and poster jobs one after the other in a single
+// offscreen context
+void runJobs(const std::vector<RenderJob> &jobs, const PngSettings &pngSettings)
+{
+    auto start = std::chrono::steady_clock::now();
+    OffscreenContext context;
+    if (!initHeadless(&context, jobs[0])) {
+        std::exit(EXIT_FAILURE);
+    }
+    FrameCapture capture;
+    capture.init(NUM_CAPTURE_BUFFERS);
+    PngEncoder encoder;
+    encoder.start(pngSettings);
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        int model = globals.model;
+        applyJob(jobs[i]);
+        if (globals.model != model) {
+            deleteMeshVAO(&globals.meshVAO);
+            loadModel(globals.model);
+        }
+        context.resize(globals.width, globals.height);
+        globals.jumpFlood.resize(globals.width, globals.height);
+
+        bool success = jobs[i].poster.empty() ? renderTurntable(jobs[i], &capture, &encoder) :
+                       renderPoster(jobs[i], &context, pngSettings);
+        if (!success) {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    encoder.stop();
+    std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+    std::cout << jobs.size() << " jobs in " << time.count() << " s" << std::endl;
+    writeMemoryReport(true);
+    context.destroy();
+}
+
+void printUsage(const char *program)
+{
+    std::cerr << "Usage: " << program << " [--bench-silhouettes] [--jobs FILE] [--headless] [--single-thread]" << std::endl
+              << "       [--no-late-latch] [--latency-log FILE] [--record FILE]" << std::endl
+              << "       [--replay FILE [--replay-step MS] [--replay-checksum]]" << std::endl
+              << "       [--gpu-profile FILE] [--trace FILE] [--perf-counters] [--no-vsync]" << std::endl
+              << "       [--pipeline-statistics] [--overdraw] [--gl-audit] [--memory-report FILE]" << std::endl
+              << "       [--metrics ADDRESS] [--benchmark FILE [BENCHMARK OPTIONS]] [OPTIONS]" << std::endl
+              << std::endl
+              << "  --headless               render without a window and print the frame rate" << std::endl
+              << "  --single-thread          handle input and draw on the same thread" << std::endl
+              << "  --no-late-latch          use the trackball rotation of the input" << std::endl
+              << "                           snapshot instead of the newest cursor position" << std::endl
+              << "  --no-vsync               do not wait for the vertical blank to swap" << std::endl
+              << "  --latency-log FILE       write the time of each input event and the" << std::endl
+              << "                           swap that first showed it to FILE (CSV)" << std::endl
+              << "  --record FILE            record the input and the tweakbar changes" << std::endl
+              << "  --replay FILE            replay recorded input with vsync off, also" << std::endl
+              << "                           with --headless, and print the frame times" << std::endl
+              << "  --replay-step MS         replayed input per frame (default 16.667)" << std::endl
+              << "  --replay-checksum        print a checksum of the frames (--headless)" << std::endl
+              << "  --gpu-profile FILE       write the GPU time of each pass and frame to" << std::endl
+              << "                           FILE (CSV)" << std::endl
+              << "  --pipeline-statistics    count the shader invocations and clipped" << std::endl
+              << "                           primitives of each pass and print them" << std::endl
+              << "  --overdraw               show the fragments per pixel as a heat map" << std::endl
+              << "  --gl-audit               count the GL calls of each frame, flag those" << std::endl
+              << "                           that stall or change nothing and print the" << std::endl
+              << "                           calls per frame at exit" << std::endl
+              << "  --memory-report FILE     write the CPU and GPU memory of every asset" << std::endl
+              << "                           and its high-water mark to FILE (JSON)" << std::endl
+              << "  --metrics ADDRESS        serve live frame, GPU, draw, silhouette, load" << std::endl
+              << "                           and memory metrics at /metrics (Prometheus" << std::endl
+              << "                           text), ADDRESS is a port on 127.0.0.1 or" << std::endl
+              << "                           unix:PATH for a Unix domain socket" << std::endl
+              << "  --trace FILE             write a trace of the CPU work of each thread" << std::endl
+              << "                           to FILE (Chrome trace JSON), give it first" << std::endl
+              << "                           to trace --bench-silhouettes" << std::endl
+              << "  --perf-counters          count cycles, instructions, cache and branch" << std::endl
+              << "                           misses and page faults of the OBJ parsing," << std::endl
+              << "                           normals, mesh upload and frames (Linux)" << std::endl
+              << "  --benchmark FILE         render every case of the frame benchmark" << std::endl
+              << "                           without a window and write the frame, CPU" << std::endl
+              << "                           and GPU times, draw calls and memory to FILE" << std::endl
+              << "                           (JSON) or - for the standard output" << std::endl
+              << "  --turntable PREFIX       render a turn of the model to PREFIX0000.png, ..." << std::endl
+              << "  --gif FILE               render a turn of the model to an animated GIF" << std::endl
+              << "  --video FILE             stream a turn of the model to FILE, a named" << std::endl
+              << "                           pipe or - for the standard output" << std::endl
+              << "  --poster FILE            render one image of any size in tiles to FILE" << std::endl
+              << "  --jobs FILE              render the jobs listed in FILE, one line" << std::endl
+              << "                           of OPTIONS per job" << std::endl
+              << std::endl
+              << "Options:" << std::endl
+              << "  --model NAME             bunny, armadillo, gargo, teapot or icosphere" << std::endl
+              << "  --frames N               number of frames (default 100)" << std::endl
+              << "  --size WIDTHxHEIGHT      resolution (default 800x600)" << std::endl
+              << "  --diffuse R,G,B          diffuse color" << std::endl
+              << "  --ambient R,G,B          ambient color" << std::endl
+              << "  --outline-color R,G,B    outline color" << std::endl
+              << "  --kd VALUE               diffuse intensity" << std::endl
+              << "  --levels N               number of color levels (2-6)" << std::endl
+              << "  --outline MODE           fragment, jump-flood, silhouette-edges," << std::endl
+              << "                           geometry-shader or inverted-hull" << std::endl
+              << "  --outline-width PIXELS   outline width" << std::endl
+              << "  --tile N                 poster tile size (default 1024)" << std::endl
+              << "  --gif-delay N            GIF frame delay in 1/100 s (default 4)" << std::endl
+              << "  --gif-palette PALETTE    local (one per frame) or global (from the" << std::endl
+              << "                           first frame)" << std::endl
+              << "  --video-format FORMAT    y4m (YUV 4:2:0) or rgb (raw frames)" << std::endl
+              << "  --fps N                  frame rate in the Y4M header (default 25)" << std::endl
+              << std::endl
+              << "Benchmark options (--frames gives the measured frames per case):" << std::endl
+              << "  --benchmark-models LIST  models, comma-separated (default all)" << std::endl
+              << "  --benchmark-sizes LIST   resolutions (default 640x480,1280x720)" << std::endl
+              << "  --benchmark-outlines LIST" << std::endl
+              << "                           outline modes (default all)" << std::endl
+              << "  --benchmark-baseline FILE" << std::endl
+              << "                           compare the median frame times to a report" << std::endl
+              << "                           and fail if any case got slower or is" << std::endl
+              << "                           not in it" << std::endl
+              << "  --benchmark-threshold PERCENT" << std::endl
+              << "                           allowed slowdown (default 10)" << std::endl
+              << std::endl
+              << "PNG options:" << std::endl
+              << "  --png-level N            zlib compression level (0-9, default 6)" << std::endl
+              << "  --png-filter FILTER      none, sub, up, average, paeth or adaptive" << std::endl
+              << "                           (default adaptive)" << std::endl
+              << "  --png-threads N          encoder threads (default one per core)" << std::endl
+              << "  --no-palette             never write indexed images" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    bool headless = false;
+    bool singleThread = false;
+    std::string latencyLog;
+    std::string recordFile;
+    std::string replayFile;
+    bool replayChecksum = false;
+    std::string gpuProfile;
+    std::string metricsAddress;
+    Replay replay;
+    std::string jobsFile;
+    PngSettings pngSettings;
+    RenderJob job;
+    FrameBenchmark bench;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--trace" && i + 1 < args.size()) {
+            startTrace(args[++i]);
+        }
+        else if (args[i] == "--perf-counters") {
+            startPerfCounters();
+        }
+        else if (args[i] == "--bench-silhouettes") {
+            benchmarkSilhouettes();
+            std::exit(EXIT_SUCCESS);
+        }
+        else if (args[i] == "--headless") {
+            headless = true;
+        }
+        else if (args[i] == "--single-thread") {
+            singleThread = true;
+        }
+        else if (args[i] == "--no-late-latch") {
+            globals.late_latch = false;
+        }
+        else if (args[i] == "--no-vsync") {
+            globals.vsync = false;
+        }
+        else if (args[i] == "--pipeline-statistics") {
+            globals.pipeline_statistics = true;
+        }
+        else if (args[i] == "--overdraw") {
+            globals.overdraw = true;
+        }
+        else if (args[i] == "--gl-audit") {
+            globals.gl_audit = true;
+        }
+        else if (args[i] == "--memory-report" && i + 1 < args.size()) {
+            globals.memory_report = args[++i];
+        }
+        else if (args[i] == "--metrics" && i + 1 < args.size()) {
+            metricsAddress = args[++i];
+        }
+        else if (args[i] == "--benchmark" && i + 1 < args.size()) {
+            bench.output = args[++i];
+        }
+        else if (args[i].compare(0, 12, "--benchmark-") == 0) {
+            if (!parseBenchmarkOption(args, &i, &bench)) {
+                printUsage(argv[0]);
+                std::exit(EXIT_FAILURE);
+            }
+        }
+        else if (args[i] == "--latency-log" && i + 1 < args.size()) {
+            latencyLog = args[++i];
+        }
+        else if (args[i] == "--record" && i + 1 < args.size()) {
+            recordFile = args[++i];
+        }
+        else if (args[i] == "--replay" && i + 1 < args.size()) {
+            replayFile = args[++i];
+        }
+        else if (args[i] == "--replay-step" && i + 1 < args.size()) {
+            replay.step = std::max(0.001, std::atof(args[++i].c_str())) / 1000.0;
+        }
+        else if (args[i] == "--replay-checksum") {
+            replayChecksum = true;
+        }
+        else if (args[i] == "--gpu-profile" && i + 1 < args.size()) {
+            gpuProfile = args[++i];
+        }
+        else if (args[i] == "--jobs" && i + 1 < args.size()) {
+            jobsFile = args[++i];
+        }
+        else if (args[i] == "--png-level" && i + 1 < args.size()) {
+            pngSettings.level = std::min(9, std::max(0, std::atoi(args[++i].c_str())));
+        }
+        else if (args[i] == "--png-filter" && i + 1 < args.size() &&
+                 PngEncoder::parseFilter(args[i + 1], &pngSettings.filter)) {
+            i++;
+        }
+        else if (args[i] == "--png-threads" && i + 1 < args.size()) {
+            pngSettings.numThreads = std::atoi(args[++i].c_str());
+        }
+        else if (args[i] == "--no-palette") {
+            pngSettings.palette = false;
+        }
+        else if (!parseJobOption(args, &i, &job)) {
+            printUsage(argv[0]);
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    if (!metricsAddress.empty() && !globals.metricsServer.start(metricsAddress, formatMetrics)) {
+        std::exit(EXIT_FAILURE);
+    }
+    if (!bench.output.empty()) {
+        std::exit(runFrameBenchmark(bench, job) ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+
+    std::vector<RenderJob> jobs;
+    if (!jobsFile.empty() && !readJobsFile(jobsFile, &jobs)) {
+        std::exit(EXIT_FAILURE);
+    }
+    if (hasJobOutput(job)) {
+        jobs.push_back(job);
+    }
+    // The reports go to the standard error when a video is streamed to
+    // the standard output
+    for (size_t i = 0; i < jobs.size(); i++) {
+        if (jobs[i].video == "-") {
+            std::cout.rdbuf(std::cerr.rdbuf());
+        }
+    }
+    if (!jobs.empty()) {
+        runJobs(jobs, pngSettings);
+        std::exit(EXIT_SUCCESS);
+    }
+    if (!replayFile.empty() && !loadReplay(replayFile, &replay)) {
+        std::exit(EXIT_FAILURE);
+    }
+    if (!gpuProfile.empty() && !globals.gpuProfiler.openCsv(gpuProfile)) {
+        std::cerr << "Error: Could not open " << gpuProfile << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+    if (headless && !replayFile.empty()) {
+        runHeadlessReplay(job, &replay, replayChecksum);
+        std::exit(EXIT_SUCCESS);
+    }
+    if (headless) {
+        runHeadless(job);
+        std::exit(EXIT_SUCCESS);
+    }
+    applyJob(job);
+
+    // Create window and load extensions
+    glfwSetErrorCallback(errorCallback);
+    if (!glfwInit()) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    // The overdraw heat map counts fragments in the stencil buffer
+    glfwWindowHint(GLFW_STENCIL_BITS, 8);
+
+    GLFWwindow* window = glfwCreateWindow(globals.width, globals.height,
+        "Toon shading", NULL, NULL);
+    if (!window) {
+        glfwTerminate();
+        std::exit(EXIT_FAILURE);
+    }
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(globals.vsync ? 1 : 0);
+
+    if (!loadExtensions()) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    // The input is ignored while replaying
+    initializeTrackball();
+    if (replayFile.empty()) {
+        glfwSetKeyCallback(window, keyCallback);
+        glfwSetMouseButtonCallback(window, mouseButtonCallback);
+        glfwSetCursorPosCallback(window, cursorPosCallback);
+        glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+        glfwSetScrollCallback(window, scrollCallback);
+    }
+    glfwSetWindowRefreshCallback(window, windowRefreshCallback);
+
+    TwInit(TW_OPENGL_CORE, NULL);
     TwWindowSize(globals.width, globals.height);
 
     TwBar *myBar;
@@ -447,31 +3793,169 @@ int main(void)
     TwAddVarCB(myBar, "Y pos", TW_TYPE_FLOAT, setLightYpos, getLightYpos , &globals.lightdir_y, " step=0.5 group=Light label='y-pos' ");
     TwAddVarCB(myBar, "Z pos", TW_TYPE_FLOAT, setLightZpos, getLightZpos , &globals.lightdir_z, " step=0.01 group=Light label='z-pos' ");
 
-    TwAddVarRW(myBar, "Ambient color", TW_TYPE_COLOR3F, &globals.ambientColor, "group=Material colormode=hls");
+    TwAddVarRW(myBar, "Ambient color", TW_TYPE_COLOR3F, &input.params.ambientColor, "group=Material colormode=hls");
 
-    TwAddVarRW(myBar, "Diffuse color", TW_TYPE_COLOR3F, &globals.diffuseColor, "group=Material colormode=hls");
+    TwAddVarRW(myBar, "Diffuse color", TW_TYPE_COLOR3F, &input.params.diffuseColor, "group=Material colormode=hls");
     TwAddVarCB(myBar, "Diffuse intensity", TW_TYPE_FLOAT,setDifflvl, getDifflvl, &globals.material_kd, "group=Material step=0.01");
 
-    TwAddVarRW(myBar, "Outline color", TW_TYPE_COLOR3F, &globals.outlineColor, "group=Material colormode=hls");
+    TwAddVarRW(myBar, "Outline color", TW_TYPE_COLOR3F, &input.params.outlineColor, "group=Material colormode=hls");
     TwAddVarCB(myBar, "Outline intensity", TW_TYPE_FLOAT, setOutlinelvl, getOutlinelvl , &globals.outline_intensity, " step=0.01 min=0.0 max=1.0 group=Material");
 
     TwAddVarCB(myBar, "Background color", TW_TYPE_COLOR3F, setBgcolorCallBack, getBgcolorCallBack, &globals.bg_color[0], "group=Misc colormode=hls");
-
-    TwAddVarCB(myBar, "Color levels", TW_TYPE_INT8, setColorlvl, getColorlvl , &globals.colorlvl, " step=1 min=2 max=6 group=Material");
+    TwType modelType = TwDefineEnumFromString("Model", "Bunny,Armadillo,Gargoyle,Teapot,Icosphere");
+    TwAddVarCB(myBar, "Model", modelType, setModel, getModel, &globals.model, "group=Misc");
+    TwAddVarCB(myBar, "VSync", TW_TYPE_BOOLCPP, setVsync, getVsync, &globals.vsync, "group=Misc");
+    TwAddVarRO(myBar, "Frame time (ms)", TW_TYPE_DOUBLE, &globals.frame_time, "group=Misc precision=2");
+    TwAddVarRO(myBar, "Input latency p50 (ms)", TW_TYPE_DOUBLE, &globals.latency_p50, "group=Misc precision=2");
+    TwAddVarRO(myBar, "Input latency p99 (ms)", TW_TYPE_DOUBLE, &globals.latency_p99, "group=Misc precision=2");
+    TwAddVarRW(myBar, "Late latching", TW_TYPE_BOOLCPP, &input.params.late_latch, "group=Misc");
+    TwAddVarRW(myBar, "Continuous redraw", TW_TYPE_BOOLCPP, &input.params.continuous_redraw, "group=Misc");
+    TwAddVarRO(myBar, "Frames skipped", TW_TYPE_INT32, &input.frames_skipped, "group=Misc");
+
+    TwAddVarCB(myBar, "Color levels", TW_TYPE_INT32, setColorlvl, getColorlvl , &globals.colorlvl, " step=1 min=2 max=6 group=Material");
+
+    TwAddVarRW(myBar, "Toon ramp", TW_TYPE_INT32, &input.params.ramp, " min=0 max=3 group=Material");
+    TwAddVarRW(myBar, "Instances", TW_TYPE_INT32, &input.params.instances, " min=1 max=9 group=Material");
+
+    TwType outlineModeType = TwDefineEnumFromString("OutlineMode", "Fragment,Jump flood,Silhouette edges,Geometry shader,Inverted hull");
+    TwAddVarRW(myBar, "Outline mode", outlineModeType, &input.params.outlineMode, "group=Outline");
+    TwAddVarRW(myBar, "Outline width", TW_TYPE_FLOAT, &input.params.outline_width, " step=0.5 min=1.0 max=64.0 group=Outline");
+
+    TwAddVarCB(myBar, "Crease angle", TW_TYPE_FLOAT, setCreaseAngle, getCreaseAngle, &globals.crease_angle, " step=1.0 min=0.0 max=180.0 group=Silhouette");
+    TwAddVarRW(myBar, "Brute force", TW_TYPE_BOOLCPP, &input.params.silhouette_brute_force, "group=Silhouette");
+    TwAddVarRO(myBar, "Extraction (ms)", TW_TYPE_DOUBLE, &globals.silhouette_time, "group=Silhouette precision=3");
+    TwAddVarRO(myBar, "Tested edges", TW_TYPE_INT32, &globals.silhouette_tested, "group=Silhouette");
+    TwAddVarRO(myBar, "Drawn edges", TW_TYPE_INT32, &globals.silhouette_drawn, "group=Silhouette");
+
+    // The passes are added to the Perf bar as they are first drawn
+    input.perfBar = TwNewBar("Perf");
+    TwDefine(" Perf label='GPU time per pass' position='16 400' size='220 240' valueswidth=80 ");
+    TwAddVarRO(input.perfBar, "Dropped frames", TW_TYPE_INT32, &input.perf.dropped, "");
+    TwAddVarRW(input.perfBar, "Overdraw heat map", TW_TYPE_BOOLCPP, &input.params.overdraw,
+               "help='Fragments per pixel: black 0, blue 1-2, cyan 3, green 4, yellow 5, orange 6, red 7, white 8 or more'");
 
 
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     glEnable(GL_BLEND);
     // Initialize rendering
     init();
+    if (!globals.gpuProfiler.isEnabled()) {
+        TwAddButton(input.perfBar, "Unsupported", NULL, NULL, "label='No timer queries (OpenGL 3.3)'");
+    }
+    else if (globals.gpuProfiler.isPipelineStatisticsSupported()) {
+        TwAddVarRW(input.perfBar, "Pipeline statistics", TW_TYPE_BOOLCPP, &input.params.pipeline_statistics, "");
+        TwAddVarRO(input.perfBar, "Fragments per pixel", TW_TYPE_DOUBLE, &input.perf.fragmentsPerPixel, "precision=2");
+    }
+    if (cgtk::GLAudit::isInstalled()) {
+        TwAddVarRO(input.perfBar, "GL calls", TW_TYPE_INT32, &input.perf.glCalls[0], "group='GL audit' label='calls'");
+        TwAddVarRO(input.perfBar, "GL sync calls", TW_TYPE_INT32, &input.perf.glCalls[1], "group='GL audit' label='sync'");
+        TwAddVarRO(input.perfBar, "GL redundant calls", TW_TYPE_INT32, &input.perf.glCalls[2], "group='GL audit' label='redundant'");
+    }
 
-    // Start rendering loop
-    while (!glfwWindowShouldClose(window)) {
-        display();
-        TwDraw();
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    // The assets are added to the Memory bar as they are first seen
+    input.memoryBar = TwNewBar("Memory");
+    TwDefine(" Memory label='Memory' position='560 16' size='220 240' valueswidth=80 iconified=true ");
+    TwAddVarRO(input.memoryBar, "CPU", TW_TYPE_DOUBLE, &input.memoryTotals[0], "precision=2 label='CPU (MB)'");
+    TwAddVarRO(input.memoryBar, "CPU peak", TW_TYPE_DOUBLE, &input.memoryTotals[1], "precision=2 label='CPU peak (MB)'");
+    TwAddVarRO(input.memoryBar, "GPU", TW_TYPE_DOUBLE, &input.memoryTotals[2], "precision=2 label='GPU (MB)'");
+    TwAddVarRO(input.memoryBar, "GPU peak", TW_TYPE_DOUBLE, &input.memoryTotals[3], "precision=2 label='GPU peak (MB)'");
+    if (GLEW_NVX_gpu_memory_info) {
+        TwAddVarRO(input.memoryBar, "Driver total", TW_TYPE_DOUBLE, &input.driverMemory[0], "precision=0 label='Video memory (MB)'");
+    }
+    if (GLEW_NVX_gpu_memory_info || GLEW_ATI_meminfo) {
+        TwAddVarRO(input.memoryBar, "Driver available", TW_TYPE_DOUBLE, &input.driverMemory[1], "precision=0 label='Free (MB)'");
+    }
+    else {
+        TwAddButton(input.memoryBar, "Computed", NULL, NULL, "label='Computed sizes (no driver info)'");
+    }
+
+    // Latencies are measured from the first frame on
+    globals.single_thread = singleThread;
+    globals.latency_epoch = std::chrono::steady_clock::now();
+    if (!latencyLog.empty()) {
+        globals.latency_log.open(latencyLog.c_str());
+        if (!globals.latency_log) {
+            std::cerr << "Could not open " << latencyLog << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+        globals.latency_log << "event_ms,present_ms,latency_ms,cursor,latched\n";
+    }
+
+    // The input thread starts from the initial parameters, which begin
+    // the recording
+    input.params = currentViewParams();
+    {
+        std::lock_guard<std::mutex> lock(input.mutex);
+        if (!recordFile.empty()) {
+            if (!input.recorder.open(recordFile)) {
+                std::cerr << "Error: Could not open " << recordFile << std::endl;
+                std::exit(EXIT_FAILURE);
+            }
+            recordEvent(INPUT_RECORD_FRAMEBUFFER_SIZE, false, globals.width, globals.height, 0, 0, 0.0f, 0.0f);
+            recordParameters(true);
+        }
+        publishViewParams();
+    }
+
+    // Start rendering loop. The render thread only draws when the input
+    // thread (this one) has published new parameters, and this one
+    // sleeps until the next event. With --single-thread both take
+    // turns on this thread instead.
+    if (!replayFile.empty()) {
+        runReplay(window, &replay);
+    }
+    else if (singleThread) {
+        while (!glfwWindowShouldClose(window)) {
+            if (drawFrame(window)) {
+                glfwPollEvents();
+            }
+            else {
+                {
+                    std::lock_guard<std::mutex> lock(input.mutex);
+                    input.frames_skipped++;
+                }
+                glfwWaitEvents();
+            }
+            std::lock_guard<std::mutex> lock(input.mutex);
+            if (input.dirty) {
+                publishViewParams();
+            }
+        }
+    }
+    else {
+        glfwMakeContextCurrent(NULL);
+        std::thread renderThread(renderLoop, window);
+        while (!glfwWindowShouldClose(window)) {
+            glfwWaitEvents();
+            InputLock lock(input.inputWaits);
+            if (input.dirty) {
+                publishViewParams();
+            }
+            else {
+                input.frames_skipped++;
+            }
+        }
+        input.quit = true;
+        {
+            std::lock_guard<std::mutex> lock(input.wakeMutex);
+        }
+        input.wake.notify_one();
+        renderThread.join();
+        glfwMakeContextCurrent(window);
+    }
+    reportLatency();
+    reportGpuProfile();
+    if (input.recorder.isOpen()) {
+        int numRecords = input.recorder.getNumRecords();
+        if (!input.recorder.close()) {
+            std::cerr << "Error: Could not write " << recordFile << std::endl;
+        }
+        else {
+            std::cout << "Recorded " << numRecords << " events to " << recordFile << std::endl;
+        }
     }
+    // The render thread has sampled the driver
+    writeMemoryReport(false);
     glfwDestroyWindow(window);
     glfwTerminate();
 
@@ -0,0 +1,10 @@
+// Fragment shader
+#version 150
+
+out vec4 FragColor;
+
+uniform vec3 outlineColor;
+
+void main(){
+    FragColor = vec4(outlineColor, 1);
+}
@@ -0,0 +1,33 @@
+//Vertex shader
+#version 150
+#extension GL_ARB_explicit_attrib_location : require
+
+//Expands an edge into a screen-aligned quad of constant pixel width.
+//a_corner.x selects the endpoint (0 = start, 1 = end) and
+//a_corner.y the side of the edge (-1 or 1).
+
+layout(location = 0) in vec3 a_start;
+layout(location = 1) in vec3 a_end;
+layout(location = 2) in vec2 a_corner;
+
+uniform mat4 mvp;
+uniform vec2 viewport;
+uniform float line_width;
+
+void main() {
+    vec4 start = mvp * vec4(a_start, 1.0);
+    vec4 end = mvp * vec4(a_end, 1.0);
+
+    //edge direction in pixels
+    vec2 dir = (end.xy / end.w - start.xy / start.w) * viewport;
+    dir = (length(dir) > 1e-6) ? normalize(dir) : vec2(1.0, 0.0);
+    vec2 normal = vec2(-dir.y, dir.x);
+
+    //extend the ends by half the width so that adjacent edges join
+    vec2 offset = (normal * a_corner.y + dir * (2.0 * a_corner.x - 1.0)) * 0.5 * line_width;
+
+    gl_Position = mix(start, end, a_corner.x);
+    gl_Position.xy += offset / viewport * 2.0 * gl_Position.w;
+    //pull the line slightly towards the eye so it wins against the mesh
+    gl_Position.z -= 0.0005 * gl_Position.w;
+}
@@ -0,0 +1,10 @@
+//Vertex shader
+#version 150
+
+//Fullscreen triangle generated from gl_VertexID,
+//draw with glDrawArrays(GL_TRIANGLES, 0, 3) and an empty VAO
+
+void main() {
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,26 @@
+//Vertex shader
+#version 150
+#extension GL_ARB_explicit_attrib_location : require
+
+//Inverted hull outline: the mesh is extruded along its normals and
+//drawn with front faces culled, so only the shell's back faces show
+//around the model. Scaling the offset by the clip-space w of the
+//vertex keeps the outline width constant in screen space.
+
+layout(location = 0) in vec4 a_position;
+layout(location = 1) in vec3 a_normal;
+
+uniform mat4 mvp;
+//object space offset per unit of clip-space w, for the outline width
+uniform float hull_offset;
+//instances as in mesh.vert, placed alternately right and left of
+//instance 0
+uniform mat4 view_projection;
+uniform float instance_spacing;
+
+void main() {
+    int k = (gl_InstanceID + 1) / 2;
+    vec3 offset = vec3(((gl_InstanceID % 2 == 1) ? k : -k) * instance_spacing, 0.0, 0.0);
+    vec4 position = mvp * a_position + view_projection * vec4(offset, 0.0);
+    gl_Position = position + mvp * vec4(a_normal * hull_offset * position.w, 0.0);
+}
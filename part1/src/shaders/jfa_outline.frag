@@ -0,0 +1,26 @@
+// Fragment shader
+#version 150
+
+//Jump flood outline pass
+//Shades the band of pixels whose distance to the nearest
+//silhouette pixel lies within outline_width
+
+out vec4 FragColor;
+
+uniform sampler2D seeds;
+uniform vec3 outlineColor;
+uniform float outline_width;
+
+void main(){
+    vec2 seed = texelFetch(seeds, ivec2(gl_FragCoord.xy), 0).xy;
+    if (seed.x < 0.0)
+        discard;
+
+    float dist = distance(seed, gl_FragCoord.xy);
+    if (dist == 0.0 || dist > outline_width + 0.5)
+        discard;
+
+    //one pixel wide falloff to antialias the outer edge
+    float alpha = clamp(outline_width + 0.5 - dist, 0.0, 1.0);
+    FragColor = vec4(outlineColor, alpha);
+}
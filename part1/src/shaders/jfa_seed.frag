@@ -0,0 +1,11 @@
+// Fragment shader
+#version 150
+
+//Jump flood seed pass
+//Every covered pixel is its own nearest seed
+
+out vec2 FragSeed;
+
+void main(){
+    FragSeed = gl_FragCoord.xy;
+}
@@ -0,0 +1,19 @@
+//Vertex shader
+#version 150
+#extension GL_ARB_explicit_attrib_location : require
+
+//Jump flood seed pass: rasterizes the silhouette mask
+
+layout(location = 0) in vec4 a_position;
+
+uniform mat4 mvp;
+//instances as in mesh.vert, placed alternately right and left of
+//instance 0
+uniform mat4 view_projection;
+uniform float instance_spacing;
+
+void main() {
+    int k = (gl_InstanceID + 1) / 2;
+    vec3 offset = vec3(((gl_InstanceID % 2 == 1) ? k : -k) * instance_spacing, 0.0, 0.0);
+    gl_Position = mvp * a_position + view_projection * vec4(offset, 0.0);
+}
@@ -0,0 +1,41 @@
+// Fragment shader
+#version 150
+
+//Jump flood propagation pass
+//Looks at the 3x3 neighbours at distance step_size and keeps
+//the seed closest to this pixel. Seeds are stored as pixel
+//centers, (-1, -1) marks "no seed found yet".
+
+out vec2 FragSeed;
+
+uniform sampler2D seeds;
+uniform int step_size;
+
+void main(){
+    ivec2 size = textureSize(seeds, 0);
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+    vec2 bestSeed = vec2(-1.0);
+    float bestDist = 1e20;
+
+    for (int y = -1; y <= 1; y++) {
+        for (int x = -1; x <= 1; x++) {
+            ivec2 p = pixel + ivec2(x, y) * step_size;
+            if (any(lessThan(p, ivec2(0))) || any(greaterThanEqual(p, size)))
+                continue;
+
+            vec2 seed = texelFetch(seeds, p, 0).xy;
+            if (seed.x < 0.0)
+                continue;
+
+            vec2 d = seed - gl_FragCoord.xy;
+            float dist = dot(d, d);
+            if (dist < bestDist) {
+                bestDist = dist;
+                bestSeed = seed;
+            }
+        }
+    }
+
+    FragSeed = bestSeed;
+}
@@ -8,20 +8,16 @@ out vec4 FragColor;
 uniform vec3 lightDir;
 uniform vec3 eye_position;
 
-uniform float material_kd;
 uniform float outline_intensity;
+uniform bool edge_detection; //false when another pass draws the outline
 
 in vec3 world_pos;
 in vec3 world_normal;
+flat in int ramp_index;
 
-//number of colorlvls
-//for diffuse color
-// perhaps 3 colors
-
-uniform int colorlvl;
-float scaleFactor = 1.0 / colorlvl;
-uniform vec3 diffuseColor;
-uniform vec3 ambientColor;
+//banded ambient + diffuse colors, one layer per toon style,
+//indexed by the diffuse term
+uniform sampler1DArray toonRamps;
 uniform vec3 outlineColor;
 
 vec3 color;
@@ -33,12 +29,12 @@ void main(){
   vec3 H = normalize(L + V );
 
 	float diffuse = max(0, dot(L,world_normal));
-	vec3 diffuseColor = diffuseColor * material_kd * floor(diffuse * colorlvl) * scaleFactor;
+	vec3 toonColor = texture(toonRamps, vec2(diffuse, ramp_index)).rgb;
 
-  float edgeDetection = (dot(V, world_normal) >  outline_intensity) ? 1 : 0;
+  float edgeDetection = (!edge_detection || dot(V, world_normal) >  outline_intensity) ? 1 : 0;
 
 	if(edgeDetection == 1)
-		color = ambientColor + diffuseColor;
+		color = toonColor;
 	else
 		color = outlineColor;
 
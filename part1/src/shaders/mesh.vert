@@ -6,14 +6,27 @@ layout(location = 0) in vec4 a_position;
 layout(location = 1) in vec3 a_normal;
 
 uniform mat4 mvp, view, model;
+uniform mat4 view_projection;
+
+//toon ramp of the object, instances cycle through the following ones
+uniform int ramp;
+uniform int num_ramps;
+//distance between instances, placed alternately right and left of
+//instance 0
+uniform float instance_spacing;
 
 out vec3 world_pos;
 out vec3 world_normal;
+flat out int ramp_index;
 
 void main() {
 
-  world_pos = mat3(model) * a_position.xyz;//careful here
+  int k = (gl_InstanceID + 1) / 2;
+  vec3 offset = vec3(((gl_InstanceID % 2 == 1) ? k : -k) * instance_spacing, 0.0, 0.0);
+
+  world_pos = mat3(model) * a_position.xyz + offset;//careful here
   world_normal = normalize(mat3(model) * a_normal);
+  ramp_index = (ramp + gl_InstanceID) % num_ramps;
 
-    gl_Position = mvp * a_position;
+    gl_Position = mvp * a_position + view_projection * vec4(offset, 0.0);
 }